@@ -33,7 +33,8 @@ while [ $i -le $# ]; do
 		;;
 	"-os=unix")
 		os=1
-		CFLAGS="$CFLAGS -DKRIPTO_UNIX"
+		CFLAGS="$CFLAGS -DKRIPTO_UNIX -pthread"
+		LDFLAGS="$LDFLAGS -pthread"
 		;;
 	"-os=windows")
 		os=2
@@ -62,7 +63,8 @@ done
 
 # if OS not defined assume UNIX
 if [ -z $os ]; then
-	CFLAGS="$CFLAGS -DKRIPTO_UNIX"
+	CFLAGS="$CFLAGS -DKRIPTO_UNIX -pthread"
+	LDFLAGS="$LDFLAGS -pthread"
 fi
 
 if [ -z $debug ]; then
@@ -101,5 +103,5 @@ fi
 
 # run tests
 cd ../
-find test/ -name "*.c" -exec $CC {} lib/libkripto.a $CFLAGS -o t \; -exec ./t \; -exec rm t \;
-#find test/ -name "*.c" -exec $CC {} lib/libkripto.a $CFLAGS -DVERBOSE -o t \; -exec valgrind -q ./t \; -exec rm t \;
+find test/ -name "*.c" -exec $CC {} lib/libkripto.a $CFLAGS -lm -o t \; -exec ./t \; -exec rm t \;
+#find test/ -name "*.c" -exec $CC {} lib/libkripto.a $CFLAGS -lm -DVERBOSE -o t \; -exec valgrind -q ./t \; -exec rm t \;
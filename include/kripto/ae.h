@@ -67,6 +67,30 @@ extern int kripto_ae_verify
 
 extern void kripto_ae_destroy(kripto_ae *s);
 
+extern size_t kripto_ae_ctx_size
+(
+	const kripto_desc_ae *desc,
+	unsigned int rounds,
+	unsigned int key_len,
+	unsigned int iv_len,
+	unsigned int tag_len
+);
+
+extern kripto_ae *kripto_ae_init
+(
+	const kripto_desc_ae *desc,
+	void *mem,
+	size_t len,
+	unsigned int rounds,
+	const void *key,
+	unsigned int key_len,
+	const void *iv,
+	unsigned int iv_len,
+	unsigned int tag_len
+);
+
+extern void kripto_ae_fini(kripto_ae *s);
+
 extern unsigned int kripto_ae_multof(const kripto_ae *s);
 
 extern const kripto_desc_ae *kripto_ae_getdesc(const kripto_ae *s);
@@ -0,0 +1,67 @@
+#ifndef KRIPTO_ARGON2_H
+#define KRIPTO_ARGON2_H
+
+typedef struct kripto_argon2_ctx kripto_argon2_ctx;
+
+#define KRIPTO_ARGON2D	0
+#define KRIPTO_ARGON2I	1
+#define KRIPTO_ARGON2ID	2
+
+#define KRIPTO_ARGON2_HUGEPAGES	1 /* huge pages, reserved or transparent */
+#define KRIPTO_ARGON2_LOCK	2 /* mlock memory, fail if not allowed */
+
+/* RFC 9106, version 0x13, m in KiB, one thread per cpu */
+extern int kripto_argon2
+(
+	unsigned int type,
+	uint32_t t,
+	uint32_t m,
+	uint32_t p,
+	const void *pass,
+	uint32_t pass_len,
+	const void *salt,
+	uint32_t salt_len,
+	const void *secret,
+	uint32_t secret_len,
+	const void *ad,
+	uint32_t ad_len,
+	void *out,
+	uint32_t out_len
+);
+
+/*
+ * Memory for repeated derivations with fixed m and p, mapped and
+ * faulted in once. Lanes run on up to threads threads, 0 for one
+ * per cpu. Blocks stay resident between runs and are wiped on destroy.
+ */
+extern kripto_argon2_ctx *kripto_argon2_ctx_create
+(
+	uint32_t m,
+	uint32_t p,
+	unsigned int threads,
+	unsigned int flags
+);
+
+extern int kripto_argon2_ctx_run
+(
+	kripto_argon2_ctx *s,
+	unsigned int type,
+	uint32_t t,
+	const void *pass,
+	uint32_t pass_len,
+	const void *salt,
+	uint32_t salt_len,
+	const void *secret,
+	uint32_t secret_len,
+	const void *ad,
+	uint32_t ad_len,
+	void *out,
+	uint32_t out_len
+);
+
+/* bytes mapped, including huge page rounding */
+extern size_t kripto_argon2_ctx_memory(const kripto_argon2_ctx *s);
+
+extern void kripto_argon2_ctx_destroy(kripto_argon2_ctx *s);
+
+#endif
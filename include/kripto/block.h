@@ -1,6 +1,8 @@
 #ifndef KRIPTO_BLOCK_H
 #define KRIPTO_BLOCK_H
 
+#include <stddef.h>
+
 typedef struct kripto_desc_block kripto_desc_block;
 typedef struct kripto_block kripto_block;
 
@@ -41,8 +43,56 @@ extern void kripto_block_decrypt
 	void *pt
 );
 
+extern void kripto_block_encrypt_blocks
+(
+	const kripto_block *s,
+	const void *pt,
+	void *ct,
+	size_t blocks
+);
+
+extern void kripto_block_decrypt_blocks
+(
+	const kripto_block *s,
+	const void *ct,
+	void *pt,
+	size_t blocks
+);
+
+extern void kripto_block_encrypt_multi
+(
+	const kripto_block *const *s,
+	const void *const *pt,
+	void *const *ct,
+	unsigned int n
+);
+
 extern void kripto_block_destroy(kripto_block *s);
 
+/*
+ * Contexts in caller memory. ctx_size is for these parameters and the
+ * current cpu features, init fails if len is too small. fini wipes
+ * the context and leaves the memory to the caller.
+ */
+extern size_t kripto_block_ctx_size
+(
+	const kripto_desc_block *desc,
+	unsigned int rounds,
+	unsigned int key_len
+);
+
+extern kripto_block *kripto_block_init
+(
+	const kripto_desc_block *desc,
+	void *mem,
+	size_t len,
+	unsigned int rounds,
+	const void *key,
+	unsigned int key_len
+);
+
+extern void kripto_block_fini(kripto_block *s);
+
 extern const kripto_desc_block *kripto_block_getdesc(const kripto_block *s);
 
 extern unsigned int kripto_block_size(const kripto_desc_block *desc);
@@ -0,0 +1,21 @@
+#ifndef KRIPTO_CPU_H
+#define KRIPTO_CPU_H
+
+#define KRIPTO_CPU_SSE2		0x001
+#define KRIPTO_CPU_SSSE3	0x002
+#define KRIPTO_CPU_SSE41	0x004
+#define KRIPTO_CPU_AVX2		0x008
+#define KRIPTO_CPU_AVX512	0x010
+#define KRIPTO_CPU_AESNI	0x020
+#define KRIPTO_CPU_PCLMUL	0x040
+#define KRIPTO_CPU_SHANI	0x080
+#define KRIPTO_CPU_GFNI		0x100
+#define KRIPTO_CPU_VAES		0x200
+
+extern unsigned int kripto_cpu_detect(void);
+
+extern unsigned int kripto_cpu(void);
+
+extern void kripto_cpu_set(unsigned int features);
+
+#endif
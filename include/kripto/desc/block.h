@@ -1,6 +1,8 @@
 #ifndef KRIPTO_BLOCK_DESC_H
 #define KRIPTO_BLOCK_DESC_H
 
+#include <stddef.h>
+
 struct kripto_desc_block
 {
 	kripto_block *(*create)
@@ -30,6 +32,30 @@ struct kripto_desc_block
 
 	void (*decrypt)(const kripto_block *, const void *, void *);
 
+	void (*encrypt_blocks)
+	(
+		const kripto_block *,
+		const void *,
+		void *,
+		size_t
+	);
+
+	void (*decrypt_blocks)
+	(
+		const kripto_block *,
+		const void *,
+		void *,
+		size_t
+	);
+
+	void (*encrypt_multi)
+	(
+		const kripto_block *const *,
+		const void *const *,
+		void *const *,
+		unsigned int
+	);
+
 	void (*destroy)(kripto_block *);
 
 	unsigned int blocksize;
@@ -25,6 +25,8 @@ struct kripto_desc_hash
 
 	void (*output)(kripto_hash *, void *, size_t);
 
+	void (*copy)(const kripto_hash *, kripto_hash *);
+
 	void (*destroy)(kripto_hash *);
 
 	int (*hash_all)
@@ -39,6 +41,29 @@ struct kripto_desc_hash
 		size_t
 	);
 
+	int (*hash_multi)
+	(
+		const kripto_desc_hash *,
+		unsigned int,
+		const void *,
+		unsigned int,
+		const void *const *,
+		const size_t *,
+		void *const *,
+		size_t,
+		unsigned int
+	);
+
+	int (*hmac_chain)
+	(
+		const kripto_hash *,
+		const kripto_hash *,
+		const void *,
+		void *,
+		unsigned int,
+		unsigned int
+	);
+
 	unsigned int maxout;
 	unsigned int blocksize;
 	unsigned int maxsalt;
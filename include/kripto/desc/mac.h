@@ -25,6 +25,10 @@ struct kripto_desc_mac
 
 	void (*tag)(kripto_mac *, void *, unsigned int);
 
+	void (*reset)(kripto_mac *);
+
+	void (*chain)(kripto_mac *, void *, void *, unsigned int, unsigned int);
+
 	void (*destroy)(kripto_mac *);
 
 	unsigned int maxtag;
@@ -2,6 +2,7 @@
 #define KRIPTO_STREAM_DESC_H
 
 #include <stddef.h>
+#include <stdint.h>
 
 struct kripto_desc_stream
 {
@@ -43,6 +44,8 @@ struct kripto_desc_stream
 
 	void (*prng)(kripto_stream *, void *, size_t);
 
+	void (*seek)(kripto_stream *, uint64_t);
+
 	void (*destroy)(kripto_stream *);
 
 	unsigned int maxkey;
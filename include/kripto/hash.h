@@ -38,8 +38,31 @@ extern void kripto_hash_output
 	size_t len
 );
 
+extern void kripto_hash_copy(const kripto_hash *s, kripto_hash *c);
+
 extern void kripto_hash_destroy(kripto_hash *s);
 
+extern size_t kripto_hash_ctx_size
+(
+	const kripto_desc_hash *desc,
+	unsigned int rounds,
+	unsigned int salt_len,
+	unsigned int out_len
+);
+
+extern kripto_hash *kripto_hash_init
+(
+	const kripto_desc_hash *desc,
+	void *mem,
+	size_t len,
+	unsigned int rounds,
+	const void *salt,
+	unsigned int salt_len,
+	unsigned int out_len
+);
+
+extern void kripto_hash_fini(kripto_hash *s);
+
 extern int kripto_hash_all
 (
 	const kripto_desc_hash *desc,
@@ -52,6 +75,19 @@ extern int kripto_hash_all
 	size_t out_len
 );
 
+extern int kripto_hash_multi
+(
+	const kripto_desc_hash *desc,
+	unsigned int rounds,
+	const void *salt,
+	unsigned int salt_len,
+	const void *const *in,
+	const size_t *in_len,
+	void *const *out,
+	size_t out_len,
+	unsigned int n
+);
+
 extern const kripto_desc_hash *kripto_hash_getdesc(const kripto_hash *s);
 
 extern unsigned int kripto_hash_maxout(const kripto_desc_hash *desc);
@@ -38,6 +38,21 @@ extern void kripto_mac_tag
 	unsigned int len
 );
 
+extern void kripto_mac_reset(kripto_mac *s);
+
+/*
+ * t ^= U_2 .. U_iter where U_1 = u and U_i = MAC(U_i-1), see PBKDF2.
+ * u is overwritten with later U_i.
+ */
+extern void kripto_mac_chain
+(
+	kripto_mac *s,
+	void *u,
+	void *t,
+	unsigned int len,
+	unsigned int iter
+);
+
 extern int kripto_mac_verify
 (
 	kripto_mac *s,
@@ -47,6 +62,27 @@ extern int kripto_mac_verify
 
 extern void kripto_mac_destroy(kripto_mac *s);
 
+extern size_t kripto_mac_ctx_size
+(
+	const kripto_desc_mac *desc,
+	unsigned int rounds,
+	unsigned int key_len,
+	unsigned int tag_len
+);
+
+extern kripto_mac *kripto_mac_init
+(
+	const kripto_desc_mac *desc,
+	void *mem,
+	size_t len,
+	unsigned int rounds,
+	const void *key,
+	unsigned int key_len,
+	unsigned int tag_len
+);
+
+extern void kripto_mac_fini(kripto_mac *s);
+
 extern int kripto_mac_all
 (
 	const kripto_desc_mac *desc,
@@ -65,4 +101,8 @@ extern unsigned int kripto_mac_maxtag(const kripto_desc_mac *desc);
 
 extern unsigned int kripto_mac_maxkey(const kripto_desc_mac *desc);
 
+extern int kripto_mac_resettable(const kripto_desc_mac *desc);
+
+extern int kripto_mac_chainable(const kripto_desc_mac *desc);
+
 #endif
@@ -14,4 +14,19 @@ extern int kripto_pbkdf2
 	size_t out_len
 );
 
+/* threads 0 is one per cpu, at most one per output block */
+extern int kripto_pbkdf2_threads
+(
+	const kripto_desc_mac *mac,
+	unsigned int mac_rounds,
+	unsigned int iter,
+	unsigned int threads,
+	const void *pass,
+	unsigned int pass_len,
+	const void *salt,
+	unsigned int salt_len,
+	void *out,
+	size_t out_len
+);
+
 #endif
@@ -5,6 +5,11 @@
 
 typedef struct kripto_random kripto_random;
 
+/*
+ * On unix, output comes from a ChaCha20 generator of the calling
+ * thread, seeded with getrandom() and reseeded after fork.
+ * KRIPTO_RANDOM environment variable names a file to read instead.
+ */
 extern kripto_random *kripto_random_create(void);
 
 extern size_t kripto_random_gen
@@ -1,6 +1,11 @@
 #ifndef KRIPTO_SCRYPT_H
 #define KRIPTO_SCRYPT_H
 
+typedef struct kripto_scrypt_ctx kripto_scrypt_ctx;
+
+#define KRIPTO_SCRYPT_HUGEPAGES	1 /* huge pages, reserved or transparent */
+#define KRIPTO_SCRYPT_LOCK	2 /* mlock scratch, fail if not allowed */
+
 extern int kripto_scrypt
 (
 	const kripto_desc_mac *mac,
@@ -16,4 +21,62 @@ extern int kripto_scrypt
 	size_t out_len
 );
 
+/* threads 0 is one per cpu, at most p */
+extern int kripto_scrypt_threads
+(
+	const kripto_desc_mac *mac,
+	unsigned int mac_rounds,
+	uint64_t n,
+	uint32_t r,
+	uint32_t p,
+	unsigned int threads,
+	const void *pass,
+	unsigned int pass_len,
+	const void *salt,
+	unsigned int salt_len,
+	void *out,
+	size_t out_len
+);
+
+/* bytes kripto_scrypt_threads() allocates, 0 if they do not fit */
+extern size_t kripto_scrypt_memory
+(
+	uint64_t n,
+	uint32_t r,
+	uint32_t p,
+	unsigned int threads
+);
+
+/*
+ * Scratch for repeated derivations with fixed n, r and p, mapped and
+ * faulted in once. V stays resident between runs and is wiped on
+ * destroy; scratch is excluded from core dumps where supported.
+ */
+extern kripto_scrypt_ctx *kripto_scrypt_ctx_create
+(
+	uint64_t n,
+	uint32_t r,
+	uint32_t p,
+	unsigned int threads,
+	unsigned int flags
+);
+
+extern int kripto_scrypt_ctx_run
+(
+	kripto_scrypt_ctx *s,
+	const kripto_desc_mac *mac,
+	unsigned int mac_rounds,
+	const void *pass,
+	unsigned int pass_len,
+	const void *salt,
+	unsigned int salt_len,
+	void *out,
+	size_t out_len
+);
+
+/* bytes mapped, including huge page rounding */
+extern size_t kripto_scrypt_ctx_memory(const kripto_scrypt_ctx *s);
+
+extern void kripto_scrypt_ctx_destroy(kripto_scrypt_ctx *s);
+
 #endif
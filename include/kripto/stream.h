@@ -2,6 +2,7 @@
 #define KRIPTO_STREAM_H
 
 #include <stddef.h>
+#include <stdint.h>
 
 typedef struct kripto_desc_stream kripto_desc_stream;
 typedef struct kripto_stream kripto_stream;
@@ -49,8 +50,36 @@ extern void kripto_stream_prng
 	size_t len
 );
 
+extern void kripto_stream_seek
+(
+	kripto_stream *s,
+	uint64_t offset
+);
+
 extern void kripto_stream_destroy(kripto_stream *s);
 
+extern size_t kripto_stream_ctx_size
+(
+	const kripto_desc_stream *desc,
+	unsigned int rounds,
+	unsigned int key_len,
+	unsigned int iv_len
+);
+
+extern kripto_stream *kripto_stream_init
+(
+	const kripto_desc_stream *desc,
+	void *mem,
+	size_t len,
+	unsigned int rounds,
+	const void *key,
+	unsigned int key_len,
+	const void *iv,
+	unsigned int iv_len
+);
+
+extern void kripto_stream_fini(kripto_stream *s);
+
 extern unsigned int kripto_stream_multof(const kripto_stream *s);
 
 extern const kripto_desc_stream *kripto_stream_getdesc(const kripto_stream *s);
@@ -59,4 +88,6 @@ extern unsigned int kripto_stream_maxkey(const kripto_desc_stream *desc);
 
 extern unsigned int kripto_stream_maxiv(const kripto_desc_stream *desc);
 
+extern int kripto_stream_seekable(const kripto_desc_stream *desc);
+
 #endif
@@ -3,4 +3,13 @@
 
 extern kripto_desc_stream *kripto_stream_cbc(const kripto_desc_block *block);
 
+extern void kripto_stream_cbc_encrypt_multi
+(
+	kripto_stream *const *s,
+	const void *const *pt,
+	void *const *ct,
+	const size_t *len,
+	unsigned int n
+);
+
 #endif
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2026 by Gregor Pintar <grpintar@gmail.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef KRIPTO_XOR_H
+#define KRIPTO_XOR_H
+
+#include <stdint.h>
+#include <string.h>
+
+#include <kripto/cast.h>
+
+/* dst = a ^ b, dst may be equal to a or b */
+static inline void XOR(const void *a, const void *b, void *dst, size_t len)
+{
+	uint64_t x0;
+	uint64_t x1;
+	uint64_t x2;
+	uint64_t x3;
+	uint64_t y0;
+	uint64_t y1;
+	uint64_t y2;
+	uint64_t y3;
+	size_t i = 0;
+
+	for(; i + 32 <= len; i += 32)
+	{
+		memcpy(&x0, CU8(a) + i, 8);
+		memcpy(&x1, CU8(a) + i + 8, 8);
+		memcpy(&x2, CU8(a) + i + 16, 8);
+		memcpy(&x3, CU8(a) + i + 24, 8);
+		memcpy(&y0, CU8(b) + i, 8);
+		memcpy(&y1, CU8(b) + i + 8, 8);
+		memcpy(&y2, CU8(b) + i + 16, 8);
+		memcpy(&y3, CU8(b) + i + 24, 8);
+
+		x0 ^= y0;
+		x1 ^= y1;
+		x2 ^= y2;
+		x3 ^= y3;
+
+		memcpy(U8(dst) + i, &x0, 8);
+		memcpy(U8(dst) + i + 8, &x1, 8);
+		memcpy(U8(dst) + i + 16, &x2, 8);
+		memcpy(U8(dst) + i + 24, &x3, 8);
+	}
+
+	for(; i + 8 <= len; i += 8)
+	{
+		memcpy(&x0, CU8(a) + i, 8);
+		memcpy(&y0, CU8(b) + i, 8);
+		x0 ^= y0;
+		memcpy(U8(dst) + i, &x0, 8);
+	}
+
+	for(; i < len; i++)
+		U8(dst)[i] = CU8(a)[i] ^ CU8(b)[i];
+}
+
+#endif
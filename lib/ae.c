@@ -14,11 +14,14 @@
  */
 
 #include <assert.h>
+#include <stdlib.h>
 
 #include <kripto/memory.h>
 #include <kripto/ae.h>
 #include <kripto/desc/ae.h>
 
+#include "alloc.h"
+
 struct kripto_ae
 {
 	const kripto_desc_ae *desc;
@@ -155,6 +158,70 @@ void kripto_ae_destroy(kripto_ae *s)
 	s->desc->destroy(s);
 }
 
+/* create with a zero key, counting what it takes */
+size_t kripto_ae_ctx_size
+(
+	const kripto_desc_ae *desc,
+	unsigned int rounds,
+	unsigned int key_len,
+	unsigned int iv_len,
+	unsigned int tag_len
+)
+{
+	struct kripto_alloc_arena a;
+	kripto_ae *s;
+	void *zero;
+	size_t len;
+
+	assert(desc);
+	assert(desc->create);
+
+	zero = calloc(key_len + iv_len + 1, 1);
+	if(!zero) return 0;
+
+	kripto_alloc_begin(&a, 0, 0);
+	s = kripto_ae_create(desc, rounds, zero, key_len, iv_len ? zero : 0, iv_len, tag_len);
+	len = kripto_alloc_end(&a);
+
+	free(zero);
+
+	if(!s) return 0;
+	kripto_ae_destroy(s);
+
+	return len;
+}
+
+kripto_ae *kripto_ae_init
+(
+	const kripto_desc_ae *desc,
+	void *mem,
+	size_t len,
+	unsigned int rounds,
+	const void *key,
+	unsigned int key_len,
+	const void *iv,
+	unsigned int iv_len,
+	unsigned int tag_len
+)
+{
+	struct kripto_alloc_arena a;
+	kripto_ae *s;
+
+	assert(mem);
+
+	kripto_alloc_begin(&a, mem, len);
+	s = kripto_ae_create(desc, rounds, key, key_len, iv, iv_len, tag_len);
+	(void)kripto_alloc_end(&a);
+
+	return s;
+}
+
+/* destroy wipes, kripto_free leaves caller memory alone */
+void kripto_ae_fini(kripto_ae *s)
+{
+	kripto_ae_destroy(s);
+}
+
 unsigned int kripto_ae_multof(const kripto_ae *s)
 {
 	assert(s);
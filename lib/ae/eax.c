@@ -29,6 +29,9 @@
 
 #include <kripto/ae/eax.h>
 
+#include "../alloc.h"
+#include "../desc.h"
+
 struct kripto_ae
 {
 	const kripto_desc_ae *desc;
@@ -39,6 +42,7 @@ struct kripto_ae
 	kripto_mac *omac;
 	kripto_mac *header;
 	uint8_t *iv;
+	uint8_t *buf; /* [t]_n of OMAC */
 	unsigned int len;
 };
 
@@ -102,10 +106,10 @@ static void eax_destroy(kripto_ae *s)
 
 	kripto_memory_wipe(s->iv, s->len);
 
-	free(s->ctr_desc);
-	free(s->omac_desc);
+	kripto_free(s->ctr_desc);
+	kripto_free(s->omac_desc);
 
-	free(s);
+	kripto_free(s);
 }
 
 struct ext
@@ -134,23 +138,22 @@ static kripto_ae *eax_create
 	(void)tag_len;
 
 	len = kripto_block_size(EXT(desc)->block);
-	buf = (uint8_t *)malloc(len);
-	if(!buf) goto err0;
 
-	s = (kripto_ae *)malloc(sizeof(kripto_ae) + len);
-	if(!s) goto err1;
+	s = (kripto_ae *)kripto_alloc(sizeof(kripto_ae) + (len << 1));
+	if(!s) goto err0;
 
 	s->desc = desc;
 	s->multof = 1;
 	s->iv = (uint8_t *)s + sizeof(kripto_ae);
+	s->buf = buf = s->iv + len;
 	s->len = len;
 
 	/* create CTR descriptor */
-	s->ctr_desc = kripto_stream_ctr(EXT(desc)->block);
+	s->ctr_desc = kripto_stream_ctr_alloc(EXT(desc)->block);
 	if(!s->ctr_desc) goto err2;
 
 	/* create OMAC descriptor */
-	s->omac_desc = kripto_mac_omac(EXT(desc)->block);
+	s->omac_desc = kripto_mac_omac_alloc(EXT(desc)->block);
 	if(!s->omac_desc) goto err3;
 
 	/* OMAC IV (nonce) */
@@ -177,17 +180,14 @@ static kripto_ae *eax_create
 	buf[len - 1] = 1;
 	kripto_mac_input(s->header, buf, len);
 
-	free(buf);
-
 	return s;
 
 err7: kripto_stream_destroy(s->ctr);
 err6: kripto_mac_destroy(s->omac);
 err5: kripto_memory_wipe(s->iv, len);
-err4: free(s->omac_desc);
-err3: free(s->ctr_desc);
-err2: free(s);
-err1: free(buf);
+err4: kripto_free(s->omac_desc);
+err3: kripto_free(s->ctr_desc);
+err2: kripto_free(s);
 err0: return 0;
 }
 
@@ -202,13 +202,10 @@ static kripto_ae *eax_recreate
 	unsigned int tag_len
 )
 {
-	uint8_t *buf;
+	uint8_t *buf = s->buf;
 
 	(void)tag_len;
 
-	buf = (uint8_t *)malloc(s->len);
-	if(!buf) goto err0;
-
 	/* OMAC IV (nonce) */
 	s->omac = kripto_mac_recreate(s->omac, rounds, key, key_len, s->len);
 	if(!s->omac) goto err1;
@@ -233,18 +230,15 @@ static kripto_ae *eax_recreate
 	buf[s->len - 1] = 1;
 	kripto_mac_input(s->header, buf, s->len);
 
-	free(buf);
-
 	return s;
 
 err3: kripto_stream_destroy(s->ctr);
 err2: kripto_mac_destroy(s->omac);
-err1: free(buf);
-err0:
-	free(s->ctr_desc);
-	free(s->omac_desc);
+err1:
+	kripto_free(s->ctr_desc);
+	kripto_free(s->omac_desc);
 	kripto_memory_wipe(s->iv, s->len);
-	free(s);
+	kripto_free(s);
 	return 0;
 }
 
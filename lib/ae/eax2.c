@@ -16,6 +16,7 @@
 #include <stdint.h>
 #include <string.h>
 #include <stdlib.h>
+#include <limits.h>
 
 #include <kripto/cast.h>
 #include <kripto/memory.h>
@@ -26,6 +27,8 @@
 
 #include <kripto/ae/eax2.h>
 
+#include "../alloc.h"
+
 struct kripto_ae
 {
 	const kripto_desc_ae *desc;
@@ -34,7 +37,9 @@ struct kripto_ae
 	kripto_mac *mac;
 	kripto_mac *header;
 	uint8_t *iv;
+	uint8_t *buf; /* [t]_n of MAC */
 	unsigned int len;
+	unsigned int iv_size; /* MAC of nonce, at least len */
 };
 
 static void eax2_encrypt
@@ -95,9 +100,9 @@ static void eax2_destroy(kripto_ae *s)
 	kripto_mac_destroy(s->mac);
 	kripto_mac_destroy(s->header);
 
-	kripto_memory_wipe(s->iv, s->len);
+	kripto_memory_wipe(s->iv, s->iv_size);
 
-	free(s);
+	kripto_free(s);
 }
 
 struct ext
@@ -122,18 +127,21 @@ static kripto_ae *eax2_create
 {
 	kripto_ae *s;
 	uint8_t *buf;
+	unsigned int iv_size;
 	unsigned int mac_key; /* K1 */
 	unsigned int stream_key; /* K2 */
 
-	buf = (uint8_t *)malloc(tag_len);
-	if(!buf) goto err0;
+	/* nonce MAC is as long as the nonce, tags are XORed with it */
+	iv_size = iv_len > tag_len ? iv_len : tag_len;
 
-	s = (kripto_ae *)malloc(sizeof(kripto_ae) + tag_len);
-	if(!s) goto err1;
+	s = (kripto_ae *)kripto_alloc(sizeof(kripto_ae) + iv_size + tag_len);
+	if(!s) goto err0;
 
 	s->desc = desc;
 	s->iv = (uint8_t *)s + sizeof(kripto_ae);
+	s->buf = buf = s->iv + iv_size;
 	s->len = tag_len;
+	s->iv_size = iv_size;
 
 	/* split key */
 	stream_key = (key_len + 1) >> 1;
@@ -148,6 +156,7 @@ static kripto_ae *eax2_create
 	kripto_mac_input(s->mac, buf, tag_len);
 	kripto_mac_input(s->mac, iv, iv_len);
 	kripto_mac_tag(s->mac, s->iv, iv_len);
+	memset(s->iv + iv_len, 0, iv_size - iv_len);
 
 	/* recreate MAC for encryption/decryption */
 	s->mac = kripto_mac_recreate(s->mac, rounds, key, mac_key, tag_len);
@@ -172,15 +181,12 @@ static kripto_ae *eax2_create
 	buf[tag_len - 1] = 1;
 	kripto_mac_input(s->header, buf, tag_len);
 
-	free(buf);
-
 	return s;
 
 err5: kripto_stream_destroy(s->stream);
 err4: kripto_mac_destroy(s->mac);
-err3: kripto_memory_wipe(s->iv, tag_len);
-err2: free(s);
-err1: free(buf);
+err3: kripto_memory_wipe(s->iv, iv_size);
+err2: kripto_free(s);
 err0: return 0;
 }
 
@@ -200,20 +206,18 @@ static kripto_ae *eax2_recreate
 	unsigned int stream_key; /* K2 */
 	const kripto_desc_ae *desc;
 
-	if(tag_len > s->len)
+	if(tag_len > s->len || iv_len > s->iv_size)
 	{
 		desc = s->desc;
 		eax2_destroy(s);
 		return eax2_create(desc, rounds, key, key_len, iv, iv_len, tag_len);
 	}
 
-	if(tag_len < s->len)
-		kripto_memory_wipe(s->iv + tag_len, s->len - tag_len);
+	if(iv_len < s->iv_size)
+		kripto_memory_wipe(s->iv + iv_len, s->iv_size - iv_len);
 
 	s->len = tag_len;
-
-	buf = (uint8_t *)malloc(tag_len);
-	if(!buf) goto err0;
+	buf = s->buf;
 
 	/* split key */
 	stream_key = (key_len + 1) >> 1;
@@ -252,16 +256,13 @@ static kripto_ae *eax2_recreate
 	buf[s->len - 1] = 1;
 	kripto_mac_input(s->header, buf, tag_len);
 
-	free(buf);
-
 	return s;
 
 err3: kripto_stream_destroy(s->stream);
 err2: kripto_mac_destroy(s->mac);
-err1: free(buf);
-err0:
-	kripto_memory_wipe(s->iv, tag_len);
-	free(s);
+err1:
+	kripto_memory_wipe(s->iv, s->iv_size);
+	kripto_free(s);
 	return 0;
 }
 
@@ -285,6 +286,7 @@ kripto_desc_ae *kripto_ae_eax2
 	s->desc.tag = &eax2_tag;
 	s->desc.destroy = &eax2_destroy;
 	s->desc.maxkey = kripto_stream_maxkey(stream) + kripto_mac_maxkey(mac);
+	if(s->desc.maxkey < kripto_mac_maxkey(mac)) s->desc.maxkey = UINT_MAX;
 	s->desc.maxiv = kripto_stream_maxiv(stream);
 	s->desc.maxtag = kripto_mac_maxtag(mac);
 
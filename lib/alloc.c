@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2026 by Gregor Pintar <grpintar@gmail.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "alloc.h"
+
+#define HEAP 0
+#define CALLER 1
+
+/* header keeps the block aligned */
+#define HEADER KRIPTO_ALLOC_ALIGN
+#define ROUND(X) (((X) + KRIPTO_ALLOC_ALIGN - 1) & ~(size_t)(KRIPTO_ALLOC_ALIGN - 1))
+
+#if defined(__GNUC__) || defined(__clang__)
+static __thread struct kripto_alloc_arena *arena = 0;
+#else
+static struct kripto_alloc_arena *arena = 0; /* not thread safe */
+#endif
+
+void *kripto_alloc(size_t len)
+{
+	struct kripto_alloc_arena *a = arena;
+	const size_t size = ROUND(len) + HEADER;
+	uint8_t *h;
+
+	if(a && a->mem)
+	{
+		if(a->len - a->used < size) return 0;
+
+		h = a->mem + a->used;
+		a->used += size;
+		*(size_t *)(void *)h = CALLER;
+
+		return h + HEADER;
+	}
+
+	h = (uint8_t *)malloc(len + HEADER);
+	if(!h) return 0;
+
+	if(a) a->used += size;
+	*(size_t *)(void *)h = HEAP;
+
+	return h + HEADER;
+}
+
+void kripto_free(void *p)
+{
+	uint8_t *h;
+
+	if(!p) return;
+
+	h = (uint8_t *)p - HEADER;
+	if(*(size_t *)(void *)h == HEAP) free(h);
+}
+
+void kripto_alloc_begin
+(
+	struct kripto_alloc_arena *a,
+	void *mem,
+	size_t len
+)
+{
+	size_t pad = 0;
+
+	if(mem)
+	{
+		pad = (KRIPTO_ALLOC_ALIGN - (uintptr_t)mem % KRIPTO_ALLOC_ALIGN)
+			% KRIPTO_ALLOC_ALIGN;
+		if(pad > len) pad = len;
+	}
+
+	a->mem = mem ? (uint8_t *)mem + pad : 0;
+	a->len = len - pad;
+	a->used = 0;
+	a->prev = arena;
+
+	arena = a;
+}
+
+size_t kripto_alloc_end(struct kripto_alloc_arena *a)
+{
+	arena = a->prev;
+
+	/* any alignment of mem */
+	return a->used + KRIPTO_ALLOC_ALIGN - 1;
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2026 by Gregor Pintar <grpintar@gmail.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef LIB_ALLOC_H
+#define LIB_ALLOC_H
+
+/*
+ * Context memory. Between kripto_alloc_begin() and kripto_alloc_end()
+ * allocations of the calling thread come from the given memory, or are
+ * only counted if it is 0. Every block carries a header that tells
+ * kripto_free() where it came from, so destroy works on both.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define KRIPTO_ALLOC_ALIGN 16
+
+struct kripto_alloc_arena
+{
+	uint8_t *mem;
+	size_t len;
+	size_t used;
+	struct kripto_alloc_arena *prev;
+};
+
+extern void *kripto_alloc(size_t len);
+
+extern void kripto_free(void *p);
+
+extern void kripto_alloc_begin
+(
+	struct kripto_alloc_arena *a,
+	void *mem,
+	size_t len
+);
+
+/* bytes taken, or that would be taken, including alignment of mem */
+extern size_t kripto_alloc_end(struct kripto_alloc_arena *a);
+
+#endif
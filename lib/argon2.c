@@ -0,0 +1,773 @@
+/*
+ * Copyright (C) 2026 by Gregor Pintar <grpintar@gmail.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#if defined(KRIPTO_UNIX) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE /* MAP_ANONYMOUS, madvise */
+#endif
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#if (defined(__GNUC__) || defined(__clang__)) \
+&& (defined(__i386__) || defined(__x86_64__))
+#define SIMD
+#include <immintrin.h>
+#endif
+
+#include <kripto/memory.h>
+#include <kripto/cast.h>
+#include <kripto/loadstore.h>
+#include <kripto/rotate.h>
+#include <kripto/cpu.h>
+#include <kripto/hash.h>
+#include <kripto/hash/blake2b.h>
+
+#include <kripto/argon2.h>
+
+#include "thread.h"
+#include "scratch.h"
+
+#define WORDS 128 /* 1 KiB block */
+#define SLICES 4
+
+struct kripto_argon2_ctx
+{
+	uint64_t *mem;
+	size_t len;
+	size_t map;
+	uint32_t m;
+	uint32_t blocks;
+	uint32_t q;
+	uint32_t p;
+	unsigned int threads;
+};
+
+/* BlaMka, G of BLAKE2b with a multiplication added to every sum */
+#define GB(A, B, C, D)						\
+{								\
+	A += B + ((uint64_t)(uint32_t)A * (uint32_t)B << 1);	\
+	D = ROR64_32(D ^ A);					\
+	C += D + ((uint64_t)(uint32_t)C * (uint32_t)D << 1);	\
+	B = ROR64_24(B ^ C);					\
+	A += B + ((uint64_t)(uint32_t)A * (uint32_t)B << 1);	\
+	D = ROR64_16(D ^ A);					\
+	C += D + ((uint64_t)(uint32_t)C * (uint32_t)D << 1);	\
+	B = ROR64_63(B ^ C);					\
+}
+
+/* permutation P on 16 words, V(0) .. V(15) */
+#define P(V)							\
+{								\
+	GB(V(0), V(4), V(8), V(12));				\
+	GB(V(1), V(5), V(9), V(13));				\
+	GB(V(2), V(6), V(10), V(14));				\
+	GB(V(3), V(7), V(11), V(15));				\
+	GB(V(0), V(5), V(10), V(15));				\
+	GB(V(1), V(6), V(11), V(12));				\
+	GB(V(2), V(7), V(8), V(13));				\
+	GB(V(3), V(4), V(9), V(14));				\
+}
+
+/* word k of row i, and of column i (pairs of words) */
+#define ROW(K) q[(i << 4) + (K)]
+#define COL(K) q[(i << 1) + (((K) >> 1) << 4) + ((K) & 1)]
+
+/* out = G(x, y), or out ^= G(x, y) */
+static void blamka
+(
+	const uint64_t *x,
+	const uint64_t *y,
+	uint64_t *out,
+	int add
+)
+{
+	uint64_t r[WORDS];
+	uint64_t q[WORDS];
+	unsigned int i;
+
+	for(i = 0; i < WORDS; i++)
+		q[i] = r[i] = x[i] ^ y[i];
+
+	for(i = 0; i < 8; i++) P(ROW);
+	for(i = 0; i < 8; i++) P(COL);
+
+	if(add)
+	{
+		for(i = 0; i < WORDS; i++) out[i] ^= q[i] ^ r[i];
+	}
+	else
+	{
+		for(i = 0; i < WORDS; i++) out[i] = q[i] ^ r[i];
+	}
+}
+
+#undef GB
+#undef P
+#undef ROW
+#undef COL
+
+#ifdef SIMD
+
+/*
+ * The 16 words of P as a, b, c, d of four words, rows of the 4x4
+ * matrix, in two 128-bit or one 256-bit register each. Diagonals are
+ * lined up by rotating b, c and d. Columns of the block are pairs of
+ * words, so they load as 128-bit halves.
+ */
+
+#define LOAD128(P) _mm_loadu_si128((const __m128i *)(P))
+#define STORE128(P, X) _mm_storeu_si128((__m128i *)(P), X)
+
+/* 2 * lo32(a) * lo32(b) + a + b */
+#define ADD_SSE2(A, B)						\
+	_mm_add_epi64(_mm_add_epi64(A, B),			\
+	_mm_add_epi64(_mm_mul_epu32(A, B), _mm_mul_epu32(A, B)))
+
+#define ROR_SSE2(X, N) ROR_SSE2_##N(X)
+#define ROR_SSE2_32(X) _mm_shuffle_epi32(X, 0xB1)
+#define ROR_SSE2_24(X) \
+	_mm_xor_si128(_mm_srli_epi64(X, 24), _mm_slli_epi64(X, 40))
+#define ROR_SSE2_16(X) \
+	_mm_xor_si128(_mm_srli_epi64(X, 16), _mm_slli_epi64(X, 48))
+#define ROR_SSE2_63(X) \
+	_mm_xor_si128(_mm_srli_epi64(X, 63), _mm_add_epi64(X, X))
+
+#define GB_SSE2(A, B, C, D)					\
+{								\
+	A = ADD_SSE2(A, B);					\
+	D = ROR_SSE2(_mm_xor_si128(D, A), 32);			\
+	C = ADD_SSE2(C, D);					\
+	B = ROR_SSE2(_mm_xor_si128(B, C), 24);			\
+	A = ADD_SSE2(A, B);					\
+	D = ROR_SSE2(_mm_xor_si128(D, A), 16);			\
+	C = ADD_SSE2(C, D);					\
+	B = ROR_SSE2(_mm_xor_si128(B, C), 63);			\
+}
+
+#define P_SSE2							\
+{								\
+	GB_SSE2(a0, b0, c0, d0);				\
+	GB_SSE2(a1, b1, c1, d1);				\
+								\
+	t0 = b0;						\
+	b0 = _mm_unpackhi_epi64(b0, _mm_unpacklo_epi64(b1, b1));	\
+	b1 = _mm_unpackhi_epi64(b1, _mm_unpacklo_epi64(t0, t0));	\
+	t0 = c0; c0 = c1; c1 = t0;				\
+	t0 = d0;						\
+	d0 = _mm_unpackhi_epi64(d1, _mm_unpacklo_epi64(d0, d0));	\
+	d1 = _mm_unpackhi_epi64(t0, _mm_unpacklo_epi64(d1, d1));	\
+								\
+	GB_SSE2(a0, b0, c0, d0);				\
+	GB_SSE2(a1, b1, c1, d1);				\
+								\
+	t0 = b0;						\
+	b0 = _mm_unpackhi_epi64(b1, _mm_unpacklo_epi64(b0, b0));	\
+	b1 = _mm_unpackhi_epi64(t0, _mm_unpacklo_epi64(b1, b1));	\
+	t0 = c0; c0 = c1; c1 = t0;				\
+	t0 = d0;						\
+	d0 = _mm_unpackhi_epi64(d0, _mm_unpacklo_epi64(d1, d1));	\
+	d1 = _mm_unpackhi_epi64(d1, _mm_unpacklo_epi64(t0, t0));	\
+}
+
+/* K-th of the 8 pairs of row i, or of column i */
+#define ROW_SSE2(K) (q + (i << 4) + ((K) << 1))
+#define COL_SSE2(K) (q + (i << 1) + ((K) << 4))
+
+#define ROUND_SSE2(AT)						\
+{								\
+	a0 = LOAD128(AT(0)); a1 = LOAD128(AT(1));		\
+	b0 = LOAD128(AT(2)); b1 = LOAD128(AT(3));		\
+	c0 = LOAD128(AT(4)); c1 = LOAD128(AT(5));		\
+	d0 = LOAD128(AT(6)); d1 = LOAD128(AT(7));		\
+								\
+	P_SSE2;							\
+								\
+	STORE128(AT(0), a0); STORE128(AT(1), a1);		\
+	STORE128(AT(2), b0); STORE128(AT(3), b1);		\
+	STORE128(AT(4), c0); STORE128(AT(5), c1);		\
+	STORE128(AT(6), d0); STORE128(AT(7), d1);		\
+}
+
+__attribute__((target("sse2")))
+static void blamka_sse2
+(
+	const uint64_t *x,
+	const uint64_t *y,
+	uint64_t *out,
+	int add
+)
+{
+	uint64_t r[WORDS];
+	uint64_t q[WORDS];
+	__m128i a0, a1, b0, b1, c0, c1, d0, d1, t0;
+	unsigned int i;
+
+	for(i = 0; i < WORDS; i += 2)
+	{
+		t0 = _mm_xor_si128(LOAD128(x + i), LOAD128(y + i));
+		STORE128(q + i, t0);
+		STORE128(r + i, t0);
+	}
+
+	for(i = 0; i < 8; i++) ROUND_SSE2(ROW_SSE2);
+	for(i = 0; i < 8; i++) ROUND_SSE2(COL_SSE2);
+
+	for(i = 0; i < WORDS; i += 2)
+	{
+		t0 = _mm_xor_si128(LOAD128(q + i), LOAD128(r + i));
+		if(add) t0 = _mm_xor_si128(t0, LOAD128(out + i));
+		STORE128(out + i, t0);
+	}
+}
+
+#define LOAD256(P) _mm256_loadu_si256((const __m256i *)(P))
+#define STORE256(P, X) _mm256_storeu_si256((__m256i *)(P), X)
+
+/* two 128-bit halves, 16 words apart */
+#define LOAD256_COL(P)						\
+	_mm256_inserti128_si256(_mm256_castsi128_si256(LOAD128(P)),	\
+	LOAD128((P) + 16), 1)
+
+#define STORE256_COL(P, X)					\
+{								\
+	STORE128(P, _mm256_castsi256_si128(X));			\
+	STORE128((P) + 16, _mm256_extracti128_si256(X, 1));	\
+}
+
+#define ADD_AVX2(A, B)						\
+	_mm256_add_epi64(_mm256_add_epi64(A, B),		\
+	_mm256_add_epi64(_mm256_mul_epu32(A, B), _mm256_mul_epu32(A, B)))
+
+#define ROR_AVX2(X, N) ROR_AVX2_##N(X)
+#define ROR_AVX2_32(X) _mm256_shuffle_epi32(X, 0xB1)
+#define ROR_AVX2_24(X) _mm256_shuffle_epi8(X, ror24)
+#define ROR_AVX2_16(X) _mm256_shuffle_epi8(X, ror16)
+#define ROR_AVX2_63(X) \
+	_mm256_xor_si256(_mm256_srli_epi64(X, 63), _mm256_add_epi64(X, X))
+
+#define ROR_AVX512(X, N) _mm256_ror_epi64(X, N)
+
+#define BLAMKA_V(ROR)						\
+{								\
+	const __m256i ror24 = _mm256_setr_epi8			\
+	(							\
+		3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10,	\
+		3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10	\
+	);							\
+	const __m256i ror16 = _mm256_setr_epi8			\
+	(							\
+		2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9,	\
+		2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9	\
+	);							\
+	uint64_t r[WORDS];					\
+	uint64_t q[WORDS];					\
+	__m256i a, b, c, d;					\
+	unsigned int i;						\
+								\
+	(void)ror24;						\
+	(void)ror16;						\
+								\
+	for(i = 0; i < WORDS; i += 4)				\
+	{							\
+		a = _mm256_xor_si256(LOAD256(x + i), LOAD256(y + i));	\
+		STORE256(q + i, a);				\
+		STORE256(r + i, a);				\
+	}							\
+								\
+	for(i = 0; i < 8; i++)					\
+	{							\
+		a = LOAD256(q + (i << 4));			\
+		b = LOAD256(q + (i << 4) + 4);			\
+		c = LOAD256(q + (i << 4) + 8);			\
+		d = LOAD256(q + (i << 4) + 12);			\
+		P_V(ROR);					\
+		STORE256(q + (i << 4), a);			\
+		STORE256(q + (i << 4) + 4, b);			\
+		STORE256(q + (i << 4) + 8, c);			\
+		STORE256(q + (i << 4) + 12, d);			\
+	}							\
+								\
+	for(i = 0; i < 8; i++)					\
+	{							\
+		a = LOAD256_COL(q + (i << 1));			\
+		b = LOAD256_COL(q + (i << 1) + 32);		\
+		c = LOAD256_COL(q + (i << 1) + 64);		\
+		d = LOAD256_COL(q + (i << 1) + 96);		\
+		P_V(ROR);					\
+		STORE256_COL(q + (i << 1), a);			\
+		STORE256_COL(q + (i << 1) + 32, b);		\
+		STORE256_COL(q + (i << 1) + 64, c);		\
+		STORE256_COL(q + (i << 1) + 96, d);		\
+	}							\
+								\
+	for(i = 0; i < WORDS; i += 4)				\
+	{							\
+		a = _mm256_xor_si256(LOAD256(q + i), LOAD256(r + i));	\
+		if(add) a = _mm256_xor_si256(a, LOAD256(out + i));	\
+		STORE256(out + i, a);				\
+	}							\
+}
+
+#define GB_V(ROR)						\
+{								\
+	a = ADD_AVX2(a, b);					\
+	d = ROR(_mm256_xor_si256(d, a), 32);			\
+	c = ADD_AVX2(c, d);					\
+	b = ROR(_mm256_xor_si256(b, c), 24);			\
+	a = ADD_AVX2(a, b);					\
+	d = ROR(_mm256_xor_si256(d, a), 16);			\
+	c = ADD_AVX2(c, d);					\
+	b = ROR(_mm256_xor_si256(b, c), 63);			\
+}
+
+#define P_V(ROR)						\
+{								\
+	GB_V(ROR);						\
+	b = _mm256_permute4x64_epi64(b, 0x39);			\
+	c = _mm256_permute4x64_epi64(c, 0x4E);			\
+	d = _mm256_permute4x64_epi64(d, 0x93);			\
+	GB_V(ROR);						\
+	b = _mm256_permute4x64_epi64(b, 0x93);			\
+	c = _mm256_permute4x64_epi64(c, 0x4E);			\
+	d = _mm256_permute4x64_epi64(d, 0x39);			\
+}
+
+__attribute__((target("avx2")))
+static void blamka_avx2
+(
+	const uint64_t *x,
+	const uint64_t *y,
+	uint64_t *out,
+	int add
+)
+BLAMKA_V(ROR_AVX2)
+
+/* native 64-bit rotates */
+__attribute__((target("avx2,avx512f,avx512vl")))
+static void blamka_avx512
+(
+	const uint64_t *x,
+	const uint64_t *y,
+	uint64_t *out,
+	int add
+)
+BLAMKA_V(ROR_AVX512)
+
+#endif
+
+/* variable length H' */
+static void hprime
+(
+	kripto_hash *h,
+	const void *in,
+	size_t in_len,
+	void *out,
+	uint32_t out_len
+)
+{
+	uint8_t v[64];
+	uint8_t t[4];
+
+	STORE32L(out_len, t);
+
+	if(out_len <= 64)
+	{
+		(void)kripto_hash_recreate(h, 0, 0, 0, out_len);
+		kripto_hash_input(h, t, 4);
+		kripto_hash_input(h, in, in_len);
+		kripto_hash_output(h, out, out_len);
+		return;
+	}
+
+	(void)kripto_hash_recreate(h, 0, 0, 0, 64);
+	kripto_hash_input(h, t, 4);
+	kripto_hash_input(h, in, in_len);
+	kripto_hash_output(h, v, 64);
+
+	for(;;)
+	{
+		memcpy(out, v, 32);
+		out = U8(out) + 32;
+		out_len -= 32;
+
+		if(out_len <= 64) break;
+
+		(void)kripto_hash_recreate(h, 0, 0, 0, 64);
+		kripto_hash_input(h, v, 64);
+		kripto_hash_output(h, v, 64);
+	}
+
+	(void)kripto_hash_recreate(h, 0, 0, 0, out_len);
+	kripto_hash_input(h, v, 64);
+	kripto_hash_output(h, out, out_len);
+
+	kripto_memory_wipe(v, 64);
+}
+
+struct job
+{
+	const kripto_argon2_ctx *s;
+	void (*g)(const uint64_t *, const uint64_t *, uint64_t *, int);
+	unsigned int type;
+	uint32_t t;
+	uint32_t pass;
+	uint32_t slice;
+	uint32_t first;
+	uint32_t step;
+};
+
+/* next block of data independent addresses */
+static void next_addresses(const struct job *j, uint64_t *in, uint64_t *addr)
+{
+	uint64_t zero[WORDS];
+
+	memset(zero, 0, sizeof(zero));
+
+	in[6]++;
+	j->g(zero, in, addr, 0);
+	j->g(zero, addr, addr, 0);
+}
+
+static void segment(const struct job *j, uint32_t lane)
+{
+	const kripto_argon2_ctx *s = j->s;
+	const uint32_t seg = s->q / SLICES;
+	uint64_t in[WORDS];
+	uint64_t addr[WORDS];
+	uint64_t rnd;
+	uint64_t x;
+	uint32_t ref_lane;
+	uint32_t area;
+	uint32_t start;
+	uint32_t cur;
+	uint32_t prev;
+	uint32_t i;
+	int di;
+
+	di = j->type == KRIPTO_ARGON2I || (j->type == KRIPTO_ARGON2ID
+		&& !j->pass && j->slice < SLICES / 2);
+
+	/* first two blocks of every lane come from H' */
+	i = (!j->pass && !j->slice) ? 2 : 0;
+
+	if(di)
+	{
+		memset(in, 0, sizeof(in));
+		in[0] = j->pass;
+		in[1] = lane;
+		in[2] = j->slice;
+		in[3] = s->blocks;
+		in[4] = j->t;
+		in[5] = j->type;
+
+		if(i) next_addresses(j, in, addr);
+	}
+
+	cur = lane * s->q + j->slice * seg + i;
+	prev = (cur % s->q) ? cur - 1 : cur + s->q - 1;
+
+	for(; i < seg; i++, cur++, prev = cur - 1)
+	{
+		if(di)
+		{
+			if(!(i % WORDS)) next_addresses(j, in, addr);
+			rnd = addr[i % WORDS];
+		}
+		else
+		{
+			rnd = s->mem[(size_t)prev * WORDS];
+		}
+
+		ref_lane = (uint32_t)(rnd >> 32) % s->p;
+		if(!j->pass && !j->slice) ref_lane = lane;
+
+		/* blocks that are done, without the previous one */
+		if(!j->pass)
+		{
+			if(ref_lane == lane) area = j->slice * seg + i - 1;
+			else area = j->slice * seg - !i;
+			start = 0;
+		}
+		else
+		{
+			if(ref_lane == lane) area = s->q - seg + i - 1;
+			else area = s->q - seg - !i;
+			start = (j->slice == SLICES - 1) ? 0 : (j->slice + 1) * seg;
+		}
+
+		x = (uint32_t)rnd;
+		x = (x * x) >> 32;
+		x = area - 1 - ((area * x) >> 32);
+
+		j->g
+		(
+			s->mem + (size_t)prev * WORDS,
+			s->mem + ((size_t)ref_lane * s->q + (start + x) % s->q) * WORDS,
+			s->mem + (size_t)cur * WORDS,
+			j->pass != 0
+		);
+	}
+
+	if(di)
+	{
+		kripto_memory_wipe(in, sizeof(in));
+		kripto_memory_wipe(addr, sizeof(addr));
+	}
+}
+
+/* lanes first, first + step, ... of one slice */
+static void *job_run(void *arg)
+{
+	const struct job *j = (const struct job *)arg;
+	uint32_t lane;
+
+	for(lane = j->first; lane < j->s->p; lane += j->step)
+		segment(j, lane);
+
+	return 0;
+}
+
+kripto_argon2_ctx *kripto_argon2_ctx_create
+(
+	uint32_t m,
+	uint32_t p,
+	unsigned int threads,
+	unsigned int flags
+)
+{
+	kripto_argon2_ctx *s;
+
+	assert(p && p < 0x1000000);
+	assert(m >= 8 * p);
+
+	s = (kripto_argon2_ctx *)malloc(sizeof(kripto_argon2_ctx));
+	if(!s) return 0;
+
+	if(!threads) threads = thread_count();
+	if(threads > p) threads = p;
+	if(threads > KRIPTO_THREADS_MAX) threads = KRIPTO_THREADS_MAX;
+
+	s->m = m;
+	s->p = p;
+	s->q = m / (SLICES * p) * SLICES;
+	s->blocks = s->q * p;
+	s->threads = threads;
+
+	if((uint64_t)s->blocks * (WORDS * 8) > SIZE_MAX)
+	{
+		free(s);
+		return 0;
+	}
+
+	s->len = (size_t)s->blocks * (WORDS * 8);
+	s->mem = (uint64_t *)scratch_map(s->len, &s->map,
+		((flags & KRIPTO_ARGON2_HUGEPAGES) ? SCRATCH_HUGE : 0)
+		| ((flags & KRIPTO_ARGON2_LOCK) ? SCRATCH_LOCK : 0));
+	if(!s->mem)
+	{
+		free(s);
+		return 0;
+	}
+
+	return s;
+}
+
+size_t kripto_argon2_ctx_memory(const kripto_argon2_ctx *s)
+{
+	assert(s);
+
+	return s->map;
+}
+
+int kripto_argon2_ctx_run
+(
+	kripto_argon2_ctx *s,
+	unsigned int type,
+	uint32_t t,
+	const void *pass,
+	uint32_t pass_len,
+	const void *salt,
+	uint32_t salt_len,
+	const void *secret,
+	uint32_t secret_len,
+	const void *ad,
+	uint32_t ad_len,
+	void *out,
+	uint32_t out_len
+)
+{
+	struct job j[KRIPTO_THREADS_MAX];
+	void (*g)(const uint64_t *, const uint64_t *, uint64_t *, int);
+	kripto_hash *h;
+	uint8_t h0[72];
+	uint8_t block[WORDS * 8];
+	uint8_t w[4];
+	uint64_t *c;
+	uint32_t lane;
+	uint32_t pass_i;
+	uint32_t slice;
+	unsigned int i;
+
+	assert(s);
+	assert(type <= KRIPTO_ARGON2ID);
+	assert(t);
+	assert(out_len >= 4);
+
+	h = kripto_hash_create(kripto_hash_blake2b, 0, 0, 0, 64);
+	if(!h) return -1;
+
+	/* H0 */
+	STORE32L(s->p, w); kripto_hash_input(h, w, 4);
+	STORE32L(out_len, w); kripto_hash_input(h, w, 4);
+	STORE32L(s->m, w); kripto_hash_input(h, w, 4);
+	STORE32L(t, w); kripto_hash_input(h, w, 4);
+	STORE32L(0x13, w); kripto_hash_input(h, w, 4);
+	STORE32L(type, w); kripto_hash_input(h, w, 4);
+	STORE32L(pass_len, w); kripto_hash_input(h, w, 4);
+	kripto_hash_input(h, pass, pass_len);
+	STORE32L(salt_len, w); kripto_hash_input(h, w, 4);
+	kripto_hash_input(h, salt, salt_len);
+	STORE32L(secret_len, w); kripto_hash_input(h, w, 4);
+	kripto_hash_input(h, secret, secret_len);
+	STORE32L(ad_len, w); kripto_hash_input(h, w, 4);
+	kripto_hash_input(h, ad, ad_len);
+	kripto_hash_output(h, h0, 64);
+
+	/* first two blocks of every lane */
+	for(lane = 0; lane < s->p; lane++)
+	{
+		STORE32L(lane, h0 + 68);
+
+		for(i = 0; i < 2; i++)
+		{
+			STORE32L(i, h0 + 64);
+			hprime(h, h0, 72, block, WORDS * 8);
+
+			/* LOAD64L_ARRAY ors into the destination */
+			c = s->mem + ((size_t)lane * s->q + i) * WORDS;
+			memset(c, 0, WORDS * 8);
+			LOAD64L_ARRAY(block, c, WORDS * 8);
+		}
+	}
+
+	g = &blamka;
+
+	#ifdef SIMD
+	if(kripto_cpu() & KRIPTO_CPU_SSE2) g = &blamka_sse2;
+	if(kripto_cpu() & KRIPTO_CPU_AVX2) g = &blamka_avx2;
+	if(kripto_cpu() & KRIPTO_CPU_AVX512) g = &blamka_avx512;
+	#endif
+
+	for(i = 0; i < s->threads; i++)
+	{
+		j[i].s = s;
+		j[i].g = g;
+		j[i].type = type;
+		j[i].t = t;
+		j[i].first = i;
+		j[i].step = s->threads;
+	}
+
+	/* lanes of a slice are independent, slices are synchronized */
+	for(pass_i = 0; pass_i < t; pass_i++)
+	{
+		for(slice = 0; slice < SLICES; slice++)
+		{
+			for(i = 0; i < s->threads; i++)
+			{
+				j[i].pass = pass_i;
+				j[i].slice = slice;
+			}
+
+			thread_run(&job_run, j, sizeof(struct job), s->threads);
+		}
+	}
+
+	/* last column into the first, H' of it */
+	c = s->mem + (size_t)(s->q - 1) * WORDS;
+	for(lane = 1; lane < s->p; lane++)
+	{
+		for(i = 0; i < WORDS; i++)
+			c[i] ^= s->mem[((size_t)lane * s->q + s->q - 1) * WORDS + i];
+	}
+
+	STORE64L_ARRAY(c, 0, block, WORDS * 8);
+	hprime(h, block, WORDS * 8, out, out_len);
+
+	kripto_hash_destroy(h);
+	kripto_memory_wipe(h0, sizeof(h0));
+	kripto_memory_wipe(block, sizeof(block));
+
+	return 0;
+}
+
+void kripto_argon2_ctx_destroy(kripto_argon2_ctx *s)
+{
+	assert(s);
+
+	kripto_memory_wipe(s->mem, s->len);
+	scratch_unmap(s->mem, s->map);
+
+	kripto_memory_wipe(s, sizeof(kripto_argon2_ctx));
+	free(s);
+}
+
+int kripto_argon2
+(
+	unsigned int type,
+	uint32_t t,
+	uint32_t m,
+	uint32_t p,
+	const void *pass,
+	uint32_t pass_len,
+	const void *salt,
+	uint32_t salt_len,
+	const void *secret,
+	uint32_t secret_len,
+	const void *ad,
+	uint32_t ad_len,
+	void *out,
+	uint32_t out_len
+)
+{
+	kripto_argon2_ctx *s;
+	int err;
+
+	s = kripto_argon2_ctx_create(m, p, 0, 0);
+	if(!s) return -1;
+
+	err = kripto_argon2_ctx_run
+	(
+		s,
+		type,
+		t,
+		pass,
+		pass_len,
+		salt,
+		salt_len,
+		secret,
+		secret_len,
+		ad,
+		ad_len,
+		out,
+		out_len
+	);
+
+	kripto_argon2_ctx_destroy(s);
+
+	return err;
+}
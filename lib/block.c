@@ -14,10 +14,16 @@
  */
 
 #include <assert.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include <kripto/cast.h>
 
 #include <kripto/block.h>
 #include <kripto/desc/block.h>
 
+#include "alloc.h"
+
 struct kripto_block
 {
 	const kripto_desc_block *desc;
@@ -109,6 +115,101 @@ void kripto_block_decrypt
 	s->desc->decrypt(s, ct, pt);
 }
 
+void kripto_block_encrypt_blocks
+(
+	const kripto_block *s,
+	const void *pt,
+	void *ct,
+	size_t blocks
+)
+{
+	assert(s);
+	assert(s->desc);
+	assert(s->desc->encrypt);
+	assert(pt || !blocks);
+	assert(ct || !blocks);
+
+	if(s->desc->encrypt_blocks)
+	{
+		s->desc->encrypt_blocks(s, pt, ct, blocks);
+		return;
+	}
+
+	/* generic */
+	for(; blocks; blocks--)
+	{
+		s->desc->encrypt(s, pt, ct);
+
+		pt = CU8(pt) + s->desc->blocksize;
+		ct = U8(ct) + s->desc->blocksize;
+	}
+}
+
+void kripto_block_decrypt_blocks
+(
+	const kripto_block *s,
+	const void *ct,
+	void *pt,
+	size_t blocks
+)
+{
+	assert(s);
+	assert(s->desc);
+	assert(s->desc->decrypt);
+	assert(ct || !blocks);
+	assert(pt || !blocks);
+
+	if(s->desc->decrypt_blocks)
+	{
+		s->desc->decrypt_blocks(s, ct, pt, blocks);
+		return;
+	}
+
+	/* generic */
+	for(; blocks; blocks--)
+	{
+		s->desc->decrypt(s, ct, pt);
+
+		ct = CU8(ct) + s->desc->blocksize;
+		pt = U8(pt) + s->desc->blocksize;
+	}
+}
+
+void kripto_block_encrypt_multi
+(
+	const kripto_block *const *s,
+	const void *const *pt,
+	void *const *ct,
+	unsigned int n
+)
+{
+	unsigned int i;
+
+	assert(s || !n);
+	assert(pt || !n);
+	assert(ct || !n);
+
+	if(!n) return;
+
+	assert(s[0]);
+	assert(s[0]->desc);
+	assert(s[0]->desc->encrypt);
+
+	if(s[0]->desc->encrypt_multi)
+	{
+		s[0]->desc->encrypt_multi(s, pt, ct, n);
+		return;
+	}
+
+	/* generic */
+	for(i = 0; i < n; i++)
+	{
+		assert(s[i]->desc == s[0]->desc);
+
+		s[0]->desc->encrypt(s[i], pt[i], ct[i]);
+	}
+}
+
 void kripto_block_destroy(kripto_block *s)
 {
 	assert(s);
@@ -118,6 +219,65 @@ void kripto_block_destroy(kripto_block *s)
 	s->desc->destroy(s);
 }
 
+/* create with a zero key, counting what it takes */
+size_t kripto_block_ctx_size
+(
+	const kripto_desc_block *desc,
+	unsigned int rounds,
+	unsigned int key_len
+)
+{
+	struct kripto_alloc_arena a;
+	kripto_block *s;
+	void *zero;
+	size_t len;
+
+	assert(desc);
+	assert(desc->create);
+
+	zero = calloc(key_len + 1, 1);
+	if(!zero) return 0;
+
+	kripto_alloc_begin(&a, 0, 0);
+	s = kripto_block_create(desc, rounds, zero, key_len);
+	len = kripto_alloc_end(&a);
+
+	free(zero);
+
+	if(!s) return 0;
+	kripto_block_destroy(s);
+
+	return len;
+}
+
+kripto_block *kripto_block_init
+(
+	const kripto_desc_block *desc,
+	void *mem,
+	size_t len,
+	unsigned int rounds,
+	const void *key,
+	unsigned int key_len
+)
+{
+	struct kripto_alloc_arena a;
+	kripto_block *s;
+
+	assert(mem);
+
+	kripto_alloc_begin(&a, mem, len);
+	s = kripto_block_create(desc, rounds, key, key_len);
+	(void)kripto_alloc_end(&a);
+
+	return s;
+}
+
+/* destroy wipes, kripto_free leaves caller memory alone */
+void kripto_block_fini(kripto_block *s)
+{
+	kripto_block_destroy(s);
+}
+
 const kripto_desc_block *kripto_block_getdesc(const kripto_block *s)
 {
 	assert(s);
@@ -28,6 +28,8 @@ The original code and all modifications are in the public domain. */
 
 #include <kripto/block/3way.h>
 
+#include "../alloc.h"
+
 struct kripto_block
 {
 	const kripto_desc_block *desc;
@@ -207,7 +209,7 @@ static kripto_block *threeway_create
 	unsigned int key_len
 )
 {
-	kripto_block *s = (kripto_block *)malloc(sizeof(kripto_block));
+	kripto_block *s = (kripto_block *)kripto_alloc(sizeof(kripto_block));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -218,7 +220,7 @@ static kripto_block *threeway_create
 static void threeway_destroy(kripto_block *s)
 {
 	kripto_memory_wipe(s, sizeof(kripto_block));
-	free(s);
+	kripto_free(s);
 }
 
 static const kripto_desc_block threeway =
@@ -228,6 +230,9 @@ static const kripto_desc_block threeway =
 	0, /* tweak */
 	&threeway_encrypt,
 	&threeway_decrypt,
+	0, /* encrypt blocks */
+	0, /* decrypt blocks */
+	0, /* encrypt multi */
 	&threeway_destroy,
 	12, /* block size */
 	12, /* max key */
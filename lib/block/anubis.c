@@ -29,6 +29,8 @@
 
 #include <kripto/block/anubis.h>
 
+#include "../alloc.h"
+
 struct kripto_block
 {
 	const kripto_desc_block *desc;
@@ -735,7 +737,7 @@ static kripto_block *anubis_create
 		if(r < 12) r = 12;
 	}
 
-	s = (kripto_block *)malloc(sizeof(kripto_block) + ((r + 1) << 5));
+	s = (kripto_block *)kripto_alloc(sizeof(kripto_block) + ((r + 1) << 5));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -751,7 +753,7 @@ static kripto_block *anubis_create
 static void anubis_destroy(kripto_block *s)
 {
 	kripto_memory_wipe(s, sizeof(kripto_block) + ((s->rounds + 1) << 5));
-	free(s);
+	kripto_free(s);
 }
 
 static kripto_block *anubis_recreate
@@ -762,6 +764,8 @@ static kripto_block *anubis_recreate
 	unsigned int key_len
 )
 {
+	const kripto_desc_block *desc = s->desc;
+
 	if(!r)
 	{
 		r = 8 + ((key_len + 3) >> 2);
@@ -771,7 +775,7 @@ static kripto_block *anubis_recreate
 	if(r != s->rounds)
 	{
 		anubis_destroy(s);
-		s = anubis_create(s->desc, r, key, key_len);
+		s = anubis_create(desc, r, key, key_len);
 	}
 	else
 	{
@@ -788,6 +792,9 @@ static const kripto_desc_block anubis =
 	0, /* tweak */
 	&anubis_encrypt,
 	&anubis_decrypt,
+	0, /* encrypt blocks */
+	0, /* decrypt blocks */
+	0, /* encrypt multi */
 	&anubis_destroy,
 	16, /* block size */
 	40, /* max key */
@@ -26,6 +26,8 @@
 
 #include <kripto/block/aria.h>
 
+#include "../alloc.h"
+
 struct kripto_block
 {
 	const kripto_desc_block *desc;
@@ -669,7 +671,7 @@ static kripto_block *aria_create
 		if(r < 12) r = 12;
 	}
 
-	s = (kripto_block *)malloc(sizeof(kripto_block) + ((r + 1) << 5));
+	s = (kripto_block *)kripto_alloc(sizeof(kripto_block) + ((r + 1) << 5));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -685,7 +687,7 @@ static kripto_block *aria_create
 static void aria_destroy(kripto_block *s)
 {
 	kripto_memory_wipe(s, sizeof(kripto_block) + ((s->rounds + 1) << 5));
-	free(s);
+	kripto_free(s);
 }
 
 static kripto_block *aria_recreate
@@ -696,6 +698,8 @@ static kripto_block *aria_recreate
 	unsigned int key_len
 )
 {
+	const kripto_desc_block *desc = s->desc;
+
 	if(!r)
 	{
 		r = 8 + ((key_len + 3) >> 2);
@@ -706,7 +710,7 @@ static kripto_block *aria_recreate
 	if(r != s->rounds)
 	{
 		aria_destroy(s);
-		s = aria_create(s->desc, r, key, key_len);
+		s = aria_create(desc, r, key, key_len);
 	}
 	else
 	{
@@ -723,6 +727,9 @@ static const kripto_desc_block aria =
 	0, /* tweak */
 	&aria_encrypt,
 	&aria_decrypt,
+	0, /* encrypt blocks */
+	0, /* decrypt blocks */
+	0, /* encrypt multi */
 	&aria_destroy,
 	16, /* block size */
 	32, /* max key */
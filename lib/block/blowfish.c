@@ -25,6 +25,8 @@
 
 #include <kripto/block/blowfish.h>
 
+#include "../alloc.h"
+
 struct kripto_block
 {
 	const kripto_desc_block *desc;
@@ -489,7 +491,7 @@ static kripto_block *blowfish_create
 
 	if(!r) r = 16;
 
-	s = (kripto_block *)malloc(sizeof(kripto_block) + ((r + 2) << 2));
+	s = (kripto_block *)kripto_alloc(sizeof(kripto_block) + ((r + 2) << 2));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -504,7 +506,7 @@ static kripto_block *blowfish_create
 static void blowfish_destroy(kripto_block *s)
 {
 	kripto_memory_wipe(s, sizeof(kripto_block) + ((s->rounds + 2) << 2));
-	free(s);
+	kripto_free(s);
 }
 
 static kripto_block *blowfish_recreate
@@ -515,12 +517,14 @@ static kripto_block *blowfish_recreate
 	unsigned int key_len
 )
 {
+	const kripto_desc_block *desc = s->desc;
+
 	if(!r) r = 16;
 
 	if(r != s->rounds)
 	{
 		blowfish_destroy(s);
-		s = blowfish_create(s->desc, r, key, key_len);
+		s = blowfish_create(desc, r, key, key_len);
 	}
 	else
 	{
@@ -537,6 +541,9 @@ static const kripto_desc_block blowfish =
 	0, /* tweak */
 	&blowfish_encrypt,
 	&blowfish_decrypt,
+	0, /* encrypt blocks */
+	0, /* decrypt blocks */
+	0, /* encrypt multi */
 	&blowfish_destroy,
 	8, /* block size */
 	56, /* max key */
@@ -28,6 +28,8 @@
 
 #include <kripto/block/camellia.h>
 
+#include "../alloc.h"
+
 struct kripto_block
 {
 	const kripto_desc_block *desc;
@@ -660,7 +662,7 @@ static kripto_block *camellia_create
 	unsigned int key_len
 )
 {
-	kripto_block *s = (kripto_block *)malloc(sizeof(kripto_block));
+	kripto_block *s = (kripto_block *)kripto_alloc(sizeof(kripto_block));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -673,7 +675,7 @@ static kripto_block *camellia_create
 static void camellia_destroy(kripto_block *s)
 {
 	kripto_memory_wipe(s, sizeof(kripto_block));
-	free(s);
+	kripto_free(s);
 }
 
 static const kripto_desc_block camellia =
@@ -683,6 +685,9 @@ static const kripto_desc_block camellia =
 	0, /* tweak */
 	&camellia_encrypt,
 	&camellia_decrypt,
+	0, /* encrypt blocks */
+	0, /* decrypt blocks */
+	0, /* encrypt multi */
 	&camellia_destroy,
 	16, /* block size */
 	32, /* max key */
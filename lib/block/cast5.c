@@ -28,6 +28,8 @@
 
 #include <kripto/block/cast5.h>
 
+#include "../alloc.h"
+
 struct kripto_block
 {
 	const kripto_desc_block *desc;
@@ -798,7 +800,7 @@ static kripto_block *cast5_create
 	unsigned int key_len
 )
 {
-	kripto_block *s = (kripto_block *)malloc(sizeof(kripto_block));
+	kripto_block *s = (kripto_block *)kripto_alloc(sizeof(kripto_block));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -809,7 +811,7 @@ static kripto_block *cast5_create
 static void cast5_destroy(kripto_block *s)
 {
 	kripto_memory_wipe(s, sizeof(kripto_block));
-	free(s);
+	kripto_free(s);
 }
 
 static const kripto_desc_block cast5 =
@@ -819,6 +821,9 @@ static const kripto_desc_block cast5 =
 	0, /* tweak */
 	&cast5_encrypt,
 	&cast5_decrypt,
+	0, /* encrypt blocks */
+	0, /* decrypt blocks */
+	0, /* encrypt multi */
 	&cast5_destroy,
 	8, /* block size */
 	16, /* max key */
@@ -25,6 +25,8 @@
 
 #include <kripto/block/crax_s.h>
 
+#include "../alloc.h"
+
 struct kripto_block
 {
 	const kripto_desc_block *desc;
@@ -142,7 +144,7 @@ static kripto_block *crax_s_create
 {
 	if(!r) r = 10;
 
-	kripto_block *s = (kripto_block *)malloc(sizeof(kripto_block));
+	kripto_block *s = (kripto_block *)kripto_alloc(sizeof(kripto_block));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -156,7 +158,7 @@ static kripto_block *crax_s_create
 static void crax_s_destroy(kripto_block *s)
 {
 	kripto_memory_wipe(s, sizeof(kripto_block));
-	free(s);
+	kripto_free(s);
 }
 
 static kripto_block *crax_s_recreate
@@ -40,6 +40,8 @@
 
 #include <kripto/block/des.h>
 
+#include "../alloc.h"
+
 struct kripto_block
 {
 	const kripto_desc_block *desc;
@@ -493,7 +495,7 @@ static kripto_block *des_create
 	unsigned int key_len
 )
 {
-	kripto_block *s = (kripto_block *)malloc(sizeof(kripto_block));
+	kripto_block *s = (kripto_block *)kripto_alloc(sizeof(kripto_block));
 	if(!s) return 0;
 
 	(void)r;
@@ -508,7 +510,7 @@ static kripto_block *des_create
 static void des_destroy(kripto_block *s)
 {
 	kripto_memory_wipe(s, sizeof(kripto_block));
-	free(s);
+	kripto_free(s);
 }
 
 static kripto_block *des_recreate
@@ -533,6 +535,9 @@ static const kripto_desc_block des =
 	0, /* tweak */
 	&des_encrypt,
 	&des_decrypt,
+	0, /* encrypt blocks */
+	0, /* decrypt blocks */
+	0, /* encrypt multi */
 	&des_destroy,
 	8, /* block size */
 	24, /* max key */
@@ -25,6 +25,8 @@
 
 #include <kripto/block/gost.h>
 
+#include "../alloc.h"
+
 struct kripto_block
 {
 	const kripto_desc_block *desc;
@@ -150,7 +152,7 @@ static kripto_block *gost_create
 
 	if(!r) r = 32;
 
-	s = (kripto_block *)malloc(sizeof(kripto_block) + (r << 2));
+	s = (kripto_block *)kripto_alloc(sizeof(kripto_block) + (r << 2));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -175,7 +177,7 @@ static kripto_block *gost_create
 static void gost_destroy(kripto_block *s)
 {
 	kripto_memory_wipe(s, sizeof(kripto_block) + (s->r << 2));
-	free(s);
+	kripto_free(s);
 }
 
 static kripto_block *gost_recreate
@@ -186,12 +188,14 @@ static kripto_block *gost_recreate
 	unsigned int key_len
 )
 {
+	const kripto_desc_block *desc = s->desc;
+
 	if(!r) r = 32;
 
 	if(r != s->r)
 	{
 		gost_destroy(s);
-		s = gost_create(s->desc, r, key, key_len);
+		s = gost_create(desc, r, key, key_len);
 	}
 	else
 	{
@@ -210,6 +214,9 @@ kripto_desc_block *kripto_block_gost(const unsigned char (*sboxes)[16])
 	desc->tweak = 0;
 	desc->encrypt = &gost_encrypt;
 	desc->decrypt = &gost_decrypt;
+	desc->encrypt_blocks = 0;
+	desc->decrypt_blocks = 0;
+	desc->encrypt_multi = 0;
 	desc->destroy = &gost_destroy;
 	desc->blocksize = 8;
 	desc->maxkey = 32;
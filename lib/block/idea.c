@@ -26,6 +26,8 @@
 
 #include <kripto/block/idea.h>
 
+#include "../alloc.h"
+
 struct kripto_block
 {
 	const kripto_desc_block *desc;
@@ -181,7 +183,7 @@ static kripto_block *idea_create
 
 	if(!r) r = 8;
 
-	s = (kripto_block *)malloc(sizeof(kripto_block) + r * 24 + 16);
+	s = (kripto_block *)kripto_alloc(sizeof(kripto_block) + r * 24 + 16);
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -197,7 +199,7 @@ static kripto_block *idea_create
 static void idea_destroy(kripto_block *s)
 {
 	kripto_memory_wipe(s, sizeof(kripto_block) + s->r * 24 + 16);
-	free(s);
+	kripto_free(s);
 }
 
 static kripto_block *idea_recreate
@@ -208,12 +210,14 @@ static kripto_block *idea_recreate
 	unsigned int key_len
 )
 {
+	const kripto_desc_block *desc = s->desc;
+
 	if(!r) r = 8;
 
 	if(r != s->r)
 	{
 		idea_destroy(s);
-		s = idea_create(s->desc, r, key, key_len);
+		s = idea_create(desc, r, key, key_len);
 	}
 	else
 	{
@@ -230,6 +234,9 @@ static const kripto_desc_block idea =
 	0, /* tweak */
 	&idea_encrypt,
 	&idea_decrypt,
+	0, /* encrypt blocks */
+	0, /* decrypt blocks */
+	0, /* encrypt multi */
 	&idea_destroy,
 	8, /* block size */
 	16, /* max key */
@@ -24,6 +24,8 @@
 
 #include <kripto/block/khazad.h>
 
+#include "../alloc.h"
+
 struct kripto_block
 {
 	const kripto_desc_block *desc;
@@ -716,7 +718,7 @@ static kripto_block *khazad_create
 
 	if(!r) r = 8;
 
-	s = (kripto_block *)malloc(sizeof(kripto_block) + ((r + 1) << 4));
+	s = (kripto_block *)kripto_alloc(sizeof(kripto_block) + ((r + 1) << 4));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -732,7 +734,7 @@ static kripto_block *khazad_create
 static void khazad_destroy(kripto_block *s)
 {
 	kripto_memory_wipe(s, sizeof(kripto_block) + ((s->r + 1) << 4));
-	free(s);
+	kripto_free(s);
 }
 
 static kripto_block *khazad_recreate
@@ -743,12 +745,14 @@ static kripto_block *khazad_recreate
 	unsigned int key_len
 )
 {
+	const kripto_desc_block *desc = s->desc;
+
 	if(!r) r = 8;
 
 	if(r != s->r)
 	{
 		khazad_destroy(s);
-		s = khazad_create(s->desc, r, key, key_len);
+		s = khazad_create(desc, r, key, key_len);
 	}
 	else
 	{
@@ -765,6 +769,9 @@ static const kripto_desc_block khazad =
 	0, /* tweak */
 	&khazad_encrypt,
 	&khazad_decrypt,
+	0, /* encrypt blocks */
+	0, /* decrypt blocks */
+	0, /* encrypt multi */
 	&khazad_destroy,
 	8, /* block size */
 	16, /* max key */
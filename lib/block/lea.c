@@ -26,6 +26,8 @@
 
 #include <kripto/block/lea.h>
 
+#include "../alloc.h"
+
 struct kripto_block
 {
 	const kripto_desc_block *desc;
@@ -215,7 +217,7 @@ static kripto_block *lea_create
 		else r = 24;
 	}
 
-	kripto_block *s = (kripto_block *)malloc(sizeof(kripto_block) + r * 24);
+	kripto_block *s = (kripto_block *)kripto_alloc(sizeof(kripto_block) + r * 24);
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -229,7 +231,7 @@ static kripto_block *lea_create
 static void lea_destroy(kripto_block *s)
 {
 	kripto_memory_wipe(s, sizeof(kripto_block) + s->r * 24);
-	free(s);
+	kripto_free(s);
 }
 
 static kripto_block *lea_recreate
@@ -240,6 +242,8 @@ static kripto_block *lea_recreate
 	unsigned int key_len
 )
 {
+	const kripto_desc_block *desc = s->desc;
+
 	if(!r)
 	{
 		if(key_len > 24) r = 32;
@@ -250,7 +254,7 @@ static kripto_block *lea_recreate
 	if(r != s->r)
 	{
 		lea_destroy(s);
-		s = lea_create(s->desc, r, key, key_len);
+		s = lea_create(desc, r, key, key_len);
 	}
 	else
 	{
@@ -267,6 +271,9 @@ static const kripto_desc_block lea =
 	0, /* tweak */
 	&lea_encrypt,
 	&lea_decrypt,
+	0, /* encrypt blocks */
+	0, /* decrypt blocks */
+	0, /* encrypt multi */
 	&lea_destroy,
 	16, /* block size */
 	32, /* max key */
@@ -26,6 +26,8 @@
 
 #include <kripto/block/noekeon.h>
 
+#include "../alloc.h"
+
 struct kripto_block
 {
 	const kripto_desc_block *desc;
@@ -183,7 +185,7 @@ static kripto_block *noekeon_create
 	unsigned int key_len
 )
 {
-	kripto_block *s = (kripto_block *)malloc(sizeof(kripto_block));
+	kripto_block *s = (kripto_block *)kripto_alloc(sizeof(kripto_block));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -211,7 +213,7 @@ static kripto_block *noekeon_recreate
 static void noekeon_destroy(kripto_block *s)
 {
 	kripto_memory_wipe(s, sizeof(kripto_block));
-	free(s);
+	kripto_free(s);
 }
 
 static const kripto_desc_block noekeon =
@@ -221,6 +223,9 @@ static const kripto_desc_block noekeon =
 	0, /* tweak */
 	&noekeon_encrypt,
 	&noekeon_decrypt,
+	0, /* encrypt blocks */
+	0, /* decrypt blocks */
+	0, /* encrypt multi */
 	&noekeon_destroy,
 	16, /* block size */
 	16, /* max key */
@@ -29,6 +29,8 @@
 
 #include <kripto/block/rc2.h>
 
+#include "../alloc.h"
+
 struct kripto_block
 {
 	const kripto_desc_block *desc;
@@ -195,7 +197,7 @@ static kripto_block *rc2_create
 	unsigned int key_len
 )
 {
-	kripto_block *s = (kripto_block *)malloc(sizeof(kripto_block));
+	kripto_block *s = (kripto_block *)kripto_alloc(sizeof(kripto_block));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -206,7 +208,7 @@ static kripto_block *rc2_create
 static void rc2_destroy(kripto_block *s)
 {
 	kripto_memory_wipe(s, sizeof(kripto_block));
-	free(s);
+	kripto_free(s);
 }
 
 static const kripto_desc_block rc2 =
@@ -216,6 +218,9 @@ static const kripto_desc_block rc2 =
 	0, /* tweak */
 	&rc2_encrypt,
 	&rc2_decrypt,
+	0, /* encrypt blocks */
+	0, /* decrypt blocks */
+	0, /* encrypt multi */
 	&rc2_destroy,
 	8, /* block size */
 	128, /* max key */
@@ -26,6 +26,8 @@
 
 #include <kripto/block/rc5.h>
 
+#include "../alloc.h"
+
 struct kripto_block
 {
 	const kripto_desc_block *desc;
@@ -126,7 +128,7 @@ static kripto_block *rc5_create
 
 	if(!r) r = 12;
 
-	s = (kripto_block *)malloc(sizeof(kripto_block) + ((r + 1) << 3));
+	s = (kripto_block *)kripto_alloc(sizeof(kripto_block) + ((r + 1) << 3));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -141,7 +143,7 @@ static kripto_block *rc5_create
 static void rc5_destroy(kripto_block *s)
 {
 	kripto_memory_wipe(s, sizeof(kripto_block) + ((s->r + 1) << 3));
-	free(s);
+	kripto_free(s);
 }
 
 static kripto_block *rc5_recreate
@@ -152,12 +154,14 @@ static kripto_block *rc5_recreate
 	unsigned int key_len
 )
 {
+	const kripto_desc_block *desc = s->desc;
+
 	if(!r) r = 12;
 
 	if(r != s->r)
 	{
 		rc5_destroy(s);
-		s = rc5_create(s->desc, r, key, key_len);
+		s = rc5_create(desc, r, key, key_len);
 	}
 	else
 	{
@@ -174,6 +178,9 @@ static const kripto_desc_block rc5 =
 	0, /* tweak */
 	&rc5_encrypt,
 	&rc5_decrypt,
+	0, /* encrypt blocks */
+	0, /* decrypt blocks */
+	0, /* encrypt multi */
 	&rc5_destroy,
 	8, /* block size */
 	255, /* max key */
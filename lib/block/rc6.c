@@ -26,6 +26,8 @@
 
 #include <kripto/block/rc6.h>
 
+#include "../alloc.h"
+
 struct kripto_block
 {
 	const kripto_desc_block *desc;
@@ -167,7 +169,7 @@ static kripto_block *rc6_create
 
 	if(!r) r = 20;
 
-	s = (kripto_block *)malloc(sizeof(kripto_block) + (RC6_K_LEN(r) << 2));
+	s = (kripto_block *)kripto_alloc(sizeof(kripto_block) + (RC6_K_LEN(r) << 2));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -182,7 +184,7 @@ static kripto_block *rc6_create
 static void rc6_destroy(kripto_block *s)
 {
 	kripto_memory_wipe(s, sizeof(kripto_block) + (RC6_K_LEN(s->rounds) << 2));
-	free(s);
+	kripto_free(s);
 }
 
 static kripto_block *rc6_recreate
@@ -193,12 +195,14 @@ static kripto_block *rc6_recreate
 	unsigned int key_len
 )
 {
+	const kripto_desc_block *desc = s->desc;
+
 	if(!r) r = 20;
 
 	if(r != s->rounds)
 	{
 		rc6_destroy(s);
-		s = rc6_create(s->desc, r, key, key_len);
+		s = rc6_create(desc, r, key, key_len);
 	}
 	else
 	{
@@ -215,6 +219,9 @@ static const kripto_desc_block rc6 =
 	0, /* tweak */
 	&rc6_encrypt,
 	&rc6_decrypt,
+	0, /* encrypt blocks */
+	0, /* decrypt blocks */
+	0, /* encrypt multi */
 	&rc6_destroy,
 	16, /* block size */
 	255, /* max key */
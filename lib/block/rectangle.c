@@ -27,6 +27,8 @@
 
 #include <kripto/block/rectangle.h>
 
+#include "../alloc.h"
+
 struct kripto_block
 {
 	const kripto_desc_block *desc;
@@ -254,7 +256,7 @@ static kripto_block *rectangle_create
 
 	if(!r) r = 25;
 
-	kripto_block *s = (kripto_block *)malloc(sizeof(kripto_block) + ((r + 1) << 3));
+	kripto_block *s = (kripto_block *)kripto_alloc(sizeof(kripto_block) + ((r + 1) << 3));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -269,7 +271,7 @@ static kripto_block *rectangle_create
 static void rectangle_destroy(kripto_block *s)
 {
 	kripto_memory_wipe(s, sizeof(kripto_block) + ((s->rounds + 1) << 3));
-	free(s);
+	kripto_free(s);
 }
 
 static kripto_block *rectangle_recreate
@@ -280,6 +282,8 @@ static kripto_block *rectangle_recreate
 	unsigned int key_len
 )
 {
+	const kripto_desc_block *desc = s->desc;
+
 	assert(r <= 25);
 
 	if(!r) r = 25;
@@ -287,7 +291,7 @@ static kripto_block *rectangle_recreate
 	if(r != s->rounds)
 	{
 		rectangle_destroy(s);
-		s = rectangle_create(s->desc, r, key, key_len);
+		s = rectangle_create(desc, r, key, key_len);
 	}
 	else
 	{
@@ -304,6 +308,9 @@ static const kripto_desc_block rectangle =
 	0, /* tweak */
 	&rectangle_encrypt,
 	&rectangle_decrypt,
+	0, /* encrypt blocks */
+	0, /* decrypt blocks */
+	0, /* encrypt multi */
 	&rectangle_destroy,
 	8, /* block size */
 	16, /* max key */
@@ -28,8 +28,16 @@
 #include <stdint.h>
 #include <stdlib.h>
 
+#if (defined(__GNUC__) || defined(__clang__)) \
+&& (defined(__i386__) || defined(__x86_64__))
+#define AESNI
+#include <wmmintrin.h>
+#endif
+
 #include <kripto/cast.h>
+#include <kripto/cpu.h>
 #include <kripto/loadstore.h>
+#include <kripto/rotate.h>
 #include <kripto/memory.h>
 #include <kripto/block.h>
 #include <kripto/desc/block.h>
@@ -38,12 +46,15 @@
 #include <kripto/block/rijndael128.h>
 #include <kripto/block/rijndael256.h>
 
+#include "../alloc.h"
+
 struct kripto_block
 {
 	const kripto_desc_block *desc;
 	unsigned int rounds;
 	uint32_t *k;
 	uint32_t *dk;
+	int ni;
 };
 
 static const uint32_t te0[256] =
@@ -711,12 +722,18 @@ static const uint32_t rcon[52] =
 	td4[(uint8_t)(X3)]			\
 )
 
+static uint32_t sub_word(uint32_t t)
+{
+	return EL(t, t, t, t);
+}
+
 static void rijndael_setup
 (
 	kripto_block *s,
 	const uint8_t *key,
 	unsigned int key_len,
-	unsigned int bs
+	unsigned int bs,
+	uint32_t (*sub)(uint32_t)
 )
 {
 	unsigned int i;
@@ -735,11 +752,7 @@ static void rijndael_setup
 	for(j = n, x = 0; j < len; j += n)
 	{
 		t = s->k[j - 1];
-		s->k[j] = s->k[j - n] ^
-			((te4[(t >> 16) & 0xFF] << 24) |
-			(te4[(t >> 8) & 0xFF] << 16) |
-			(te4[t & 0xFF] << 8) |
-			te4[t >> 24]) ^ rcon[x++];
+		s->k[j] = s->k[j - n] ^ ROL32_08(sub(t)) ^ rcon[x++];
 
 		if(n <= 6)
 		{
@@ -754,7 +767,7 @@ static void rijndael_setup
 			if(j + 4 < len)
 			{
 				t = s->k[j + 3];
-				s->k[j + 4] = s->k[j + 4 - n] ^ EL(t, t, t, t);
+				s->k[j + 4] = s->k[j + 4 - n] ^ sub(t);
 			}
 
 			for(i = 5; i < n && i + j < len; i++)
@@ -762,6 +775,21 @@ static void rijndael_setup
 		}
 	}
 
+	/* wipe */
+	kripto_memory_wipe(&t, sizeof(uint32_t));
+}
+
+static void rijndael_invert(kripto_block *s, unsigned int bs)
+{
+	unsigned int i;
+	unsigned int j;
+	unsigned int x;
+	unsigned int len;
+	uint32_t t;
+
+	bs >>= 2;
+	len = (s->rounds + 1) * bs;
+
 	/* invert the order of the round keys */
 	for(i = 0, j = len - bs; i <= j; i += bs, j -= bs)
 	{
@@ -787,6 +815,270 @@ static void rijndael_setup
 	kripto_memory_wipe(&t, sizeof(uint32_t));
 }
 
+#ifdef AESNI
+
+/* AES-NI */
+
+#define NI __attribute__((target("sse2,aes")))
+
+#define RK(K, I) _mm_loadu_si128((const __m128i *)(K) + (I))
+
+NI static uint32_t ni_sub_word(uint32_t t)
+{
+	uint32_t x;
+
+	/* AESKEYGENASSIST puts SubWord(X1) into X0 */
+	x = _mm_cvtsi128_si32(_mm_aeskeygenassist_si128(_mm_set_epi32(0, 0, (int)t, 0), 0));
+
+	return x;
+}
+
+NI static void ni_invert(kripto_block *s)
+{
+	unsigned int i;
+	__m128i *dk = (__m128i *)s->dk;
+
+	/* round keys to byte order */
+	for(i = 0; i < ((s->rounds + 1) << 2); i++)
+		STORE32B(s->k[i], s->k + i);
+
+	_mm_storeu_si128(dk, RK(s->k, s->rounds));
+
+	for(i = 1; i < s->rounds; i++)
+		_mm_storeu_si128(dk + i, _mm_aesimc_si128(RK(s->k, s->rounds - i)));
+
+	_mm_storeu_si128(dk + i, RK(s->k, 0));
+}
+
+NI static void ni_encrypt
+(
+	const kripto_block *s,
+	const void *pt,
+	void *ct
+)
+{
+	__m128i x;
+	unsigned int i;
+
+	x = _mm_xor_si128(_mm_loadu_si128((const __m128i *)pt), RK(s->k, 0));
+
+	for(i = 1; i < s->rounds; i++)
+		x = _mm_aesenc_si128(x, RK(s->k, i));
+
+	x = _mm_aesenclast_si128(x, RK(s->k, i));
+
+	_mm_storeu_si128((__m128i *)ct, x);
+}
+
+NI static void ni_decrypt
+(
+	const kripto_block *s,
+	const void *ct,
+	void *pt
+)
+{
+	__m128i x;
+	unsigned int i;
+
+	x = _mm_xor_si128(_mm_loadu_si128((const __m128i *)ct), RK(s->dk, 0));
+
+	for(i = 1; i < s->rounds; i++)
+		x = _mm_aesdec_si128(x, RK(s->dk, i));
+
+	x = _mm_aesdeclast_si128(x, RK(s->dk, i));
+
+	_mm_storeu_si128((__m128i *)pt, x);
+}
+
+#define NI_LOAD8(IN, K)							\
+{									\
+	x0 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(IN)), K);		\
+	x1 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(IN) + 1), K);	\
+	x2 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(IN) + 2), K);	\
+	x3 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(IN) + 3), K);	\
+	x4 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(IN) + 4), K);	\
+	x5 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(IN) + 5), K);	\
+	x6 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(IN) + 6), K);	\
+	x7 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(IN) + 7), K);	\
+}
+
+#define NI_ROUND8(F, K)		\
+{				\
+	x0 = F(x0, K);		\
+	x1 = F(x1, K);		\
+	x2 = F(x2, K);		\
+	x3 = F(x3, K);		\
+	x4 = F(x4, K);		\
+	x5 = F(x5, K);		\
+	x6 = F(x6, K);		\
+	x7 = F(x7, K);		\
+}
+
+#define NI_STORE8(OUT)					\
+{							\
+	_mm_storeu_si128((__m128i *)(OUT), x0);		\
+	_mm_storeu_si128((__m128i *)(OUT) + 1, x1);	\
+	_mm_storeu_si128((__m128i *)(OUT) + 2, x2);	\
+	_mm_storeu_si128((__m128i *)(OUT) + 3, x3);	\
+	_mm_storeu_si128((__m128i *)(OUT) + 4, x4);	\
+	_mm_storeu_si128((__m128i *)(OUT) + 5, x5);	\
+	_mm_storeu_si128((__m128i *)(OUT) + 6, x6);	\
+	_mm_storeu_si128((__m128i *)(OUT) + 7, x7);	\
+}
+
+/* 8 blocks in flight to hide AESENC/AESDEC latency */
+NI static void ni_encrypt_blocks
+(
+	const kripto_block *s,
+	const void *pt,
+	void *ct,
+	size_t blocks
+)
+{
+	__m128i x0;
+	__m128i x1;
+	__m128i x2;
+	__m128i x3;
+	__m128i x4;
+	__m128i x5;
+	__m128i x6;
+	__m128i x7;
+	__m128i k;
+	unsigned int i;
+
+	for(; blocks >= 8; blocks -= 8)
+	{
+		k = RK(s->k, 0);
+		NI_LOAD8(pt, k);
+
+		for(i = 1; i < s->rounds; i++)
+		{
+			k = RK(s->k, i);
+			NI_ROUND8(_mm_aesenc_si128, k);
+		}
+
+		k = RK(s->k, i);
+		NI_ROUND8(_mm_aesenclast_si128, k);
+		NI_STORE8(ct);
+
+		pt = CU8(pt) + 128;
+		ct = U8(ct) + 128;
+	}
+
+	for(; blocks; blocks--)
+	{
+		ni_encrypt(s, pt, ct);
+
+		pt = CU8(pt) + 16;
+		ct = U8(ct) + 16;
+	}
+}
+
+NI static void ni_decrypt_blocks
+(
+	const kripto_block *s,
+	const void *ct,
+	void *pt,
+	size_t blocks
+)
+{
+	__m128i x0;
+	__m128i x1;
+	__m128i x2;
+	__m128i x3;
+	__m128i x4;
+	__m128i x5;
+	__m128i x6;
+	__m128i x7;
+	__m128i k;
+	unsigned int i;
+
+	for(; blocks >= 8; blocks -= 8)
+	{
+		k = RK(s->dk, 0);
+		NI_LOAD8(ct, k);
+
+		for(i = 1; i < s->rounds; i++)
+		{
+			k = RK(s->dk, i);
+			NI_ROUND8(_mm_aesdec_si128, k);
+		}
+
+		k = RK(s->dk, i);
+		NI_ROUND8(_mm_aesdeclast_si128, k);
+		NI_STORE8(pt);
+
+		ct = CU8(ct) + 128;
+		pt = U8(pt) + 128;
+	}
+
+	for(; blocks; blocks--)
+	{
+		ni_decrypt(s, ct, pt);
+
+		ct = CU8(ct) + 16;
+		pt = U8(pt) + 16;
+	}
+}
+
+#define NI_MULTI8(F, R)				\
+{						\
+	x0 = F(x0, RK(s[0]->k, R));		\
+	x1 = F(x1, RK(s[1]->k, R));		\
+	x2 = F(x2, RK(s[2]->k, R));		\
+	x3 = F(x3, RK(s[3]->k, R));		\
+	x4 = F(x4, RK(s[4]->k, R));		\
+	x5 = F(x5, RK(s[5]->k, R));		\
+	x6 = F(x6, RK(s[6]->k, R));		\
+	x7 = F(x7, RK(s[7]->k, R));		\
+}
+
+/* one block under each of 8 keys with the same number of rounds */
+NI static void ni_encrypt_multi8
+(
+	const kripto_block *const *s,
+	const void *const *pt,
+	void *const *ct
+)
+{
+	__m128i x0;
+	__m128i x1;
+	__m128i x2;
+	__m128i x3;
+	__m128i x4;
+	__m128i x5;
+	__m128i x6;
+	__m128i x7;
+	unsigned int i;
+
+	x0 = _mm_loadu_si128((const __m128i *)pt[0]);
+	x1 = _mm_loadu_si128((const __m128i *)pt[1]);
+	x2 = _mm_loadu_si128((const __m128i *)pt[2]);
+	x3 = _mm_loadu_si128((const __m128i *)pt[3]);
+	x4 = _mm_loadu_si128((const __m128i *)pt[4]);
+	x5 = _mm_loadu_si128((const __m128i *)pt[5]);
+	x6 = _mm_loadu_si128((const __m128i *)pt[6]);
+	x7 = _mm_loadu_si128((const __m128i *)pt[7]);
+
+	NI_MULTI8(_mm_xor_si128, 0);
+
+	for(i = 1; i < s[0]->rounds; i++)
+		NI_MULTI8(_mm_aesenc_si128, i);
+
+	NI_MULTI8(_mm_aesenclast_si128, i);
+
+	_mm_storeu_si128((__m128i *)ct[0], x0);
+	_mm_storeu_si128((__m128i *)ct[1], x1);
+	_mm_storeu_si128((__m128i *)ct[2], x2);
+	_mm_storeu_si128((__m128i *)ct[3], x3);
+	_mm_storeu_si128((__m128i *)ct[4], x4);
+	_mm_storeu_si128((__m128i *)ct[5], x5);
+	_mm_storeu_si128((__m128i *)ct[6], x6);
+	_mm_storeu_si128((__m128i *)ct[7], x7);
+}
+
+#endif
+
 static void rijndael128_encrypt
 (
 	const kripto_block *s,
@@ -804,6 +1096,14 @@ static void rijndael128_encrypt
 	uint32_t t3;
 	unsigned int i;
 
+	#ifdef AESNI
+	if(s->ni)
+	{
+		ni_encrypt(s, pt, ct);
+		return;
+	}
+	#endif
+
 	x0 = LOAD32B(CU8(pt)) ^ s->k[0];
 	x1 = LOAD32B(CU8(pt) + 4) ^ s->k[1];
 	x2 = LOAD32B(CU8(pt) + 8) ^ s->k[2];
@@ -852,6 +1152,14 @@ static void rijndael128_decrypt
 	uint32_t t3;
 	unsigned int i;
 
+	#ifdef AESNI
+	if(s->ni)
+	{
+		ni_decrypt(s, ct, pt);
+		return;
+	}
+	#endif
+
 	x0 = LOAD32B(CU8(ct)) ^ s->dk[0];
 	x1 = LOAD32B(CU8(ct) + 4) ^ s->dk[1];
 	x2 = LOAD32B(CU8(ct) + 8) ^ s->dk[2];
@@ -883,6 +1191,112 @@ static void rijndael128_decrypt
 	STORE32B(t3, U8(pt) + 12);
 }
 
+static void rijndael128_encrypt_blocks
+(
+	const kripto_block *s,
+	const void *pt,
+	void *ct,
+	size_t blocks
+)
+{
+	#ifdef AESNI
+	if(s->ni)
+	{
+		ni_encrypt_blocks(s, pt, ct, blocks);
+		return;
+	}
+	#endif
+
+	for(; blocks; blocks--)
+	{
+		rijndael128_encrypt(s, pt, ct);
+
+		pt = CU8(pt) + 16;
+		ct = U8(ct) + 16;
+	}
+}
+
+static void rijndael128_decrypt_blocks
+(
+	const kripto_block *s,
+	const void *ct,
+	void *pt,
+	size_t blocks
+)
+{
+	#ifdef AESNI
+	if(s->ni)
+	{
+		ni_decrypt_blocks(s, ct, pt, blocks);
+		return;
+	}
+	#endif
+
+	for(; blocks; blocks--)
+	{
+		rijndael128_decrypt(s, ct, pt);
+
+		ct = CU8(ct) + 16;
+		pt = U8(pt) + 16;
+	}
+}
+
+static void rijndael128_encrypt_multi
+(
+	const kripto_block *const *s,
+	const void *const *pt,
+	void *const *ct,
+	unsigned int n
+)
+{
+	unsigned int i;
+
+	#ifdef AESNI
+	for(; n >= 8; n -= 8)
+	{
+		for(i = 0; i < 8; i++)
+			if(!s[i]->ni || s[i]->rounds != s[0]->rounds) break;
+
+		if(i == 8)
+		{
+			ni_encrypt_multi8(s, pt, ct);
+		}
+		else
+		{
+			for(i = 0; i < 8; i++)
+				rijndael128_encrypt(s[i], pt[i], ct[i]);
+		}
+
+		s += 8;
+		pt += 8;
+		ct += 8;
+	}
+	#endif
+
+	for(i = 0; i < n; i++)
+		rijndael128_encrypt(s[i], pt[i], ct[i]);
+}
+
+static void rijndael128_setup
+(
+	kripto_block *s,
+	const void *key,
+	unsigned int key_len
+)
+{
+	#ifdef AESNI
+	if(s->ni)
+	{
+		rijndael_setup(s, CU8(key), key_len, 16, &ni_sub_word);
+		ni_invert(s);
+		return;
+	}
+	#endif
+
+	rijndael_setup(s, CU8(key), key_len, 16, &sub_word);
+	rijndael_invert(s, 16);
+}
+
 static kripto_block *rijndael128_create
 (
 	const kripto_desc_block *desc,
@@ -899,7 +1313,7 @@ static kripto_block *rijndael128_create
 		if(r < 10) r = 10;
 	}
 
-	s = (kripto_block *)malloc(sizeof(kripto_block) + ((r + 1) << 5));
+	s = (kripto_block *)kripto_alloc(sizeof(kripto_block) + ((r + 1) << 5));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -907,7 +1321,14 @@ static kripto_block *rijndael128_create
 	s->k = (uint32_t *)(s + 1);
 	s->dk = s->k + ((r + 1) << 2);
 
-	rijndael_setup(s, (const uint8_t *)key, key_len, 16);
+	#ifdef AESNI
+	s->ni = (kripto_cpu() & (KRIPTO_CPU_SSE2 | KRIPTO_CPU_AESNI))
+		== (KRIPTO_CPU_SSE2 | KRIPTO_CPU_AESNI);
+	#else
+	s->ni = 0;
+	#endif
+
+	rijndael128_setup(s, key, key_len);
 
 	return s;
 }
@@ -915,7 +1336,7 @@ static kripto_block *rijndael128_create
 static void rijndael128_destroy(kripto_block *s)
 {
 	kripto_memory_wipe(s, sizeof(kripto_block) + ((s->rounds + 1) << 5));
-	free(s);
+	kripto_free(s);
 }
 
 static kripto_block *rijndael128_recreate
@@ -926,6 +1347,8 @@ static kripto_block *rijndael128_recreate
 	unsigned int key_len
 )
 {
+	const kripto_desc_block *desc = s->desc;
+
 	if(!r)
 	{
 		r = 6 + ((key_len + 3) >> 2);
@@ -935,11 +1358,11 @@ static kripto_block *rijndael128_recreate
 	if(r != s->rounds)
 	{
 		rijndael128_destroy(s);
-		s = rijndael128_create(s->desc, r, key, key_len);
+		s = rijndael128_create(desc, r, key, key_len);
 	}
 	else
 	{
-		rijndael_setup(s, (const uint8_t *)key, key_len, 16);
+		rijndael128_setup(s, key, key_len);
 	}
 
 	return s;
@@ -952,6 +1375,9 @@ static const kripto_desc_block rijndael128 =
 	0, /* tweak */
 	&rijndael128_encrypt,
 	&rijndael128_decrypt,
+	&rijndael128_encrypt_blocks,
+	&rijndael128_decrypt_blocks,
+	&rijndael128_encrypt_multi,
 	&rijndael128_destroy,
 	16, /* block size */
 	32, /* max key */
@@ -1132,15 +1558,17 @@ static kripto_block *rijndael256_create
 		if(r < 14) r = 14;
 	}
 
-	s = (kripto_block *)malloc(sizeof(kripto_block) + ((r + 1) << 6));
+	s = (kripto_block *)kripto_alloc(sizeof(kripto_block) + ((r + 1) << 6));
 	if(!s) return 0;
 
 	s->desc = desc;
 	s->rounds = r;
 	s->k = (uint32_t *)(s + 1);
 	s->dk = s->k + ((r + 1) << 3);
+	s->ni = 0;
 
-	rijndael_setup(s, (const uint8_t *)key, key_len, 32);
+	rijndael_setup(s, (const uint8_t *)key, key_len, 32, &sub_word);
+	rijndael_invert(s, 32);
 
 	return s;
 }
@@ -1148,7 +1576,7 @@ static kripto_block *rijndael256_create
 static void rijndael256_destroy(kripto_block *s)
 {
 	kripto_memory_wipe(s, sizeof(kripto_block) + ((s->rounds + 1) << 6));
-	free(s);
+	kripto_free(s);
 }
 
 static kripto_block *rijndael256_recreate
@@ -1159,6 +1587,8 @@ static kripto_block *rijndael256_recreate
 	unsigned int key_len
 )
 {
+	const kripto_desc_block *desc = s->desc;
+
 	if(!r)
 	{
 		r = 6 + ((key_len + 3) >> 2);
@@ -1168,11 +1598,12 @@ static kripto_block *rijndael256_recreate
 	if(r != s->rounds)
 	{
 		rijndael256_destroy(s);
-		s = rijndael256_create(s->desc, r, key, key_len);
+		s = rijndael256_create(desc, r, key, key_len);
 	}
 	else
 	{
-		rijndael_setup(s, (const uint8_t *)key, key_len, 32);
+		rijndael_setup(s, (const uint8_t *)key, key_len, 32, &sub_word);
+		rijndael_invert(s, 32);
 	}
 
 	return s;
@@ -1185,6 +1616,9 @@ static const kripto_desc_block rijndael256 =
 	0, /* tweak */
 	&rijndael256_encrypt,
 	&rijndael256_decrypt,
+	0, /* encrypt blocks */
+	0, /* decrypt blocks */
+	0, /* encrypt multi */
 	&rijndael256_destroy,
 	32, /* block size */
 	32, /* max key */
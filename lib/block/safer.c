@@ -28,6 +28,8 @@
 #include <kripto/block/safer.h>
 #include <kripto/block/safer_sk.h>
 
+#include "../alloc.h"
+
 struct kripto_block
 {
 	const kripto_desc_block *desc;
@@ -302,7 +304,7 @@ static void safer_setup
 static void safer_destroy(kripto_block *s)
 {
 	kripto_memory_wipe(s, sizeof(kripto_block) + (s->rounds << 4) + 8);
-	free(s);
+	kripto_free(s);
 }
 
 static kripto_block *safer_create
@@ -321,7 +323,7 @@ static kripto_block *safer_create
 		else r = 6;
 	}
 
-	s = (kripto_block *)malloc(sizeof(kripto_block) + (r << 4) + 8);
+	s = (kripto_block *)kripto_alloc(sizeof(kripto_block) + (r << 4) + 8);
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -341,6 +343,8 @@ static kripto_block *safer_recreate
 	unsigned int key_len
 )
 {
+	const kripto_desc_block *desc = s->desc;
+
 	if(!r)
 	{
 		r = key_len > 8 ? 10 : 6;
@@ -349,7 +353,7 @@ static kripto_block *safer_recreate
 	if(r != s->rounds)
 	{
 		safer_destroy(s);
-		s = safer_create(s->desc, r, key, key_len);
+		s = safer_create(desc, r, key, key_len);
 	}
 	else
 	{
@@ -374,7 +378,7 @@ static kripto_block *safer_sk_create
 		r = key_len > 8 ? 10 : 6;
 	}
 
-	s = (kripto_block *)malloc(sizeof(kripto_block) + (r << 4) + 8);
+	s = (kripto_block *)kripto_alloc(sizeof(kripto_block) + (r << 4) + 8);
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -394,6 +398,8 @@ static kripto_block *safer_sk_recreate
 	unsigned int key_len
 )
 {
+	const kripto_desc_block *desc = s->desc;
+
 	if(!r)
 	{
 		r = key_len > 8 ? 10 : 6;
@@ -402,7 +408,7 @@ static kripto_block *safer_sk_recreate
 	if(r != s->rounds)
 	{
 		safer_destroy(s);
-		s = safer_sk_create(s->desc, r, key, key_len);
+		s = safer_sk_create(desc, r, key, key_len);
 	}
 	else
 	{
@@ -419,6 +425,9 @@ static const kripto_desc_block safer =
 	0, /* tweak */
 	&safer_encrypt,
 	&safer_decrypt,
+	0, /* encrypt blocks */
+	0, /* decrypt blocks */
+	0, /* encrypt multi */
 	&safer_destroy,
 	8, /* block size */
 	16, /* max key */
@@ -432,6 +441,9 @@ static const kripto_desc_block safer_sk =
 	0, /* tweak */
 	&safer_encrypt,
 	&safer_decrypt,
+	0, /* encrypt blocks */
+	0, /* decrypt blocks */
+	0, /* encrypt multi */
 	&safer_destroy,
 	8, /* block size */
 	16, /* max key */
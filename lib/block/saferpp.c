@@ -25,6 +25,8 @@
 
 #include <kripto/block/saferpp.h>
 
+#include "../alloc.h"
+
 struct kripto_block
 {
 	const kripto_desc_block *desc;
@@ -363,7 +365,7 @@ static void saferpp_setup
 static void saferpp_destroy(kripto_block *s)
 {
 	kripto_memory_wipe(s, sizeof(kripto_block) + (s->rounds << 5) + 16);
-	free(s);
+	kripto_free(s);
 }
 
 static kripto_block *saferpp_create
@@ -382,7 +384,7 @@ static kripto_block *saferpp_create
 		else r = 7;
 	}
 
-	s = (kripto_block *)malloc(sizeof(kripto_block) + (r << 5) + 16);
+	s = (kripto_block *)kripto_alloc(sizeof(kripto_block) + (r << 5) + 16);
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -402,6 +404,8 @@ static kripto_block *saferpp_recreate
 	unsigned int key_len
 )
 {
+	const kripto_desc_block *desc = s->desc;
+
 	if(!r)
 	{
 		if(key_len > 16) r = 10;
@@ -411,7 +415,7 @@ static kripto_block *saferpp_recreate
 	if(r != s->rounds)
 	{
 		saferpp_destroy(s);
-		s = saferpp_create(s->desc, r, key, key_len);
+		s = saferpp_create(desc, r, key, key_len);
 	}
 	else
 	{
@@ -428,6 +432,9 @@ static const kripto_desc_block saferpp =
 	0, /* tweak */
 	&saferpp_encrypt,
 	&saferpp_decrypt,
+	0, /* encrypt blocks */
+	0, /* decrypt blocks */
+	0, /* encrypt multi */
 	&saferpp_destroy,
 	16, /* block size */
 	32, /* max key */
@@ -25,6 +25,8 @@
 
 #include <kripto/block/seed.h>
 
+#include "../alloc.h"
+
 struct kripto_block
 {
 	const kripto_desc_block *desc;
@@ -427,7 +429,7 @@ static kripto_block *seed_create
 
 	if(!r) r = 16;
 
-	s = (kripto_block *)malloc(sizeof(kripto_block) + (r << 3));
+	s = (kripto_block *)kripto_alloc(sizeof(kripto_block) + (r << 3));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -442,7 +444,7 @@ static kripto_block *seed_create
 static void seed_destroy(kripto_block *s)
 {
 	kripto_memory_wipe(s, sizeof(kripto_block) + (s->rounds << 3));
-	free(s);
+	kripto_free(s);
 }
 
 static kripto_block *seed_recreate
@@ -453,12 +455,14 @@ static kripto_block *seed_recreate
 	unsigned int key_len
 )
 {
+	const kripto_desc_block *desc = s->desc;
+
 	if(!r) r = 16;
 
 	if(r != s->rounds)
 	{
 		seed_destroy(s);
-		s = seed_create(s->desc, r, key, key_len);
+		s = seed_create(desc, r, key, key_len);
 	}
 	else
 	{
@@ -475,6 +479,9 @@ static const kripto_desc_block seed =
 	0, /* tweak */
 	&seed_encrypt,
 	&seed_decrypt,
+	0, /* encrypt blocks */
+	0, /* decrypt blocks */
+	0, /* encrypt multi */
 	&seed_destroy,
 	16, /* block size */
 	16, /* max key */
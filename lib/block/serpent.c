@@ -29,6 +29,8 @@
 
 #include <kripto/block/serpent.h>
 
+#include "../alloc.h"
+
 struct kripto_block
 {
 	const kripto_desc_block *desc;
@@ -677,7 +679,7 @@ static kripto_block *serpent_create
 
 	if(!r) r = 32;
 
-	s = (kripto_block *)malloc(sizeof(kripto_block) + ((r + 1) << 4));
+	s = (kripto_block *)kripto_alloc(sizeof(kripto_block) + ((r + 1) << 4));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -692,7 +694,7 @@ static kripto_block *serpent_create
 static void serpent_destroy(kripto_block *s)
 {
 	kripto_memory_wipe(s, sizeof(kripto_block) + ((s->rounds + 1) << 4));
-	free(s);
+	kripto_free(s);
 }
 
 static kripto_block *serpent_recreate
@@ -703,12 +705,14 @@ static kripto_block *serpent_recreate
 	unsigned int key_len
 )
 {
+	const kripto_desc_block *desc = s->desc;
+
 	if(!r) r = 32;
 
 	if(r != s->rounds)
 	{
 		serpent_destroy(s);
-		s = serpent_create(s->desc, r, key, key_len);
+		s = serpent_create(desc, r, key, key_len);
 	}
 	else
 	{
@@ -725,6 +729,9 @@ static const kripto_desc_block serpent =
 	0, /* tweak */
 	&serpent_encrypt,
 	&serpent_decrypt,
+	0, /* encrypt blocks */
+	0, /* decrypt blocks */
+	0, /* encrypt multi */
 	&serpent_destroy,
 	16, /* block size */
 	32, /* max key */
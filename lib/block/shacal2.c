@@ -28,6 +28,8 @@
 
 #include <kripto/block/shacal2.h>
 
+#include "../alloc.h"
+
 struct kripto_block
 {
 	const kripto_desc_block *desc;
@@ -203,7 +205,7 @@ static kripto_block *shacal2_create
 
 	if(!r) r = 64;
 
-	kripto_block *s = (kripto_block *)malloc(sizeof(kripto_block) + (r << 2));
+	kripto_block *s = (kripto_block *)kripto_alloc(sizeof(kripto_block) + (r << 2));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -217,7 +219,7 @@ static kripto_block *shacal2_create
 static void shacal2_destroy(kripto_block *s)
 {
 	kripto_memory_wipe(s, sizeof(kripto_block) + (s->r << 2));
-	free(s);
+	kripto_free(s);
 }
 
 static kripto_block *shacal2_recreate
@@ -228,6 +230,8 @@ static kripto_block *shacal2_recreate
 	unsigned int key_len
 )
 {
+	const kripto_desc_block *desc = s->desc;
+
 	assert(r < 128);
 
 	if(!r) r = 64;
@@ -235,7 +239,7 @@ static kripto_block *shacal2_recreate
 	if(r != s->r)
 	{
 		shacal2_destroy(s);
-		s = shacal2_create(s->desc, r, key, key_len);
+		s = shacal2_create(desc, r, key, key_len);
 	}
 	else
 	{
@@ -252,6 +256,9 @@ static const kripto_desc_block shacal2 =
 	0, /* tweak */
 	&shacal2_encrypt,
 	&shacal2_decrypt,
+	0, /* encrypt blocks */
+	0, /* decrypt blocks */
+	0, /* encrypt multi */
 	&shacal2_destroy,
 	32, /* block size */
 	64, /* max key */
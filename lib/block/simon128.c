@@ -25,6 +25,8 @@
 
 #include <kripto/block/simon128.h>
 
+#include "../alloc.h"
+
 struct kripto_block
 {
 	const kripto_desc_block *desc;
@@ -144,7 +146,7 @@ static kripto_block *simon128_create
 		}
 	}
 
-	s = (kripto_block *)malloc(sizeof(kripto_block) + (r << 3));
+	s = (kripto_block *)kripto_alloc(sizeof(kripto_block) + (r << 3));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -159,7 +161,7 @@ static kripto_block *simon128_create
 static void simon128_destroy(kripto_block *s)
 {
 	kripto_memory_wipe(s, sizeof(kripto_block) + (s->rounds << 3));
-	free(s);
+	kripto_free(s);
 }
 
 static kripto_block *simon128_recreate
@@ -170,6 +172,8 @@ static kripto_block *simon128_recreate
 	unsigned int key_len
 )
 {
+	const kripto_desc_block *desc = s->desc;
+
 	if(!r)
 	{
 		switch((key_len + 7) >> 3)
@@ -183,7 +187,7 @@ static kripto_block *simon128_recreate
 	if(r != s->rounds)
 	{
 		simon128_destroy(s);
-		s = simon128_create(s->desc, r, key, key_len);
+		s = simon128_create(desc, r, key, key_len);
 	}
 	else
 	{
@@ -200,6 +204,9 @@ static const kripto_desc_block simon128 =
 	0, /* tweak */
 	&simon128_encrypt,
 	&simon128_decrypt,
+	0, /* encrypt blocks */
+	0, /* decrypt blocks */
+	0, /* encrypt multi */
 	&simon128_destroy,
 	16, /* block size */
 	32, /* max key */
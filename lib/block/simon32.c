@@ -25,6 +25,8 @@
 
 #include <kripto/block/simon32.h>
 
+#include "../alloc.h"
+
 struct kripto_block
 {
 	const kripto_desc_block *desc;
@@ -124,7 +126,7 @@ static kripto_block *simon32_create
 
 	if(!r) r = 32;
 
-	s = (kripto_block *)malloc(sizeof(kripto_block) + (r << 1));
+	s = (kripto_block *)kripto_alloc(sizeof(kripto_block) + (r << 1));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -139,7 +141,7 @@ static kripto_block *simon32_create
 static void simon32_destroy(kripto_block *s)
 {
 	kripto_memory_wipe(s, sizeof(kripto_block) + (s->rounds << 1));
-	free(s);
+	kripto_free(s);
 }
 
 static kripto_block *simon32_recreate
@@ -150,12 +152,14 @@ static kripto_block *simon32_recreate
 	unsigned int key_len
 )
 {
+	const kripto_desc_block *desc = s->desc;
+
 	if(!r) r = 32;
 
 	if(r != s->rounds)
 	{
 		simon32_destroy(s);
-		s = simon32_create(s->desc, r, key, key_len);
+		s = simon32_create(desc, r, key, key_len);
 	}
 	else
 	{
@@ -172,6 +176,9 @@ static const kripto_desc_block simon32 =
 	0, /* tweak */
 	&simon32_encrypt,
 	&simon32_decrypt,
+	0, /* encrypt blocks */
+	0, /* decrypt blocks */
+	0, /* encrypt multi */
 	&simon32_destroy,
 	4, /* block size */
 	8, /* max key */
@@ -25,6 +25,8 @@
 
 #include <kripto/block/simon64.h>
 
+#include "../alloc.h"
+
 struct kripto_block
 {
 	const kripto_desc_block *desc;
@@ -135,7 +137,7 @@ static kripto_block *simon64_create
 
 	if(!r) r = 36 + (((key_len + 3) >> 2) << 1);
 
-	s = (kripto_block *)malloc(sizeof(kripto_block) + (r << 2));
+	s = (kripto_block *)kripto_alloc(sizeof(kripto_block) + (r << 2));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -150,7 +152,7 @@ static kripto_block *simon64_create
 static void simon64_destroy(kripto_block *s)
 {
 	kripto_memory_wipe(s, sizeof(kripto_block) + (s->rounds << 2));
-	free(s);
+	kripto_free(s);
 }
 
 static kripto_block *simon64_recreate
@@ -161,12 +163,14 @@ static kripto_block *simon64_recreate
 	unsigned int key_len
 )
 {
+	const kripto_desc_block *desc = s->desc;
+
 	if(!r) r = 36 + (((key_len + 3) >> 2) << 1);
 
 	if(r != s->rounds)
 	{
 		simon64_destroy(s);
-		s = simon64_create(s->desc, r, key, key_len);
+		s = simon64_create(desc, r, key, key_len);
 	}
 	else
 	{
@@ -183,6 +187,9 @@ static const kripto_desc_block simon64 =
 	0, /* tweak */
 	&simon64_encrypt,
 	&simon64_decrypt,
+	0, /* encrypt blocks */
+	0, /* decrypt blocks */
+	0, /* encrypt multi */
 	&simon64_destroy,
 	8, /* block size */
 	16, /* max key */
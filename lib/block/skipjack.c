@@ -26,6 +26,8 @@
 
 #include <kripto/block/skipjack.h>
 
+#include "../alloc.h"
+
 struct kripto_block
 {
 	const kripto_desc_block *desc;
@@ -222,7 +224,7 @@ static kripto_block *skipjack_create
 	unsigned int key_len
 )
 {
-	kripto_block *s = (kripto_block *)malloc(sizeof(kripto_block));
+	kripto_block *s = (kripto_block *)kripto_alloc(sizeof(kripto_block));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -233,7 +235,7 @@ static kripto_block *skipjack_create
 static void skipjack_destroy(kripto_block *s)
 {
 	kripto_memory_wipe(s, sizeof(kripto_block));
-	free(s);
+	kripto_free(s);
 }
 
 static const kripto_desc_block skipjack =
@@ -243,6 +245,9 @@ static const kripto_desc_block skipjack =
 	0, /* tweak */
 	&skipjack_encrypt,
 	&skipjack_decrypt,
+	0, /* encrypt blocks */
+	0, /* decrypt blocks */
+	0, /* encrypt multi */
 	&skipjack_destroy,
 	8, /* block size */
 	10, /* max key */
@@ -26,6 +26,8 @@
 
 #include <kripto/block/sm4.h>
 
+#include "../alloc.h"
+
 struct kripto_block
 {
 	const kripto_desc_block *desc;
@@ -193,7 +195,7 @@ static kripto_block *sm4_create
 {
 	if(!r) r = 32;
 
-	kripto_block *s = (kripto_block *)malloc(sizeof(kripto_block) + (r << 2));
+	kripto_block *s = (kripto_block *)kripto_alloc(sizeof(kripto_block) + (r << 2));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -207,7 +209,7 @@ static kripto_block *sm4_create
 static void sm4_destroy(kripto_block *s)
 {
 	kripto_memory_wipe(s, sizeof(kripto_block) + (s->r << 2));
-	free(s);
+	kripto_free(s);
 }
 
 static kripto_block *sm4_recreate
@@ -218,12 +220,14 @@ static kripto_block *sm4_recreate
 	unsigned int key_len
 )
 {
+	const kripto_desc_block *desc = s->desc;
+
 	if(!r) r = 32;
 
 	if(r != s->r)
 	{
 		sm4_destroy(s);
-		s = sm4_create(s->desc, r, key, key_len);
+		s = sm4_create(desc, r, key, key_len);
 	}
 	else
 	{
@@ -240,6 +244,9 @@ static const kripto_desc_block sm4 =
 	0, /* tweak */
 	&sm4_encrypt,
 	&sm4_decrypt,
+	0, /* encrypt blocks */
+	0, /* decrypt blocks */
+	0, /* encrypt multi */
 	&sm4_destroy,
 	16, /* block size */
 	16, /* max key */
@@ -25,6 +25,8 @@
 
 #include <kripto/block/speck128.h>
 
+#include "../alloc.h"
+
 struct kripto_block
 {
 	const kripto_desc_block *desc;
@@ -114,7 +116,7 @@ static kripto_block *speck128_create
 
 	if(!r) r = 30 + ((key_len + 7) >> 3);
 
-	s = (kripto_block *)malloc(sizeof(kripto_block) + (r << 3));
+	s = (kripto_block *)kripto_alloc(sizeof(kripto_block) + (r << 3));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -129,7 +131,7 @@ static kripto_block *speck128_create
 static void speck128_destroy(kripto_block *s)
 {
 	kripto_memory_wipe(s, sizeof(kripto_block) + (s->rounds << 3));
-	free(s);
+	kripto_free(s);
 }
 
 static kripto_block *speck128_recreate
@@ -140,12 +142,14 @@ static kripto_block *speck128_recreate
 	unsigned int key_len
 )
 {
+	const kripto_desc_block *desc = s->desc;
+
 	if(!r) r = 30 + ((key_len + 7) >> 3);
 
 	if(r != s->rounds)
 	{
 		speck128_destroy(s);
-		s = speck128_create(s->desc, r, key, key_len);
+		s = speck128_create(desc, r, key, key_len);
 	}
 	else
 	{
@@ -162,6 +166,9 @@ static const kripto_desc_block speck128 =
 	0, /* tweak */
 	&speck128_encrypt,
 	&speck128_decrypt,
+	0, /* encrypt blocks */
+	0, /* decrypt blocks */
+	0, /* encrypt multi */
 	&speck128_destroy,
 	16, /* block size */
 	32, /* max key */
@@ -25,6 +25,8 @@
 
 #include <kripto/block/speck32.h>
 
+#include "../alloc.h"
+
 struct kripto_block
 {
 	const kripto_desc_block *desc;
@@ -114,7 +116,7 @@ static kripto_block *speck32_create
 
 	if(!r) r = 22;
 
-	s = (kripto_block *)malloc(sizeof(kripto_block) + (r << 1));
+	s = (kripto_block *)kripto_alloc(sizeof(kripto_block) + (r << 1));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -129,7 +131,7 @@ static kripto_block *speck32_create
 static void speck32_destroy(kripto_block *s)
 {
 	kripto_memory_wipe(s, sizeof(kripto_block) + (s->rounds << 1));
-	free(s);
+	kripto_free(s);
 }
 
 static kripto_block *speck32_recreate
@@ -140,12 +142,14 @@ static kripto_block *speck32_recreate
 	unsigned int key_len
 )
 {
+	const kripto_desc_block *desc = s->desc;
+
 	if(!r) r = 22;
 
 	if(r != s->rounds)
 	{
 		speck32_destroy(s);
-		s = speck32_create(s->desc, r, key, key_len);
+		s = speck32_create(desc, r, key, key_len);
 	}
 	else
 	{
@@ -162,6 +166,9 @@ static const kripto_desc_block speck32 =
 	0, /* tweak */
 	&speck32_encrypt,
 	&speck32_decrypt,
+	0, /* encrypt blocks */
+	0, /* decrypt blocks */
+	0, /* encrypt multi */
 	&speck32_destroy,
 	4, /* block size */
 	8, /* max key */
@@ -25,6 +25,8 @@
 
 #include <kripto/block/speck64.h>
 
+#include "../alloc.h"
+
 struct kripto_block
 {
 	const kripto_desc_block *desc;
@@ -114,7 +116,7 @@ static kripto_block *speck64_create
 
 	if(!r) r = 23 + ((key_len + 3) >> 2);
 
-	s = (kripto_block *)malloc(sizeof(kripto_block) + (r << 2));
+	s = (kripto_block *)kripto_alloc(sizeof(kripto_block) + (r << 2));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -129,7 +131,7 @@ static kripto_block *speck64_create
 static void speck64_destroy(kripto_block *s)
 {
 	kripto_memory_wipe(s, sizeof(kripto_block) + (s->rounds << 2));
-	free(s);
+	kripto_free(s);
 }
 
 static kripto_block *speck64_recreate
@@ -140,12 +142,14 @@ static kripto_block *speck64_recreate
 	unsigned int key_len
 )
 {
+	const kripto_desc_block *desc = s->desc;
+
 	if(!r) r = 23 + ((key_len + 3) >> 2);
 
 	if(r != s->rounds)
 	{
 		speck64_destroy(s);
-		s = speck64_create(s->desc, r, key, key_len);
+		s = speck64_create(desc, r, key, key_len);
 	}
 	else
 	{
@@ -162,6 +166,9 @@ static const kripto_desc_block speck64 =
 	0, /* tweak */
 	&speck64_encrypt,
 	&speck64_decrypt,
+	0, /* encrypt blocks */
+	0, /* decrypt blocks */
+	0, /* encrypt multi */
 	&speck64_destroy,
 	8, /* block size */
 	16, /* max key */
@@ -25,6 +25,8 @@
 
 #include <kripto/block/tea.h>
 
+#include "../alloc.h"
+
 struct kripto_block
 {
 	const kripto_desc_block *desc;
@@ -92,7 +94,7 @@ static kripto_block *tea_create
 	unsigned int key_len
 )
 {
-	kripto_block *s = (kripto_block *)malloc(sizeof(kripto_block));
+	kripto_block *s = (kripto_block *)kripto_alloc(sizeof(kripto_block));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -103,7 +105,7 @@ static kripto_block *tea_create
 static void tea_destroy(kripto_block *s)
 {
 	kripto_memory_wipe(s, sizeof(kripto_block));
-	free(s);
+	kripto_free(s);
 }
 
 static const kripto_desc_block tea =
@@ -113,6 +115,9 @@ static const kripto_desc_block tea =
 	0, /* tweak */
 	&tea_encrypt,
 	&tea_decrypt,
+	0, /* encrypt blocks */
+	0, /* decrypt blocks */
+	0, /* encrypt multi */
 	&tea_destroy,
 	8, /* block size */
 	16, /* max key */
@@ -27,6 +27,8 @@
 
 #include <kripto/block/threefish1024.h>
 
+#include "../alloc.h"
+
 #define C240 0x1BD11BDAA9FC1A22
 
 struct kripto_block
@@ -405,7 +407,7 @@ static kripto_block *threefish1024_create
 	unsigned int key_len
 )
 {
-	kripto_block *s = (kripto_block *)malloc(sizeof(kripto_block));
+	kripto_block *s = (kripto_block *)kripto_alloc(sizeof(kripto_block));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -416,7 +418,7 @@ static kripto_block *threefish1024_create
 static void threefish1024_destroy(kripto_block *s)
 {
 	kripto_memory_wipe(s, sizeof(kripto_block));
-	free(s);
+	kripto_free(s);
 }
 
 static const kripto_desc_block threefish1024 =
@@ -426,6 +428,9 @@ static const kripto_desc_block threefish1024 =
 	&threefish1024_tweak,
 	&threefish1024_encrypt,
 	&threefish1024_decrypt,
+	0, /* encrypt blocks */
+	0, /* decrypt blocks */
+	0, /* encrypt multi */
 	&threefish1024_destroy,
 	128, /* block size */
 	128, /* max key */
@@ -26,6 +26,8 @@
 
 #include <kripto/block/threefish256.h>
 
+#include "../alloc.h"
+
 #define C240 0x1BD11BDAA9FC1A22
 
 struct kripto_block
@@ -197,7 +199,7 @@ static kripto_block *threefish256_create
 	unsigned int key_len
 )
 {
-	kripto_block *s = (kripto_block *)malloc(sizeof(kripto_block));
+	kripto_block *s = (kripto_block *)kripto_alloc(sizeof(kripto_block));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -208,7 +210,7 @@ static kripto_block *threefish256_create
 static void threefish256_destroy(kripto_block *s)
 {
 	kripto_memory_wipe(s, sizeof(kripto_block));
-	free(s);
+	kripto_free(s);
 }
 
 static const kripto_desc_block threefish256 =
@@ -218,6 +220,9 @@ static const kripto_desc_block threefish256 =
 	&threefish256_tweak,
 	&threefish256_encrypt,
 	&threefish256_decrypt,
+	0, /* encrypt blocks */
+	0, /* decrypt blocks */
+	0, /* encrypt multi */
 	&threefish256_destroy,
 	32, /* block size */
 	32, /* max key */
@@ -26,6 +26,8 @@
 
 #include <kripto/block/threefish512.h>
 
+#include "../alloc.h"
+
 #define C240 0x1BD11BDAA9FC1A22
 
 struct kripto_block
@@ -266,7 +268,7 @@ static kripto_block *threefish512_create
 	unsigned int key_len
 )
 {
-	kripto_block *s = (kripto_block *)malloc(sizeof(kripto_block));
+	kripto_block *s = (kripto_block *)kripto_alloc(sizeof(kripto_block));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -277,7 +279,7 @@ static kripto_block *threefish512_create
 static void threefish512_destroy(kripto_block *s)
 {
 	kripto_memory_wipe(s, sizeof(kripto_block));
-	free(s);
+	kripto_free(s);
 }
 
 static const kripto_desc_block threefish512 =
@@ -287,6 +289,9 @@ static const kripto_desc_block threefish512 =
 	&threefish512_tweak,
 	&threefish512_encrypt,
 	&threefish512_decrypt,
+	0, /* encrypt blocks */
+	0, /* decrypt blocks */
+	0, /* encrypt multi */
 	&threefish512_destroy,
 	64, /* block size */
 	64, /* max key */
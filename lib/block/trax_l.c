@@ -25,6 +25,8 @@
 
 #include <kripto/block/trax_l.h>
 
+#include "../alloc.h"
+
 struct kripto_block
 {
 	const kripto_desc_block *desc;
@@ -257,7 +259,7 @@ static kripto_block *trax_l_create
 {
 	if(!r) r = 17;
 
-	kripto_block *s = (kripto_block *)malloc(sizeof(kripto_block) + ((r + 1) << 5));
+	kripto_block *s = (kripto_block *)kripto_alloc(sizeof(kripto_block) + ((r + 1) << 5));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -272,7 +274,7 @@ static kripto_block *trax_l_create
 static void trax_l_destroy(kripto_block *s)
 {
 	kripto_memory_wipe(s, sizeof(kripto_block) + ((s->steps + 1) << 5));
-	free(s);
+	kripto_free(s);
 }
 
 static kripto_block *trax_l_recreate
@@ -283,12 +285,14 @@ static kripto_block *trax_l_recreate
 	unsigned int key_len
 )
 {
+	const kripto_desc_block *desc = s->desc;
+
 	if(!r) r = 17;
 
 	if(r != s->steps)
 	{
 		trax_l_destroy(s);
-		s = trax_l_create(s->desc, r, key, key_len);
+		s = trax_l_create(desc, r, key, key_len);
 	}
 	else
 	{
@@ -25,6 +25,8 @@
 
 #include <kripto/block/trax_m.h>
 
+#include "../alloc.h"
+
 struct kripto_block
 {
 	const kripto_desc_block *desc;
@@ -189,7 +191,7 @@ static kripto_block *trax_m_create
 {
 	if(!r) r = 14;
 
-	kripto_block *s = (kripto_block *)malloc(sizeof(kripto_block) + ((r + 1) << 4));
+	kripto_block *s = (kripto_block *)kripto_alloc(sizeof(kripto_block) + ((r + 1) << 4));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -204,7 +206,7 @@ static kripto_block *trax_m_create
 static void trax_m_destroy(kripto_block *s)
 {
 	kripto_memory_wipe(s, sizeof(kripto_block) + ((s->steps + 1) << 4));
-	free(s);
+	kripto_free(s);
 }
 
 static kripto_block *trax_m_recreate
@@ -215,12 +217,14 @@ static kripto_block *trax_m_recreate
 	unsigned int key_len
 )
 {
+	const kripto_desc_block *desc = s->desc;
+
 	if(!r) r = 14;
 
 	if(r != s->steps)
 	{
 		trax_m_destroy(s);
-		s = trax_m_create(s->desc, r, key, key_len);
+		s = trax_m_create(desc, r, key, key_len);
 	}
 	else
 	{
@@ -27,6 +27,8 @@
 
 #include <kripto/block/twofish.h>
 
+#include "../alloc.h"
+
 struct kripto_block
 {
 	const kripto_desc_block *desc;
@@ -1194,7 +1196,7 @@ static kripto_block *twofish_create
 
 	if(!r) r = 16;
 
-	s = (kripto_block *)malloc(sizeof(kripto_block) + (TWOFISH_K_LEN(r) << 2));
+	s = (kripto_block *)kripto_alloc(sizeof(kripto_block) + (TWOFISH_K_LEN(r) << 2));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -1209,7 +1211,7 @@ static kripto_block *twofish_create
 static void twofish_destroy(kripto_block *s)
 {
 	kripto_memory_wipe(s, sizeof(kripto_block) + (TWOFISH_K_LEN(s->rounds) << 2));
-	free(s);
+	kripto_free(s);
 }
 
 static kripto_block *twofish_recreate
@@ -1220,12 +1222,14 @@ static kripto_block *twofish_recreate
 	unsigned int key_len
 )
 {
+	const kripto_desc_block *desc = s->desc;
+
 	if(!r) r = 16;
 
 	if(r != s->rounds)
 	{
 		twofish_destroy(s);
-		s = twofish_create(s->desc, r, key, key_len);
+		s = twofish_create(desc, r, key, key_len);
 	}
 	else
 	{
@@ -1242,6 +1246,9 @@ static const kripto_desc_block twofish =
 	0, /* tweak */
 	&twofish_encrypt,
 	&twofish_decrypt,
+	0, /* encrypt blocks */
+	0, /* decrypt blocks */
+	0, /* encrypt multi */
 	&twofish_destroy,
 	16, /* block size */
 	32, /* max key */
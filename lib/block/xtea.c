@@ -27,6 +27,8 @@
 
 #include <kripto/block/xtea.h>
 
+#include "../alloc.h"
+
 struct kripto_block
 {
 	const kripto_desc_block *desc;
@@ -112,7 +114,7 @@ static kripto_block *xtea_create
 
 	if(!r) r = 64;
 
-	s = (kripto_block *)malloc(sizeof(kripto_block) + (r << 2));
+	s = (kripto_block *)kripto_alloc(sizeof(kripto_block) + (r << 2));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -127,7 +129,7 @@ static kripto_block *xtea_create
 static void xtea_destroy(kripto_block *s)
 {
 	kripto_memory_wipe(s, sizeof(kripto_block) + (s->rounds << 2));
-	free(s);
+	kripto_free(s);
 }
 
 static kripto_block *xtea_recreate
@@ -138,12 +140,14 @@ static kripto_block *xtea_recreate
 	unsigned int key_len
 )
 {
+	const kripto_desc_block *desc = s->desc;
+
 	if(!r) r = 64;
 
 	if(r != s->rounds)
 	{
 		xtea_destroy(s);
-		s = xtea_create(s->desc, r, key, key_len);
+		s = xtea_create(desc, r, key, key_len);
 	}
 	else
 	{
@@ -160,6 +164,9 @@ static const kripto_desc_block xtea =
 	0, /* tweak */
 	&xtea_encrypt,
 	&xtea_decrypt,
+	0, /* encrypt blocks */
+	0, /* decrypt blocks */
+	0, /* encrypt multi */
 	&xtea_destroy,
 	8, /* block size */
 	16, /* max key */
@@ -0,0 +1,193 @@
+/*
+ * Copyright (C) 2026 by Gregor Pintar <grpintar@gmail.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/*
+ * Implementations pick their kernel at create time from kripto_cpu().
+ * Features can be masked with kripto_cpu_set() or with the KRIPTO_CPU
+ * environment variable, a comma separated list of feature names
+ * (e.g. "sse2,aesni"). "portable" (or an empty list) disables all.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if (defined(__GNUC__) || defined(__clang__)) \
+&& (defined(__i386__) || defined(__x86_64__))
+#define X86
+#include <cpuid.h>
+#endif
+
+#include <kripto/cpu.h>
+
+#include "thread.h"
+
+static const struct
+{
+	const char *name;
+	unsigned int feature;
+} names[] =
+{
+	{"sse2", KRIPTO_CPU_SSE2},
+	{"ssse3", KRIPTO_CPU_SSSE3},
+	{"sse4.1", KRIPTO_CPU_SSE41},
+	{"avx2", KRIPTO_CPU_AVX2},
+	{"avx512", KRIPTO_CPU_AVX512},
+	{"aesni", KRIPTO_CPU_AESNI},
+	{"pclmul", KRIPTO_CPU_PCLMUL},
+	{"shani", KRIPTO_CPU_SHANI},
+	{"gfni", KRIPTO_CPU_GFNI},
+	{"vaes", KRIPTO_CPU_VAES}
+};
+
+static unsigned int detected;
+static unsigned int enabled;
+
+/* first call from any thread detects, the others wait for it */
+#ifdef KRIPTO_THREADS
+static pthread_once_t once = PTHREAD_ONCE_INIT;
+#else
+static int init = 0;
+#endif
+
+#ifdef X86
+
+static unsigned int xgetbv(void)
+{
+	unsigned int a;
+	unsigned int d;
+
+	__asm__ ("xgetbv" : "=a" (a), "=d" (d) : "c" (0));
+
+	return a;
+}
+
+static unsigned int x86_detect(void)
+{
+	unsigned int a;
+	unsigned int b;
+	unsigned int c;
+	unsigned int d;
+	unsigned int xcr0 = 0;
+	unsigned int f = 0;
+
+	if(!__get_cpuid(1, &a, &b, &c, &d)) return 0;
+
+	if(d & bit_SSE2) f |= KRIPTO_CPU_SSE2;
+	if(c & bit_SSSE3) f |= KRIPTO_CPU_SSSE3;
+	if(c & bit_SSE4_1) f |= KRIPTO_CPU_SSE41;
+	if(c & bit_AES) f |= KRIPTO_CPU_AESNI;
+	if(c & bit_PCLMUL) f |= KRIPTO_CPU_PCLMUL;
+
+	/* OS must save YMM/ZMM state */
+	if(c & bit_OSXSAVE) xcr0 = xgetbv();
+
+	if(__get_cpuid_max(0, 0) < 7) return f;
+
+	__cpuid_count(7, 0, a, b, c, d);
+
+	if((b & bit_AVX2) && (xcr0 & 0x06) == 0x06)
+	{
+		f |= KRIPTO_CPU_AVX2;
+
+		if((b & bit_AVX512F) && (b & bit_AVX512BW) && (b & bit_AVX512VL)
+		&& (xcr0 & 0xE0) == 0xE0)
+		{
+			f |= KRIPTO_CPU_AVX512;
+		}
+
+		if(c & bit_VAES) f |= KRIPTO_CPU_VAES;
+	}
+
+	if(b & bit_SHA) f |= KRIPTO_CPU_SHANI;
+	if(c & bit_GFNI) f |= KRIPTO_CPU_GFNI;
+
+	return f;
+}
+
+#endif
+
+static unsigned int parse(const char *s)
+{
+	unsigned int f = 0;
+	unsigned int i;
+	size_t len;
+
+	while(*s)
+	{
+		len = strcspn(s, ", ");
+
+		for(i = 0; i < sizeof(names) / sizeof(names[0]); i++)
+		{
+			if(strlen(names[i].name) == len && !strncmp(s, names[i].name, len))
+				f |= names[i].feature;
+		}
+
+		s += len;
+		if(*s) s++;
+	}
+
+	return f;
+}
+
+static void cpu_init(void)
+{
+	const char *env;
+
+	#ifdef X86
+	detected = x86_detect();
+	#else
+	detected = 0;
+	#endif
+
+	enabled = detected;
+
+	env = getenv("KRIPTO_CPU");
+	if(env) enabled &= parse(env);
+}
+
+static void cpu_once(void)
+{
+	#ifdef KRIPTO_THREADS
+	(void)pthread_once(&once, &cpu_init);
+	#else
+	if(!init)
+	{
+		cpu_init();
+		init = -1;
+	}
+	#endif
+}
+
+unsigned int kripto_cpu_detect(void)
+{
+	cpu_once();
+
+	return detected;
+}
+
+unsigned int kripto_cpu(void)
+{
+	cpu_once();
+
+	return enabled;
+}
+
+void kripto_cpu_set(unsigned int features)
+{
+	cpu_once();
+
+	enabled = detected & features;
+}
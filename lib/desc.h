@@ -0,0 +1,33 @@
+/*
+ * Copyright (C) 2026 by Gregor Pintar <grpintar@gmail.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef LIB_DESC_H
+#define LIB_DESC_H
+
+/*
+ * Descriptors for modes that build their own per context. They come
+ * from kripto_alloc(), so init places them in caller memory, and are
+ * released with kripto_free().
+ */
+
+#include <kripto/block.h>
+#include <kripto/stream.h>
+#include <kripto/mac.h>
+
+extern kripto_desc_stream *kripto_stream_ctr_alloc(const kripto_desc_block *block);
+
+extern kripto_desc_mac *kripto_mac_omac_alloc(const kripto_desc_block *block);
+
+#endif
@@ -14,10 +14,13 @@
  */
 
 #include <assert.h>
+#include <stdlib.h>
 
 #include <kripto/hash.h>
 #include <kripto/desc/hash.h>
 
+#include "alloc.h"
+
 struct kripto_hash
 {
 	const kripto_desc_hash *desc;
@@ -77,6 +80,17 @@ void kripto_hash_output(kripto_hash *s, void *out, size_t len)
 	s->desc->output(s, out, len);
 }
 
+void kripto_hash_copy(const kripto_hash *s, kripto_hash *c)
+{
+	assert(s);
+	assert(s->desc);
+	assert(s->desc->copy);
+	assert(c);
+	assert(c->desc == s->desc);
+
+	s->desc->copy(s, c);
+}
+
 void kripto_hash_destroy(kripto_hash *s)
 {
 	assert(s);
@@ -86,6 +100,67 @@ void kripto_hash_destroy(kripto_hash *s)
 	s->desc->destroy(s);
 }
 
+/* create with a zero key, counting what it takes */
+size_t kripto_hash_ctx_size
+(
+	const kripto_desc_hash *desc,
+	unsigned int rounds,
+	unsigned int salt_len,
+	unsigned int out_len
+)
+{
+	struct kripto_alloc_arena a;
+	kripto_hash *s;
+	void *zero;
+	size_t len;
+
+	assert(desc);
+	assert(desc->create);
+
+	zero = calloc(salt_len + 1, 1);
+	if(!zero) return 0;
+
+	kripto_alloc_begin(&a, 0, 0);
+	s = kripto_hash_create(desc, rounds, salt_len ? zero : 0, salt_len, out_len);
+	len = kripto_alloc_end(&a);
+
+	free(zero);
+
+	if(!s) return 0;
+	kripto_hash_destroy(s);
+
+	return len;
+}
+
+kripto_hash *kripto_hash_init
+(
+	const kripto_desc_hash *desc,
+	void *mem,
+	size_t len,
+	unsigned int rounds,
+	const void *salt,
+	unsigned int salt_len,
+	unsigned int out_len
+)
+{
+	struct kripto_alloc_arena a;
+	kripto_hash *s;
+
+	assert(mem);
+
+	kripto_alloc_begin(&a, mem, len);
+	s = kripto_hash_create(desc, rounds, salt, salt_len, out_len);
+	(void)kripto_alloc_end(&a);
+
+	return s;
+}
+
+/* destroy wipes, kripto_free leaves caller memory alone */
+void kripto_hash_fini(kripto_hash *s)
+{
+	kripto_hash_destroy(s);
+}
+
 int kripto_hash_all
 (
 	const kripto_desc_hash *desc,
@@ -106,6 +181,42 @@ int kripto_hash_all
 	return desc->hash_all(desc, rounds, salt, salt_len, in, in_len, out, out_len);
 }
 
+int kripto_hash_multi
+(
+	const kripto_desc_hash *desc,
+	unsigned int rounds,
+	const void *salt,
+	unsigned int salt_len,
+	const void *const *in,
+	const size_t *in_len,
+	void *const *out,
+	size_t out_len,
+	unsigned int n
+)
+{
+	unsigned int i;
+
+	assert(desc);
+	assert(desc->hash_all);
+	assert(salt_len <= desc->maxsalt);
+	assert(!desc->maxout || out_len <= desc->maxout);
+	assert(in || !n);
+	assert(in_len || !n);
+	assert(out || !n);
+
+	if(desc->hash_multi)
+		return desc->hash_multi(desc, rounds, salt, salt_len, in, in_len, out, out_len, n);
+
+	/* generic */
+	for(i = 0; i < n; i++)
+	{
+		if(desc->hash_all(desc, rounds, salt, salt_len, in[i], in_len[i], out[i], out_len))
+			return -1;
+	}
+
+	return 0;
+}
+
 const kripto_desc_hash *kripto_hash_getdesc(const kripto_hash *s)
 {
 	assert(s);
@@ -27,6 +27,8 @@
 
 #include <kripto/hash/blake256.h>
 
+#include "../alloc.h"
+
 struct kripto_hash
 {
 	const kripto_desc_hash *desc;
@@ -253,6 +255,11 @@ static void blake256_output(kripto_hash *s, void *out, size_t len)
 	s->i += len;
 }
 
+static void blake256_copy(const kripto_hash *s, kripto_hash *c)
+{
+	*c = *s;
+}
+
 static kripto_hash *blake256_create
 (
 	const kripto_desc_hash *desc,
@@ -262,7 +269,7 @@ static kripto_hash *blake256_create
 	unsigned int out_len
 )
 {
-	kripto_hash *s = (kripto_hash *)malloc(sizeof(kripto_hash));
+	kripto_hash *s = (kripto_hash *)kripto_alloc(sizeof(kripto_hash));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -273,7 +280,7 @@ static kripto_hash *blake256_create
 static void blake256_destroy(kripto_hash *s)
 {
 	kripto_memory_wipe(s, sizeof(kripto_hash));
-	free(s);
+	kripto_free(s);
 }
 
 static int blake256_hash
@@ -306,8 +313,11 @@ static const kripto_desc_hash blake256 =
 	&blake256_recreate,
 	&blake256_input,
 	&blake256_output,
+	&blake256_copy,
 	&blake256_destroy,
 	&blake256_hash,
+	0, /* hash multi */
+	0, /* hmac chain */
 	32, /* max output */
 	64, /* block_size */
 	16 /* max salt */
@@ -27,6 +27,8 @@
 
 #include <kripto/hash/blake2b.h>
 
+#include "../alloc.h"
+
 struct kripto_hash
 {
 	const kripto_desc_hash *desc;
@@ -177,8 +179,7 @@ static void blake2b_input
 {
 	for(size_t i = 0; i < len; i++)
 	{
-		s->buf[s->i++] = CU8(in)[i];
-
+		/* last block is processed by finish, even when full */
 		if(s->i == 128)
 		{
 			s->len[0] += 128;
@@ -191,6 +192,8 @@ static void blake2b_input
 			blake2b_process(s, s->buf);
 			s->i = 0;
 		}
+
+		s->buf[s->i++] = CU8(in)[i];
 	}
 }
 
@@ -221,6 +224,11 @@ static void blake2b_output(kripto_hash *s, void *out, size_t len)
 	s->i += len;
 }
 
+static void blake2b_copy(const kripto_hash *s, kripto_hash *c)
+{
+	*c = *s;
+}
+
 static kripto_hash *blake2b_create
 (
 	const kripto_desc_hash *desc,
@@ -230,7 +238,7 @@ static kripto_hash *blake2b_create
 	unsigned int out_len
 )
 {
-	kripto_hash *s = (kripto_hash *)malloc(sizeof(kripto_hash));
+	kripto_hash *s = (kripto_hash *)kripto_alloc(sizeof(kripto_hash));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -241,7 +249,7 @@ static kripto_hash *blake2b_create
 static void blake2b_destroy(kripto_hash *s)
 {
 	kripto_memory_wipe(s, sizeof(kripto_hash));
-	free(s);
+	kripto_free(s);
 }
 
 static int blake2b_hash
@@ -274,8 +282,11 @@ static const kripto_desc_hash blake2b =
 	&blake2b_recreate,
 	&blake2b_input,
 	&blake2b_output,
+	&blake2b_copy,
 	&blake2b_destroy,
 	&blake2b_hash,
+	0, /* hash multi */
+	0, /* hmac chain */
 	64, /* max output */
 	128, /* block_size */
 	16 /* max salt */
@@ -19,6 +19,7 @@
 #include <assert.h>
 
 #include <kripto/cast.h>
+#include <kripto/cpu.h>
 #include <kripto/loadstore.h>
 #include <kripto/rotate.h>
 #include <kripto/memory.h>
@@ -27,6 +28,9 @@
 
 #include <kripto/hash/blake2s.h>
 
+#include "../alloc.h"
+#include "multi.h"
+
 struct kripto_hash
 {
 	const kripto_desc_hash *desc;
@@ -175,8 +179,7 @@ static void blake2s_input
 {
 	for(size_t i = 0; i < len; i++)
 	{
-		s->buf[s->i++] = CU8(in)[i];
-
+		/* last block is processed by finish, even when full */
 		if(s->i == 64)
 		{
 			s->len[0] += 64;
@@ -189,6 +192,8 @@ static void blake2s_input
 			blake2s_process(s, s->buf);
 			s->i = 0;
 		}
+
+		s->buf[s->i++] = CU8(in)[i];
 	}
 }
 
@@ -219,6 +224,11 @@ static void blake2s_output(kripto_hash *s, void *out, size_t len)
 	s->i += len;
 }
 
+static void blake2s_copy(const kripto_hash *s, kripto_hash *c)
+{
+	*c = *s;
+}
+
 static kripto_hash *blake2s_create
 (
 	const kripto_desc_hash *desc,
@@ -228,7 +238,7 @@ static kripto_hash *blake2s_create
 	unsigned int out_len
 )
 {
-	kripto_hash *s = (kripto_hash *)malloc(sizeof(kripto_hash));
+	kripto_hash *s = (kripto_hash *)kripto_alloc(sizeof(kripto_hash));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -239,7 +249,7 @@ static kripto_hash *blake2s_create
 static void blake2s_destroy(kripto_hash *s)
 {
 	kripto_memory_wipe(s, sizeof(kripto_hash));
-	free(s);
+	kripto_free(s);
 }
 
 static int blake2s_hash
@@ -266,14 +276,229 @@ static int blake2s_hash
 	return 0;
 }
 
+#ifdef KRIPTO_MULTI_SIMD
+
+#define V_G(A, B, C, D, M0, M1)		\
+{					\
+	A += B + (M0);			\
+	D = MULTI_ROL(D ^ A, 16);	\
+	C += D;				\
+	B = MULTI_ROL(B ^ C, 20);	\
+					\
+	A += B + (M1);			\
+	D = MULTI_ROL(D ^ A, 24);	\
+	C += D;				\
+	B = MULTI_ROL(B ^ C, 25);	\
+}
+
+/* one compression in each of 16 lanes, t holds counters and final flags */
+MULTI_INLINE void blake2s_x16
+(
+	uint32_t st[8][MULTI_LANES],
+	const uint32_t w[16][MULTI_LANES],
+	const uint32_t t[3][MULTI_LANES],
+	unsigned int r
+)
+{
+	multi_v16 x00;
+	multi_v16 x01;
+	multi_v16 x02;
+	multi_v16 x03;
+	multi_v16 x04;
+	multi_v16 x05;
+	multi_v16 x06;
+	multi_v16 x07;
+	multi_v16 x08;
+	multi_v16 x09;
+	multi_v16 x10;
+	multi_v16 x11;
+	multi_v16 x12;
+	multi_v16 x13;
+	multi_v16 x14;
+	multi_v16 x15;
+	multi_v16 y;
+	multi_v16 m[16];
+	unsigned int i;
+	unsigned int j;
+
+	MULTI_LOAD(x00, st[0]);
+	MULTI_LOAD(x01, st[1]);
+	MULTI_LOAD(x02, st[2]);
+	MULTI_LOAD(x03, st[3]);
+	MULTI_LOAD(x04, st[4]);
+	MULTI_LOAD(x05, st[5]);
+	MULTI_LOAD(x06, st[6]);
+	MULTI_LOAD(x07, st[7]);
+	MULTI_LOAD(x12, t[0]);
+	MULTI_LOAD(x13, t[1]);
+	MULTI_LOAD(x14, t[2]);
+
+	x08 = x00 ^ x00 ^ IV[0];
+	x09 = x00 ^ x00 ^ IV[1];
+	x10 = x00 ^ x00 ^ IV[2];
+	x11 = x00 ^ x00 ^ IV[3];
+	x12 ^= IV[4];
+	x13 ^= IV[5];
+	x14 ^= IV[6];
+	x15 = x00 ^ x00 ^ IV[7];
+
+	for(i = 0; i < 16; i++)
+		MULTI_LOAD(m[i], w[i]);
+
+	for(i = 0, j = 0; i < r; i++, j++)
+	{
+		if(j == 10) j = 0;
+
+		V_G(x00, x04, x08, x12, m[SIGMA[j][ 0]], m[SIGMA[j][ 1]]);
+		V_G(x01, x05, x09, x13, m[SIGMA[j][ 2]], m[SIGMA[j][ 3]]);
+		V_G(x02, x06, x10, x14, m[SIGMA[j][ 4]], m[SIGMA[j][ 5]]);
+		V_G(x03, x07, x11, x15, m[SIGMA[j][ 6]], m[SIGMA[j][ 7]]);
+
+		V_G(x00, x05, x10, x15, m[SIGMA[j][ 8]], m[SIGMA[j][ 9]]);
+		V_G(x01, x06, x11, x12, m[SIGMA[j][10]], m[SIGMA[j][11]]);
+		V_G(x02, x07, x08, x13, m[SIGMA[j][12]], m[SIGMA[j][13]]);
+		V_G(x03, x04, x09, x14, m[SIGMA[j][14]], m[SIGMA[j][15]]);
+	}
+
+	MULTI_LOAD(y, st[0]); y ^= x00 ^ x08; MULTI_STORE(st[0], y);
+	MULTI_LOAD(y, st[1]); y ^= x01 ^ x09; MULTI_STORE(st[1], y);
+	MULTI_LOAD(y, st[2]); y ^= x02 ^ x10; MULTI_STORE(st[2], y);
+	MULTI_LOAD(y, st[3]); y ^= x03 ^ x11; MULTI_STORE(st[3], y);
+	MULTI_LOAD(y, st[4]); y ^= x04 ^ x12; MULTI_STORE(st[4], y);
+	MULTI_LOAD(y, st[5]); y ^= x05 ^ x13; MULTI_STORE(st[5], y);
+	MULTI_LOAD(y, st[6]); y ^= x06 ^ x14; MULTI_STORE(st[6], y);
+	MULTI_LOAD(y, st[7]); y ^= x07 ^ x15; MULTI_STORE(st[7], y);
+}
+
+MULTI_AVX512 static void blake2s_avx512
+(
+	uint32_t st[8][MULTI_LANES],
+	const uint32_t w[16][MULTI_LANES],
+	const uint32_t t[3][MULTI_LANES],
+	unsigned int r
+)
+{
+	blake2s_x16(st, w, t, r);
+}
+
+MULTI_AVX2 static void blake2s_avx2
+(
+	uint32_t st[8][MULTI_LANES],
+	const uint32_t w[16][MULTI_LANES],
+	const uint32_t t[3][MULTI_LANES],
+	unsigned int r
+)
+{
+	blake2s_x16(st, w, t, r);
+}
+
+#endif
+
+static int blake2s_multi
+(
+	const kripto_desc_hash *desc,
+	unsigned int r,
+	const void *salt,
+	unsigned int salt_len,
+	const void *const *in,
+	const size_t *in_len,
+	void *const *out,
+	size_t out_len,
+	unsigned int n
+)
+{
+	unsigned int i;
+	#ifdef KRIPTO_MULTI_SIMD
+	void (*x16)
+	(
+		uint32_t [8][MULTI_LANES],
+		const uint32_t [16][MULTI_LANES],
+		const uint32_t [3][MULTI_LANES],
+		unsigned int
+	);
+	uint32_t st[8][MULTI_LANES];
+	uint32_t w[16][MULTI_LANES];
+	uint32_t t[3][MULTI_LANES];
+	uint32_t h[8];
+	struct multi m;
+	kripto_hash s;
+	const uint8_t *data;
+	unsigned int l;
+
+	(void)blake2s_recreate(&s, r, salt, salt_len, out_len);
+
+	if(kripto_cpu() & KRIPTO_CPU_AVX512) x16 = &blake2s_avx512;
+	else if(kripto_cpu() & KRIPTO_CPU_AVX2) x16 = &blake2s_avx2;
+	else x16 = 0;
+
+	if(x16)
+	{
+		memset(w, 0, sizeof(w));
+		memset(t, 0, sizeof(t));
+		multi_init(&m, in, in_len, out, n, MULTI_PAD_ZERO);
+
+		for(l = 0; l < MULTI_LANES; l++)
+		{
+			if(multi_start(&m, l))
+				for(i = 0; i < 8; i++) st[i][l] = s.h[i];
+		}
+
+		while(multi_active(&m))
+		{
+			for(l = 0; l < MULTI_LANES; l++)
+			{
+				data = multi_block(&m, l);
+				if(!data) continue;
+
+				for(i = 0; i < 16; i++)
+					w[i][l] = LOAD32L(data + (i << 2));
+
+				t[0][l] = (uint32_t)m.done[l];
+				t[1][l] = (uint32_t)(m.done[l] >> 32);
+				t[2][l] = multi_done(&m, l) ? 0xFFFFFFFF : 0;
+			}
+
+			x16(st, (const uint32_t (*)[MULTI_LANES])w,
+				(const uint32_t (*)[MULTI_LANES])t, s.r);
+
+			for(l = 0; l < MULTI_LANES; l++)
+			{
+				if(!multi_done(&m, l)) continue;
+
+				for(i = 0; i < 8; i++) h[i] = st[i][l];
+				STORE32L_ARRAY(h, 0, multi_out(&m, l), out_len);
+
+				if(multi_start(&m, l))
+					for(i = 0; i < 8; i++) st[i][l] = s.h[i];
+			}
+		}
+
+		kripto_memory_wipe(st, sizeof(st));
+		kripto_memory_wipe(w, sizeof(w));
+		kripto_memory_wipe(h, sizeof(h));
+		kripto_memory_wipe(&m, sizeof(m));
+
+		return 0;
+	}
+	#endif
+
+	for(i = 0; i < n; i++)
+		(void)blake2s_hash(desc, r, salt, salt_len, in[i], in_len[i], out[i], out_len);
+
+	return 0;
+}
+
 static const kripto_desc_hash blake2s =
 {
 	&blake2s_create,
 	&blake2s_recreate,
 	&blake2s_input,
 	&blake2s_output,
+	&blake2s_copy,
 	&blake2s_destroy,
 	&blake2s_hash,
+	&blake2s_multi,
+	0, /* hmac chain */
 	32, /* max output */
 	64, /* block_size */
 	8 /* max salt */
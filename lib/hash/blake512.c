@@ -28,6 +28,8 @@
 
 #include <kripto/hash/blake512.h>
 
+#include "../alloc.h"
+
 struct kripto_hash
 {
 	const kripto_desc_hash *desc;
@@ -258,6 +260,11 @@ static void blake512_output(kripto_hash *s, void *out, size_t len)
 	s->i += len;
 }
 
+static void blake512_copy(const kripto_hash *s, kripto_hash *c)
+{
+	*c = *s;
+}
+
 static kripto_hash *blake512_create
 (
 	const kripto_desc_hash *desc,
@@ -267,7 +274,7 @@ static kripto_hash *blake512_create
 	unsigned int out_len
 )
 {
-	kripto_hash *s = (kripto_hash *)malloc(sizeof(kripto_hash));
+	kripto_hash *s = (kripto_hash *)kripto_alloc(sizeof(kripto_hash));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -278,7 +285,7 @@ static kripto_hash *blake512_create
 static void blake512_destroy(kripto_hash *s)
 {
 	kripto_memory_wipe(s, sizeof(kripto_hash));
-	free(s);
+	kripto_free(s);
 }
 
 static int blake512_hash
@@ -311,8 +318,11 @@ static const kripto_desc_hash blake512 =
 	&blake512_recreate,
 	&blake512_input,
 	&blake512_output,
+	&blake512_copy,
 	&blake512_destroy,
 	&blake512_hash,
+	0, /* hash multi */
+	0, /* hmac chain */
 	64, /* max output */
 	128, /* block_size */
 	32 /* max salt */
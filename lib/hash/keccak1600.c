@@ -28,6 +28,8 @@
 #include <kripto/hash/keccak1600.h>
 #include <kripto/hash/sha3.h>
 
+#include "../alloc.h"
+
 struct kripto_hash
 {
 	const kripto_desc_hash *desc;
@@ -367,6 +369,11 @@ static void keccak1600_output
 	}
 }
 
+static void keccak1600_copy(const kripto_hash *s, kripto_hash *c)
+{
+	*c = *s;
+}
+
 static kripto_hash *keccak1600_create
 (
 	const kripto_desc_hash *desc,
@@ -376,7 +383,7 @@ static kripto_hash *keccak1600_create
 	unsigned int out_len
 )
 {
-	kripto_hash *s = (kripto_hash *)malloc(sizeof(kripto_hash));
+	kripto_hash *s = (kripto_hash *)kripto_alloc(sizeof(kripto_hash));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -387,7 +394,7 @@ static kripto_hash *keccak1600_create
 static void keccak1600_destroy(kripto_hash *s) 
 {
 	kripto_memory_wipe(s, sizeof(kripto_hash));
-	free(s);
+	kripto_free(s);
 }
 
 static int keccak1600_hash
@@ -420,8 +427,11 @@ static const kripto_desc_hash keccak1600 =
 	&keccak1600_recreate,
 	&keccak1600_input,
 	&keccak1600_output,
+	&keccak1600_copy,
 	&keccak1600_destroy,
 	&keccak1600_hash,
+	0, /* hash multi */
+	0, /* hmac chain */
 	0, /* max output */
 	200, /* block_size */
 	0 /* max salt */
@@ -487,8 +497,11 @@ static const kripto_desc_hash sha3 =
 	&keccak1600_recreate,
 	&keccak1600_input,
 	&sha3_output,
+	&keccak1600_copy,
 	&keccak1600_destroy,
 	&sha3_hash,
+	0, /* hash multi */
+	0, /* hmac chain */
 	64, /* max output */
 	200, /* block_size */
 	0, /* max salt */
@@ -27,6 +27,8 @@
 
 #include <kripto/hash/keccak800.h>
 
+#include "../alloc.h"
+
 struct kripto_hash
 {
 	const kripto_desc_hash *desc;
@@ -347,6 +349,11 @@ static void keccak800_output(kripto_hash *s, void *out, size_t len)
 	}
 }
 
+static void keccak800_copy(const kripto_hash *s, kripto_hash *c)
+{
+	*c = *s;
+}
+
 static kripto_hash *keccak800_create
 (
 	const kripto_desc_hash *desc,
@@ -356,7 +363,7 @@ static kripto_hash *keccak800_create
 	unsigned int out_len
 )
 {
-	kripto_hash *s = (kripto_hash *)malloc(sizeof(kripto_hash));
+	kripto_hash *s = (kripto_hash *)kripto_alloc(sizeof(kripto_hash));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -367,7 +374,7 @@ static kripto_hash *keccak800_create
 static void keccak800_destroy(kripto_hash *s) 
 {
 	kripto_memory_wipe(s, sizeof(kripto_hash));
-	free(s);
+	kripto_free(s);
 }
 
 static int keccak800_hash
@@ -400,8 +407,11 @@ static const kripto_desc_hash keccak800 =
 	&keccak800_recreate,
 	&keccak800_input,
 	&keccak800_output,
+	&keccak800_copy,
 	&keccak800_destroy,
 	&keccak800_hash,
+	0, /* hash multi */
+	0, /* hmac chain */
 	0, /* max output */
 	100, /* block_size */
 	0 /* max salt */
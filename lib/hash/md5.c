@@ -19,6 +19,7 @@
 #include <assert.h>
 
 #include <kripto/cast.h>
+#include <kripto/cpu.h>
 #include <kripto/loadstore.h>
 #include <kripto/rotate.h>
 #include <kripto/memory.h>
@@ -27,6 +28,9 @@
 
 #include <kripto/hash/md5.h>
 
+#include "../alloc.h"
+#include "multi.h"
+
 struct kripto_hash
 {
 	const kripto_desc_hash *desc;
@@ -234,6 +238,11 @@ static void md5_output(kripto_hash *s, void *out, size_t len)
 	s->i += len;
 }
 
+static void md5_copy(const kripto_hash *s, kripto_hash *c)
+{
+	*c = *s;
+}
+
 static kripto_hash *md5_create
 (
 	const kripto_desc_hash *desc,
@@ -243,7 +252,7 @@ static kripto_hash *md5_create
 	unsigned int out_len
 )
 {
-	kripto_hash *s = (kripto_hash *)malloc(sizeof(kripto_hash));
+	kripto_hash *s = (kripto_hash *)kripto_alloc(sizeof(kripto_hash));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -254,7 +263,7 @@ static kripto_hash *md5_create
 static void md5_destroy(kripto_hash *s)
 {
 	kripto_memory_wipe(s, sizeof(kripto_hash));
-	free(s);
+	kripto_free(s);
 }
 
 static int md5_hash
@@ -281,14 +290,187 @@ static int md5_hash
 	return 0;
 }
 
+#ifdef KRIPTO_MULTI_SIMD
+
+#define V_G(F, A, B, C, D, I, M)		\
+{						\
+	t = A + F(B, C, D) + K[I] + M;		\
+	A = B + MULTI_ROL(t, ROT[I]);		\
+}
+
+/* one compression in each of 16 lanes */
+MULTI_INLINE void md5_x16
+(
+	uint32_t st[4][MULTI_LANES],
+	const uint32_t w[16][MULTI_LANES]
+)
+{
+	multi_v16 a;
+	multi_v16 b;
+	multi_v16 c;
+	multi_v16 d;
+	multi_v16 t;
+	multi_v16 m[16];
+	unsigned int i;
+
+	MULTI_LOAD(a, st[0]);
+	MULTI_LOAD(b, st[1]);
+	MULTI_LOAD(c, st[2]);
+	MULTI_LOAD(d, st[3]);
+
+	for(i = 0; i < 16; i++)
+		MULTI_LOAD(m[i], w[i]);
+
+	for(i = 0; i < 16;)
+	{
+		V_G(F0, a, b, c, d, i, m[i]); i++;
+		V_G(F0, d, a, b, c, i, m[i]); i++;
+		V_G(F0, c, d, a, b, i, m[i]); i++;
+		V_G(F0, b, c, d, a, i, m[i]); i++;
+	}
+
+	while(i < 32)
+	{
+		V_G(F1, a, b, c, d, i, m[(i * 5 + 1) & 15]); i++;
+		V_G(F1, d, a, b, c, i, m[(i * 5 + 1) & 15]); i++;
+		V_G(F1, c, d, a, b, i, m[(i * 5 + 1) & 15]); i++;
+		V_G(F1, b, c, d, a, i, m[(i * 5 + 1) & 15]); i++;
+	}
+
+	while(i < 48)
+	{
+		V_G(F2, a, b, c, d, i, m[(i * 3 + 5) & 15]); i++;
+		V_G(F2, d, a, b, c, i, m[(i * 3 + 5) & 15]); i++;
+		V_G(F2, c, d, a, b, i, m[(i * 3 + 5) & 15]); i++;
+		V_G(F2, b, c, d, a, i, m[(i * 3 + 5) & 15]); i++;
+	}
+
+	while(i < 64)
+	{
+		V_G(F3, a, b, c, d, i, m[(i * 7) & 15]); i++;
+		V_G(F3, d, a, b, c, i, m[(i * 7) & 15]); i++;
+		V_G(F3, c, d, a, b, i, m[(i * 7) & 15]); i++;
+		V_G(F3, b, c, d, a, i, m[(i * 7) & 15]); i++;
+	}
+
+	MULTI_LOAD(t, st[0]); a += t; MULTI_STORE(st[0], a);
+	MULTI_LOAD(t, st[1]); b += t; MULTI_STORE(st[1], b);
+	MULTI_LOAD(t, st[2]); c += t; MULTI_STORE(st[2], c);
+	MULTI_LOAD(t, st[3]); d += t; MULTI_STORE(st[3], d);
+}
+
+MULTI_AVX512 static void md5_avx512
+(
+	uint32_t st[4][MULTI_LANES],
+	const uint32_t w[16][MULTI_LANES]
+)
+{
+	md5_x16(st, w);
+}
+
+MULTI_AVX2 static void md5_avx2
+(
+	uint32_t st[4][MULTI_LANES],
+	const uint32_t w[16][MULTI_LANES]
+)
+{
+	md5_x16(st, w);
+}
+
+#endif
+
+static int md5_multi
+(
+	const kripto_desc_hash *desc,
+	unsigned int r,
+	const void *salt,
+	unsigned int salt_len,
+	const void *const *in,
+	const size_t *in_len,
+	void *const *out,
+	size_t out_len,
+	unsigned int n
+)
+{
+	unsigned int i;
+	#ifdef KRIPTO_MULTI_SIMD
+	void (*x16)(uint32_t [4][MULTI_LANES], const uint32_t [16][MULTI_LANES]);
+	uint32_t st[4][MULTI_LANES];
+	uint32_t w[16][MULTI_LANES];
+	uint32_t h[4];
+	struct multi m;
+	kripto_hash s;
+	const uint8_t *data;
+	unsigned int l;
+
+	(void)md5_recreate(&s, r, salt, salt_len, out_len);
+
+	if(kripto_cpu() & KRIPTO_CPU_AVX512) x16 = &md5_avx512;
+	else if(kripto_cpu() & KRIPTO_CPU_AVX2) x16 = &md5_avx2;
+	else x16 = 0;
+
+	if(x16)
+	{
+		memset(w, 0, sizeof(w));
+		multi_init(&m, in, in_len, out, n, MULTI_PAD_LE);
+
+		for(l = 0; l < MULTI_LANES; l++)
+		{
+			if(multi_start(&m, l))
+				for(i = 0; i < 4; i++) st[i][l] = s.h[i];
+		}
+
+		while(multi_active(&m))
+		{
+			for(l = 0; l < MULTI_LANES; l++)
+			{
+				data = multi_block(&m, l);
+				if(!data) continue;
+
+				for(i = 0; i < 16; i++)
+					w[i][l] = LOAD32L(data + (i << 2));
+			}
+
+			x16(st, (const uint32_t (*)[MULTI_LANES])w);
+
+			for(l = 0; l < MULTI_LANES; l++)
+			{
+				if(!multi_done(&m, l)) continue;
+
+				for(i = 0; i < 4; i++) h[i] = st[i][l];
+				STORE32L_ARRAY(h, 0, multi_out(&m, l), out_len);
+
+				if(multi_start(&m, l))
+					for(i = 0; i < 4; i++) st[i][l] = s.h[i];
+			}
+		}
+
+		kripto_memory_wipe(st, sizeof(st));
+		kripto_memory_wipe(w, sizeof(w));
+		kripto_memory_wipe(h, sizeof(h));
+		kripto_memory_wipe(&m, sizeof(m));
+
+		return 0;
+	}
+	#endif
+
+	for(i = 0; i < n; i++)
+		(void)md5_hash(desc, r, salt, salt_len, in[i], in_len[i], out[i], out_len);
+
+	return 0;
+}
+
 static const kripto_desc_hash md5 =
 {
 	&md5_create,
 	&md5_recreate,
 	&md5_input,
 	&md5_output,
+	&md5_copy,
 	&md5_destroy,
 	&md5_hash,
+	&md5_multi,
+	0, /* hmac chain */
 	16, /* max output */
 	64, /* block_size */
 	0 /* max salt */
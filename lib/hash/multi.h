@@ -0,0 +1,194 @@
+/*
+ * Copyright (C) 2026 by Gregor Pintar <grpintar@gmail.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef LIB_HASH_MULTI_H
+#define LIB_HASH_MULTI_H
+
+/*
+ * Internal lane scheduler for hashing many independent messages with
+ * one vector word per message. Messages are padded per lane and
+ * a lane is refilled with the next message as soon as it finishes.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include <kripto/cast.h>
+#include <kripto/loadstore.h>
+
+#if (defined(__GNUC__) || defined(__clang__)) \
+&& (defined(__i386__) || defined(__x86_64__))
+#define KRIPTO_MULTI_SIMD
+
+/* wider than the vector unit is fine, it is split into 256-bit halves */
+typedef uint32_t multi_v16 __attribute__((vector_size(64)));
+
+#define MULTI_AVX2 __attribute__((target("avx2")))
+#define MULTI_AVX512 __attribute__((target("avx512f")))
+#define MULTI_INLINE static inline __attribute__((always_inline))
+
+#define MULTI_LOAD(V, SRC) memcpy(&(V), SRC, 64)
+#define MULTI_STORE(DST, V) memcpy(DST, &(V), 64)
+
+#define MULTI_ROL(X, N) (((X) << (N)) | ((X) >> (32 - (N))))
+
+#endif
+
+#define MULTI_LANES 16
+
+#define MULTI_PAD_BE 0 /* 0x80, zeros, 64-bit big endian bit length */
+#define MULTI_PAD_LE 1 /* 0x80, zeros, 64-bit little endian bit length */
+#define MULTI_PAD_ZERO 2 /* zeros, last block always from buffer */
+
+struct multi
+{
+	const void *const *in;
+	const size_t *in_len;
+	void *const *out;
+	unsigned int n;
+	unsigned int next;
+	int pad;
+
+	unsigned int msg[MULTI_LANES];
+	const uint8_t *p[MULTI_LANES];
+	size_t direct[MULTI_LANES];
+	size_t left[MULTI_LANES];
+	uint64_t len[MULTI_LANES];
+	uint64_t done[MULTI_LANES];
+	uint8_t buf[MULTI_LANES][128];
+};
+
+static inline void multi_init
+(
+	struct multi *m,
+	const void *const *in,
+	const size_t *in_len,
+	void *const *out,
+	unsigned int n,
+	int pad
+)
+{
+	unsigned int l;
+
+	m->in = in;
+	m->in_len = in_len;
+	m->out = out;
+	m->n = n;
+	m->next = 0;
+	m->pad = pad;
+
+	for(l = 0; l < MULTI_LANES; l++)
+		m->msg[l] = n;
+}
+
+/* next message into lane, 0 if there are none left */
+static inline int multi_start(struct multi *m, unsigned int l)
+{
+	size_t len;
+	size_t rem;
+
+	if(m->next == m->n)
+	{
+		m->msg[l] = m->n;
+		return 0;
+	}
+
+	m->msg[l] = m->next++;
+	len = m->in_len[m->msg[l]];
+	m->len[l] = len;
+	m->done[l] = 0;
+
+	if(m->pad == MULTI_PAD_ZERO)
+	{
+		m->direct[l] = len ? (len - 1) >> 6 : 0;
+		rem = len - (m->direct[l] << 6);
+
+		memcpy(m->buf[l], CU8(m->in[m->msg[l]]) + len - rem, rem);
+		memset(m->buf[l] + rem, 0, 64 - rem);
+
+		m->left[l] = m->direct[l] + 1;
+	}
+	else
+	{
+		m->direct[l] = len >> 6;
+		rem = len & 63;
+
+		memcpy(m->buf[l], CU8(m->in[m->msg[l]]) + len - rem, rem);
+		m->buf[l][rem] = 0x80;
+
+		if(rem < 56)
+		{
+			memset(m->buf[l] + rem + 1, 0, 55 - rem);
+			m->left[l] = m->direct[l] + 1;
+		}
+		else
+		{
+			memset(m->buf[l] + rem + 1, 0, 119 - rem);
+			m->left[l] = m->direct[l] + 2;
+		}
+
+		if(m->pad == MULTI_PAD_BE)
+			STORE64B((uint64_t)len << 3, m->buf[l] + (m->left[l] - m->direct[l]) * 64 - 8);
+		else
+			STORE64L((uint64_t)len << 3, m->buf[l] + (m->left[l] - m->direct[l]) * 64 - 8);
+	}
+
+	m->p[l] = m->direct[l] ? CU8(m->in[m->msg[l]]) : m->buf[l];
+
+	return 1;
+}
+
+/* next block of lane, 0 if the lane is idle */
+static inline const uint8_t *multi_block(struct multi *m, unsigned int l)
+{
+	const uint8_t *data;
+
+	if(m->msg[l] == m->n) return 0;
+
+	data = m->p[l];
+	if(m->direct[l] && !--m->direct[l]) m->p[l] = m->buf[l];
+	else m->p[l] += 64;
+
+	m->left[l]--;
+
+	m->done[l] += 64;
+	if(m->done[l] > m->len[l]) m->done[l] = m->len[l];
+
+	return data;
+}
+
+/* lane processed its last block */
+static inline int multi_done(const struct multi *m, unsigned int l)
+{
+	return m->msg[l] != m->n && !m->left[l];
+}
+
+static inline void *multi_out(const struct multi *m, unsigned int l)
+{
+	return m->out[m->msg[l]];
+}
+
+static inline int multi_active(const struct multi *m)
+{
+	unsigned int l;
+
+	for(l = 0; l < MULTI_LANES; l++)
+		if(m->msg[l] != m->n) return 1;
+
+	return 0;
+}
+
+#endif
@@ -16,17 +16,29 @@
 #include <stdint.h>
 #include <stddef.h>
 #include <stdlib.h>
+#include <string.h>
 #include <assert.h>
 
+#if (defined(__GNUC__) || defined(__clang__)) \
+&& (defined(__i386__) || defined(__x86_64__))
+#define SHANI
+#include <immintrin.h>
+#endif
+
 #include <kripto/cast.h>
+#include <kripto/cpu.h>
 #include <kripto/loadstore.h>
 #include <kripto/rotate.h>
 #include <kripto/memory.h>
+#include <kripto/xor.h>
 #include <kripto/hash.h>
 #include <kripto/desc/hash.h>
 
 #include <kripto/hash/sha1.h>
 
+#include "../alloc.h"
+#include "multi.h"
+
 struct kripto_hash
 {
 	const kripto_desc_hash *desc;
@@ -35,6 +47,7 @@ struct kripto_hash
 	uint8_t buf[64];
 	unsigned int i;
 	int o;
+	int ni;
 };
 
 #define F0(X, Y, Z) (Z ^ (X & (Y ^ Z)))
@@ -87,6 +100,14 @@ static kripto_hash *sha1_recreate
 	s->h[3] = 0x10325476;
 	s->h[4] = 0xC3D2E1F0;
 
+	#ifdef SHANI
+	s->ni = (kripto_cpu() & (KRIPTO_CPU_SSSE3 | KRIPTO_CPU_SSE41
+		| KRIPTO_CPU_SHANI)) == (KRIPTO_CPU_SSSE3 | KRIPTO_CPU_SSE41
+		| KRIPTO_CPU_SHANI);
+	#else
+	s->ni = 0;
+	#endif
+
 	return s;
 }
 
@@ -165,6 +186,126 @@ static void sha1_process(kripto_hash *s, const uint8_t *data)
 	s->h[4] += e;
 }
 
+#ifdef SHANI
+
+#define NI __attribute__((target("sse2,ssse3,sse4.1,sha")))
+
+/* 4 rounds, M0 holds the current words and M1-M3 the following ones */
+#define NI_G(F, M0, M1, M2, M3, E0, E1)		\
+{						\
+	E0 = _mm_sha1nexte_epu32(E0, M0);	\
+	E1 = abcd;				\
+	M1 = _mm_sha1msg2_epu32(M1, M0);	\
+	abcd = _mm_sha1rnds4_epu32(abcd, E0, F);	\
+	M3 = _mm_sha1msg1_epu32(M3, M0);	\
+	M2 = _mm_xor_si128(M2, M0);		\
+}
+
+NI static void ni_process
+(
+	kripto_hash *s,
+	const uint8_t *data,
+	size_t blocks
+)
+{
+	const __m128i bswap = _mm_set_epi64x
+	(
+		0x0001020304050607ULL,
+		0x08090A0B0C0D0E0FULL
+	);
+	__m128i abcd;
+	__m128i abcd0;
+	__m128i e0;
+	__m128i e1;
+	__m128i e00;
+	__m128i m0;
+	__m128i m1;
+	__m128i m2;
+	__m128i m3;
+
+	abcd = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)s->h), 0x1B);
+	e0 = _mm_insert_epi32(_mm_setzero_si128(), (int)s->h[4], 3);
+
+	for(; blocks; blocks--)
+	{
+		abcd0 = abcd;
+		e00 = e0;
+
+		/* 0 - 3 */
+		m0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)data), bswap);
+		e0 = _mm_add_epi32(e0, m0);
+		e1 = abcd;
+		abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+
+		/* 4 - 7 */
+		m1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)data + 1), bswap);
+		e1 = _mm_sha1nexte_epu32(e1, m1);
+		e0 = abcd;
+		abcd = _mm_sha1rnds4_epu32(abcd, e1, 0);
+		m0 = _mm_sha1msg1_epu32(m0, m1);
+
+		/* 8 - 11 */
+		m2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)data + 2), bswap);
+		e0 = _mm_sha1nexte_epu32(e0, m2);
+		e1 = abcd;
+		abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+		m1 = _mm_sha1msg1_epu32(m1, m2);
+		m0 = _mm_xor_si128(m0, m2);
+
+		/* 12 - 79 */
+		m3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)data + 3), bswap);
+		NI_G(0, m3, m0, m1, m2, e1, e0);
+		NI_G(0, m0, m1, m2, m3, e0, e1);
+		NI_G(1, m1, m2, m3, m0, e1, e0);
+		NI_G(1, m2, m3, m0, m1, e0, e1);
+		NI_G(1, m3, m0, m1, m2, e1, e0);
+		NI_G(1, m0, m1, m2, m3, e0, e1);
+		NI_G(1, m1, m2, m3, m0, e1, e0);
+		NI_G(2, m2, m3, m0, m1, e0, e1);
+		NI_G(2, m3, m0, m1, m2, e1, e0);
+		NI_G(2, m0, m1, m2, m3, e0, e1);
+		NI_G(2, m1, m2, m3, m0, e1, e0);
+		NI_G(2, m2, m3, m0, m1, e0, e1);
+		NI_G(3, m3, m0, m1, m2, e1, e0);
+		NI_G(3, m0, m1, m2, m3, e0, e1);
+		NI_G(3, m1, m2, m3, m0, e1, e0);
+		NI_G(3, m2, m3, m0, m1, e0, e1);
+		NI_G(3, m3, m0, m1, m2, e1, e0);
+
+		e0 = _mm_sha1nexte_epu32(e0, e00);
+		abcd = _mm_add_epi32(abcd, abcd0);
+
+		data += 64;
+	}
+
+	_mm_storeu_si128((__m128i *)s->h, _mm_shuffle_epi32(abcd, 0x1B));
+	s->h[4] = (uint32_t)_mm_extract_epi32(e0, 3);
+}
+
+#endif
+
+static void sha1_blocks
+(
+	kripto_hash *s,
+	const uint8_t *data,
+	size_t blocks
+)
+{
+	#ifdef SHANI
+	if(s->ni)
+	{
+		ni_process(s, data, blocks);
+		return;
+	}
+	#endif
+
+	for(; blocks; blocks--)
+	{
+		sha1_process(s, data);
+		data += 64;
+	}
+}
+
 static void sha1_input
 (
 	kripto_hash *s,
@@ -172,19 +313,41 @@ static void sha1_input
 	size_t len
 ) 
 {
-	for(size_t i = 0; i < len; i++)
+	size_t n;
+
+	/* fill buffer */
+	for(; len && s->i; len--)
 	{
-		s->buf[s->i++] = CU8(in)[i];
+		s->buf[s->i++] = *CU8(in);
+		in = CU8(in) + 1;
 
 		if(s->i == 64)
 		{
 			s->len += 512;
 			assert(s->len >= 512);
 
-			sha1_process(s, s->buf);
+			sha1_blocks(s, s->buf, 1);
 			s->i = 0;
 		}
 	}
+
+	/* whole blocks straight from input */
+	n = len >> 6;
+	if(n)
+	{
+		s->len += (uint64_t)n << 9;
+		assert(s->len >= ((uint64_t)n << 9));
+
+		sha1_blocks(s, CU8(in), n);
+		in = CU8(in) + (n << 6);
+		len &= 63;
+	}
+
+	for(; len; len--)
+	{
+		s->buf[s->i++] = *CU8(in);
+		in = CU8(in) + 1;
+	}
 }
 
 static void sha1_finish(kripto_hash *s)
@@ -197,7 +360,7 @@ static void sha1_finish(kripto_hash *s)
 	if(s->i > 56) /* not enough space for length */
 	{
 		while(s->i < 64) s->buf[s->i++] = 0;
-		sha1_process(s, s->buf);
+		sha1_blocks(s, s->buf, 1);
 		s->i = 0;
 	}
 	while(s->i < 56) s->buf[s->i++] = 0;
@@ -205,7 +368,7 @@ static void sha1_finish(kripto_hash *s)
 	/* add length */
 	STORE64B(s->len, s->buf + 56);
 
-	sha1_process(s, s->buf);
+	sha1_blocks(s, s->buf, 1);
 
 	s->i = 0;
 	s->o = -1;
@@ -220,6 +383,56 @@ static void sha1_output(kripto_hash *s, void *out, size_t len)
 	s->i += len;
 }
 
+static void sha1_copy(const kripto_hash *s, kripto_hash *c)
+{
+	*c = *s;
+}
+
+static int sha1_hmac_chain
+(
+	const kripto_hash *inner,
+	const kripto_hash *outer,
+	const void *u,
+	void *t,
+	unsigned int len,
+	unsigned int iter
+)
+{
+	kripto_hash s;
+	uint8_t block[64];
+	unsigned int i;
+
+	/* keyed states must sit right after the key block */
+	if(len > 20 || inner->i || outer->i || inner->o || outer->o
+	|| inner->len != 512 || outer->len != 512) return -1;
+
+	s = *inner;
+
+	/* key block and one digest, padding stays fixed */
+	memcpy(block, u, len);
+	block[len] = 0x80;
+	memset(block + len + 1, 0, 64 - 9 - len);
+	STORE64B((uint64_t)(64 + len) << 3, block + 56);
+
+	for(i = 1; i < iter; i++)
+	{
+		memcpy(s.h, inner->h, sizeof(s.h));
+		sha1_blocks(&s, block, 1);
+		STORE32B_ARRAY(s.h, 0, block, len);
+
+		memcpy(s.h, outer->h, sizeof(s.h));
+		sha1_blocks(&s, block, 1);
+		STORE32B_ARRAY(s.h, 0, block, len);
+
+		XOR(t, block, t, len);
+	}
+
+	kripto_memory_wipe(&s, sizeof(kripto_hash));
+	kripto_memory_wipe(block, 64);
+
+	return 0;
+}
+
 static kripto_hash *sha1_create
 (
 	const kripto_desc_hash *desc,
@@ -229,7 +442,7 @@ static kripto_hash *sha1_create
 	unsigned int out_len
 )
 {
-	kripto_hash *s = (kripto_hash *)malloc(sizeof(kripto_hash));
+	kripto_hash *s = (kripto_hash *)kripto_alloc(sizeof(kripto_hash));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -240,7 +453,7 @@ static kripto_hash *sha1_create
 static void sha1_destroy(kripto_hash *s)
 {
 	kripto_memory_wipe(s, sizeof(kripto_hash));
-	free(s);
+	kripto_free(s);
 }
 
 static int sha1_hash
@@ -267,14 +480,201 @@ static int sha1_hash
 	return 0;
 }
 
+#ifdef KRIPTO_MULTI_SIMD
+
+#define V_G(F, K, A, B, C, D, E, W)			\
+{							\
+	E += MULTI_ROL(A, 5) + F(B, C, D) + W + K;	\
+	B = MULTI_ROL(B, 30);				\
+}
+
+/* one compression in each of 16 lanes */
+MULTI_INLINE void sha1_x16
+(
+	uint32_t st[5][MULTI_LANES],
+	const uint32_t w[16][MULTI_LANES]
+)
+{
+	multi_v16 a;
+	multi_v16 b;
+	multi_v16 c;
+	multi_v16 d;
+	multi_v16 e;
+	multi_v16 t;
+	multi_v16 x[80];
+	unsigned int i;
+
+	MULTI_LOAD(a, st[0]);
+	MULTI_LOAD(b, st[1]);
+	MULTI_LOAD(c, st[2]);
+	MULTI_LOAD(d, st[3]);
+	MULTI_LOAD(e, st[4]);
+
+	for(i = 0; i < 16; i++)
+		MULTI_LOAD(x[i], w[i]);
+
+	for(; i < 80; i++)
+	{
+		t = x[i - 3] ^ x[i - 8] ^ x[i - 14] ^ x[i - 16];
+		x[i] = MULTI_ROL(t, 1);
+	}
+
+	for(i = 0; i < 20;)
+	{
+		V_G(F0, 0x5A827999, a, b, c, d, e, x[i]); i++;
+		V_G(F0, 0x5A827999, e, a, b, c, d, x[i]); i++;
+		V_G(F0, 0x5A827999, d, e, a, b, c, x[i]); i++;
+		V_G(F0, 0x5A827999, c, d, e, a, b, x[i]); i++;
+		V_G(F0, 0x5A827999, b, c, d, e, a, x[i]); i++;
+	}
+
+	while(i < 40)
+	{
+		V_G(F1, 0x6ED9EBA1, a, b, c, d, e, x[i]); i++;
+		V_G(F1, 0x6ED9EBA1, e, a, b, c, d, x[i]); i++;
+		V_G(F1, 0x6ED9EBA1, d, e, a, b, c, x[i]); i++;
+		V_G(F1, 0x6ED9EBA1, c, d, e, a, b, x[i]); i++;
+		V_G(F1, 0x6ED9EBA1, b, c, d, e, a, x[i]); i++;
+	}
+
+	while(i < 60)
+	{
+		V_G(F2, 0x8F1BBCDC, a, b, c, d, e, x[i]); i++;
+		V_G(F2, 0x8F1BBCDC, e, a, b, c, d, x[i]); i++;
+		V_G(F2, 0x8F1BBCDC, d, e, a, b, c, x[i]); i++;
+		V_G(F2, 0x8F1BBCDC, c, d, e, a, b, x[i]); i++;
+		V_G(F2, 0x8F1BBCDC, b, c, d, e, a, x[i]); i++;
+	}
+
+	while(i < 80)
+	{
+		V_G(F1, 0xCA62C1D6, a, b, c, d, e, x[i]); i++;
+		V_G(F1, 0xCA62C1D6, e, a, b, c, d, x[i]); i++;
+		V_G(F1, 0xCA62C1D6, d, e, a, b, c, x[i]); i++;
+		V_G(F1, 0xCA62C1D6, c, d, e, a, b, x[i]); i++;
+		V_G(F1, 0xCA62C1D6, b, c, d, e, a, x[i]); i++;
+	}
+
+	MULTI_LOAD(t, st[0]); a += t; MULTI_STORE(st[0], a);
+	MULTI_LOAD(t, st[1]); b += t; MULTI_STORE(st[1], b);
+	MULTI_LOAD(t, st[2]); c += t; MULTI_STORE(st[2], c);
+	MULTI_LOAD(t, st[3]); d += t; MULTI_STORE(st[3], d);
+	MULTI_LOAD(t, st[4]); e += t; MULTI_STORE(st[4], e);
+}
+
+MULTI_AVX512 static void sha1_avx512
+(
+	uint32_t st[5][MULTI_LANES],
+	const uint32_t w[16][MULTI_LANES]
+)
+{
+	sha1_x16(st, w);
+}
+
+MULTI_AVX2 static void sha1_avx2
+(
+	uint32_t st[5][MULTI_LANES],
+	const uint32_t w[16][MULTI_LANES]
+)
+{
+	sha1_x16(st, w);
+}
+
+#endif
+
+static int sha1_multi
+(
+	const kripto_desc_hash *desc,
+	unsigned int r,
+	const void *salt,
+	unsigned int salt_len,
+	const void *const *in,
+	const size_t *in_len,
+	void *const *out,
+	size_t out_len,
+	unsigned int n
+)
+{
+	unsigned int i;
+	#ifdef KRIPTO_MULTI_SIMD
+	void (*x16)(uint32_t [5][MULTI_LANES], const uint32_t [16][MULTI_LANES]);
+	uint32_t st[5][MULTI_LANES];
+	uint32_t w[16][MULTI_LANES];
+	uint32_t h[5];
+	struct multi m;
+	kripto_hash s;
+	const uint8_t *data;
+	unsigned int l;
+
+	(void)sha1_recreate(&s, r, salt, salt_len, out_len);
+
+	/* 8 lanes are no faster than SHA-NI, 16 are */
+	if(kripto_cpu() & KRIPTO_CPU_AVX512) x16 = &sha1_avx512;
+	else if((kripto_cpu() & KRIPTO_CPU_AVX2) && !s.ni) x16 = &sha1_avx2;
+	else x16 = 0;
+
+	if(x16)
+	{
+		memset(w, 0, sizeof(w));
+		multi_init(&m, in, in_len, out, n, MULTI_PAD_BE);
+
+		for(l = 0; l < MULTI_LANES; l++)
+		{
+			if(multi_start(&m, l))
+				for(i = 0; i < 5; i++) st[i][l] = s.h[i];
+		}
+
+		while(multi_active(&m))
+		{
+			for(l = 0; l < MULTI_LANES; l++)
+			{
+				data = multi_block(&m, l);
+				if(!data) continue;
+
+				for(i = 0; i < 16; i++)
+					w[i][l] = LOAD32B(data + (i << 2));
+			}
+
+			x16(st, (const uint32_t (*)[MULTI_LANES])w);
+
+			for(l = 0; l < MULTI_LANES; l++)
+			{
+				if(!multi_done(&m, l)) continue;
+
+				for(i = 0; i < 5; i++) h[i] = st[i][l];
+				STORE32B_ARRAY(h, 0, multi_out(&m, l), out_len);
+
+				if(multi_start(&m, l))
+					for(i = 0; i < 5; i++) st[i][l] = s.h[i];
+			}
+		}
+
+		kripto_memory_wipe(st, sizeof(st));
+		kripto_memory_wipe(w, sizeof(w));
+		kripto_memory_wipe(h, sizeof(h));
+		kripto_memory_wipe(&m, sizeof(m));
+
+		return 0;
+	}
+	#endif
+
+	for(i = 0; i < n; i++)
+		(void)sha1_hash(desc, r, salt, salt_len, in[i], in_len[i], out[i], out_len);
+
+	return 0;
+}
+
 static const kripto_desc_hash sha1 =
 {
 	&sha1_create,
 	&sha1_recreate,
 	&sha1_input,
 	&sha1_output,
+	&sha1_copy,
 	&sha1_destroy,
 	&sha1_hash,
+	&sha1_multi,
+	&sha1_hmac_chain,
 	20, /* max output */
 	64, /* block_size */
 	0 /* max salt */
@@ -16,17 +16,29 @@
 #include <stdint.h>
 #include <stddef.h>
 #include <stdlib.h>
+#include <string.h>
 #include <assert.h>
 
+#if (defined(__GNUC__) || defined(__clang__)) \
+&& (defined(__i386__) || defined(__x86_64__))
+#define SHANI
+#include <immintrin.h>
+#endif
+
 #include <kripto/cast.h>
+#include <kripto/cpu.h>
 #include <kripto/loadstore.h>
 #include <kripto/rotate.h>
 #include <kripto/memory.h>
+#include <kripto/xor.h>
 #include <kripto/hash.h>
 #include <kripto/desc/hash.h>
 
 #include <kripto/hash/sha2_256.h>
 
+#include "../alloc.h"
+#include "multi.h"
+
 struct kripto_hash
 {
 	const kripto_desc_hash *desc;
@@ -36,6 +48,7 @@ struct kripto_hash
 	unsigned int r;
 	unsigned int i;
 	int o;
+	int ni;
 };
 
 static const uint32_t RC[128] =
@@ -90,6 +103,14 @@ static kripto_hash *sha2_256_recreate
 	s->r = r;
 	if(!s->r) s->r = 64;
 
+	#ifdef SHANI
+	s->ni = !(s->r & 15) && (kripto_cpu() & (KRIPTO_CPU_SSSE3
+		| KRIPTO_CPU_SSE41 | KRIPTO_CPU_SHANI)) == (KRIPTO_CPU_SSSE3
+		| KRIPTO_CPU_SSE41 | KRIPTO_CPU_SHANI);
+	#else
+	s->ni = 0;
+	#endif
+
 	if(out_len > 28)
 	{
 		/* 256 */
@@ -212,6 +233,120 @@ static void sha2_256_process(kripto_hash *s, const uint8_t *data)
 	s->h[7] += h;
 }
 
+#ifdef SHANI
+
+#define NI __attribute__((target("sse2,ssse3,sse4.1,sha")))
+
+/* 4 rounds */
+#define NI_ROUNDS(M, I)						\
+{								\
+	t = _mm_add_epi32(M, _mm_loadu_si128((const __m128i *)(RC + (I))));	\
+	cdgh = _mm_sha256rnds2_epu32(cdgh, abef, t);		\
+	t = _mm_shuffle_epi32(t, 0x0E);				\
+	abef = _mm_sha256rnds2_epu32(abef, cdgh, t);		\
+}
+
+/* next 4 words of the message schedule into M0 */
+#define NI_SCHEDULE(M0, M1, M2, M3)				\
+{								\
+	M0 = _mm_sha256msg2_epu32(_mm_add_epi32(		\
+		_mm_sha256msg1_epu32(M0, M1),			\
+		_mm_alignr_epi8(M3, M2, 4)), M3);		\
+}
+
+NI static void ni_process
+(
+	kripto_hash *s,
+	const uint8_t *data,
+	size_t blocks
+)
+{
+	const __m128i bswap = _mm_set_epi64x
+	(
+		0x0C0D0E0F08090A0BULL,
+		0x0405060700010203ULL
+	);
+	__m128i abef;
+	__m128i cdgh;
+	__m128i abef0;
+	__m128i cdgh0;
+	__m128i m0;
+	__m128i m1;
+	__m128i m2;
+	__m128i m3;
+	__m128i t;
+	unsigned int i;
+
+	/* ABCD EFGH -> ABEF CDGH */
+	t = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)s->h), 0xB1);
+	cdgh = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)s->h + 1), 0x1B);
+	abef = _mm_alignr_epi8(t, cdgh, 8);
+	cdgh = _mm_blend_epi16(cdgh, t, 0xF0);
+
+	for(; blocks; blocks--)
+	{
+		abef0 = abef;
+		cdgh0 = cdgh;
+
+		m0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)data), bswap);
+		m1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)data + 1), bswap);
+		m2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)data + 2), bswap);
+		m3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)data + 3), bswap);
+
+		NI_ROUNDS(m0, 0);
+		NI_ROUNDS(m1, 4);
+		NI_ROUNDS(m2, 8);
+		NI_ROUNDS(m3, 12);
+
+		for(i = 16; i < s->r; i += 16)
+		{
+			NI_SCHEDULE(m0, m1, m2, m3);
+			NI_ROUNDS(m0, i);
+			NI_SCHEDULE(m1, m2, m3, m0);
+			NI_ROUNDS(m1, i + 4);
+			NI_SCHEDULE(m2, m3, m0, m1);
+			NI_ROUNDS(m2, i + 8);
+			NI_SCHEDULE(m3, m0, m1, m2);
+			NI_ROUNDS(m3, i + 12);
+		}
+
+		abef = _mm_add_epi32(abef, abef0);
+		cdgh = _mm_add_epi32(cdgh, cdgh0);
+
+		data += 64;
+	}
+
+	/* ABEF CDGH -> ABCD EFGH */
+	t = _mm_shuffle_epi32(abef, 0x1B);
+	cdgh = _mm_shuffle_epi32(cdgh, 0xB1);
+	_mm_storeu_si128((__m128i *)s->h, _mm_blend_epi16(t, cdgh, 0xF0));
+	_mm_storeu_si128((__m128i *)s->h + 1, _mm_alignr_epi8(cdgh, t, 8));
+}
+
+#endif
+
+static void sha2_256_blocks
+(
+	kripto_hash *s,
+	const uint8_t *data,
+	size_t blocks
+)
+{
+	#ifdef SHANI
+	if(s->ni)
+	{
+		ni_process(s, data, blocks);
+		return;
+	}
+	#endif
+
+	for(; blocks; blocks--)
+	{
+		sha2_256_process(s, data);
+		data += 64;
+	}
+}
+
 static void sha2_256_input
 (
 	kripto_hash *s,
@@ -219,19 +354,41 @@ static void sha2_256_input
 	size_t len
 ) 
 {
-	for(size_t i = 0; i < len; i++)
+	size_t n;
+
+	/* fill buffer */
+	for(; len && s->i; len--)
 	{
-		s->buf[s->i++] = CU8(in)[i];
+		s->buf[s->i++] = *CU8(in);
+		in = CU8(in) + 1;
 
 		if(s->i == 64)
 		{
 			s->len += 512;
 			assert(s->len >= 512);
 
-			sha2_256_process(s, s->buf);
+			sha2_256_blocks(s, s->buf, 1);
 			s->i = 0;
 		}
 	}
+
+	/* whole blocks straight from input */
+	n = len >> 6;
+	if(n)
+	{
+		s->len += (uint64_t)n << 9;
+		assert(s->len >= ((uint64_t)n << 9));
+
+		sha2_256_blocks(s, CU8(in), n);
+		in = CU8(in) + (n << 6);
+		len &= 63;
+	}
+
+	for(; len; len--)
+	{
+		s->buf[s->i++] = *CU8(in);
+		in = CU8(in) + 1;
+	}
 }
 
 static void sha2_256_finish(kripto_hash *s)
@@ -244,7 +401,7 @@ static void sha2_256_finish(kripto_hash *s)
 	if(s->i > 56) /* not enough space for length */
 	{
 		while(s->i < 64) s->buf[s->i++] = 0;
-		sha2_256_process(s, s->buf);
+		sha2_256_blocks(s, s->buf, 1);
 		s->i = 0;
 	}
 	while(s->i < 56) s->buf[s->i++] = 0;
@@ -252,7 +409,7 @@ static void sha2_256_finish(kripto_hash *s)
 	/* add length */
 	STORE64B(s->len, s->buf + 56);
 
-	sha2_256_process(s, s->buf);
+	sha2_256_blocks(s, s->buf, 1);
 
 	s->i = 0;
 	s->o = -1;
@@ -267,6 +424,56 @@ static void sha2_256_output(kripto_hash *s, void *out, size_t len)
 	s->i += len;
 }
 
+static void sha2_256_copy(const kripto_hash *s, kripto_hash *c)
+{
+	*c = *s;
+}
+
+static int sha2_256_hmac_chain
+(
+	const kripto_hash *inner,
+	const kripto_hash *outer,
+	const void *u,
+	void *t,
+	unsigned int len,
+	unsigned int iter
+)
+{
+	kripto_hash s;
+	uint8_t block[64];
+	unsigned int i;
+
+	/* keyed states must sit right after the key block */
+	if(len > 32 || inner->i || outer->i || inner->o || outer->o
+	|| inner->len != 512 || outer->len != 512) return -1;
+
+	s = *inner;
+
+	/* key block and one digest, padding stays fixed */
+	memcpy(block, u, len);
+	block[len] = 0x80;
+	memset(block + len + 1, 0, 64 - 9 - len);
+	STORE64B((uint64_t)(64 + len) << 3, block + 56);
+
+	for(i = 1; i < iter; i++)
+	{
+		memcpy(s.h, inner->h, sizeof(s.h));
+		sha2_256_blocks(&s, block, 1);
+		STORE32B_ARRAY(s.h, 0, block, len);
+
+		memcpy(s.h, outer->h, sizeof(s.h));
+		sha2_256_blocks(&s, block, 1);
+		STORE32B_ARRAY(s.h, 0, block, len);
+
+		XOR(t, block, t, len);
+	}
+
+	kripto_memory_wipe(&s, sizeof(kripto_hash));
+	kripto_memory_wipe(block, 64);
+
+	return 0;
+}
+
 static kripto_hash *sha2_256_create
 (
 	const kripto_desc_hash *desc,
@@ -276,7 +483,7 @@ static kripto_hash *sha2_256_create
 	unsigned int out_len
 )
 {
-	kripto_hash *s = (kripto_hash *)malloc(sizeof(kripto_hash));
+	kripto_hash *s = (kripto_hash *)kripto_alloc(sizeof(kripto_hash));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -287,7 +494,7 @@ static kripto_hash *sha2_256_create
 static void sha2_256_destroy(kripto_hash *s)
 {
 	kripto_memory_wipe(s, sizeof(kripto_hash));
-	free(s);
+	kripto_free(s);
 }
 
 static int sha2_256_hash
@@ -314,14 +521,209 @@ static int sha2_256_hash
 	return 0;
 }
 
+#ifdef KRIPTO_MULTI_SIMD
+
+#define V_S0(X) (MULTI_ROL(X, 25) ^ MULTI_ROL(X, 14) ^ ((X) >> 3))
+#define V_S1(X) (MULTI_ROL(X, 15) ^ MULTI_ROL(X, 13) ^ ((X) >> 10))
+
+#define V_E0(X) (MULTI_ROL(X, 30) ^ MULTI_ROL(X, 19) ^ MULTI_ROL(X, 10))
+#define V_E1(X) (MULTI_ROL(X, 26) ^ MULTI_ROL(X, 21) ^ MULTI_ROL(X, 7))
+
+#define V_ROUND(A, B, C, D, E, F, G, H, RC, RK)		\
+{							\
+	H += V_E1(E) + CH(E, F, G) + RC + RK;		\
+	D += H;						\
+	H += V_E0(A) + MAJ(A, B, C);			\
+}
+
+#define V_KI(K, I)					\
+(							\
+	K[I & 15] += V_S0(K[(I + 1) & 15])		\
+		+ K[(I + 9) & 15]			\
+		+ V_S1(K[(I + 14) & 15])		\
+)
+
+/* one compression in each of 16 lanes */
+MULTI_INLINE void sha2_256_x16
+(
+	uint32_t st[8][MULTI_LANES],
+	const uint32_t w[16][MULTI_LANES],
+	unsigned int r
+)
+{
+	multi_v16 a;
+	multi_v16 b;
+	multi_v16 c;
+	multi_v16 d;
+	multi_v16 e;
+	multi_v16 f;
+	multi_v16 g;
+	multi_v16 h;
+	multi_v16 t;
+	multi_v16 k[16];
+	unsigned int i;
+
+	MULTI_LOAD(a, st[0]);
+	MULTI_LOAD(b, st[1]);
+	MULTI_LOAD(c, st[2]);
+	MULTI_LOAD(d, st[3]);
+	MULTI_LOAD(e, st[4]);
+	MULTI_LOAD(f, st[5]);
+	MULTI_LOAD(g, st[6]);
+	MULTI_LOAD(h, st[7]);
+
+	for(i = 0; i < 16; i++)
+		MULTI_LOAD(k[i], w[i]);
+
+	for(i = 0; i < 16;)
+	{
+		V_ROUND(a, b, c, d, e, f, g, h, RC[i], k[i]); i++;
+		V_ROUND(h, a, b, c, d, e, f, g, RC[i], k[i]); i++;
+		V_ROUND(g, h, a, b, c, d, e, f, RC[i], k[i]); i++;
+		V_ROUND(f, g, h, a, b, c, d, e, RC[i], k[i]); i++;
+		V_ROUND(e, f, g, h, a, b, c, d, RC[i], k[i]); i++;
+		V_ROUND(d, e, f, g, h, a, b, c, RC[i], k[i]); i++;
+		V_ROUND(c, d, e, f, g, h, a, b, RC[i], k[i]); i++;
+		V_ROUND(b, c, d, e, f, g, h, a, RC[i], k[i]); i++;
+	}
+
+	while(i < r)
+	{
+		V_ROUND(a, b, c, d, e, f, g, h, RC[i], V_KI(k, i)); i++;
+		V_ROUND(h, a, b, c, d, e, f, g, RC[i], V_KI(k, i)); i++;
+		V_ROUND(g, h, a, b, c, d, e, f, RC[i], V_KI(k, i)); i++;
+		V_ROUND(f, g, h, a, b, c, d, e, RC[i], V_KI(k, i)); i++;
+		V_ROUND(e, f, g, h, a, b, c, d, RC[i], V_KI(k, i)); i++;
+		V_ROUND(d, e, f, g, h, a, b, c, RC[i], V_KI(k, i)); i++;
+		V_ROUND(c, d, e, f, g, h, a, b, RC[i], V_KI(k, i)); i++;
+		V_ROUND(b, c, d, e, f, g, h, a, RC[i], V_KI(k, i)); i++;
+	}
+
+	MULTI_LOAD(t, st[0]); a += t; MULTI_STORE(st[0], a);
+	MULTI_LOAD(t, st[1]); b += t; MULTI_STORE(st[1], b);
+	MULTI_LOAD(t, st[2]); c += t; MULTI_STORE(st[2], c);
+	MULTI_LOAD(t, st[3]); d += t; MULTI_STORE(st[3], d);
+	MULTI_LOAD(t, st[4]); e += t; MULTI_STORE(st[4], e);
+	MULTI_LOAD(t, st[5]); f += t; MULTI_STORE(st[5], f);
+	MULTI_LOAD(t, st[6]); g += t; MULTI_STORE(st[6], g);
+	MULTI_LOAD(t, st[7]); h += t; MULTI_STORE(st[7], h);
+}
+
+MULTI_AVX512 static void sha2_256_avx512
+(
+	uint32_t st[8][MULTI_LANES],
+	const uint32_t w[16][MULTI_LANES],
+	unsigned int r
+)
+{
+	sha2_256_x16(st, w, r);
+}
+
+MULTI_AVX2 static void sha2_256_avx2
+(
+	uint32_t st[8][MULTI_LANES],
+	const uint32_t w[16][MULTI_LANES],
+	unsigned int r
+)
+{
+	sha2_256_x16(st, w, r);
+}
+
+#endif
+
+static int sha2_256_multi
+(
+	const kripto_desc_hash *desc,
+	unsigned int r,
+	const void *salt,
+	unsigned int salt_len,
+	const void *const *in,
+	const size_t *in_len,
+	void *const *out,
+	size_t out_len,
+	unsigned int n
+)
+{
+	unsigned int i;
+	#ifdef KRIPTO_MULTI_SIMD
+	void (*x16)(uint32_t [8][MULTI_LANES], const uint32_t [16][MULTI_LANES], unsigned int);
+	uint32_t st[8][MULTI_LANES];
+	uint32_t w[16][MULTI_LANES];
+	uint32_t h[8];
+	struct multi m;
+	kripto_hash s;
+	const uint8_t *data;
+	unsigned int l;
+
+	(void)sha2_256_recreate(&s, r, salt, salt_len, out_len);
+
+	/* 8 lanes are no faster than SHA-NI, 16 are */
+	if(kripto_cpu() & KRIPTO_CPU_AVX512) x16 = &sha2_256_avx512;
+	else if((kripto_cpu() & KRIPTO_CPU_AVX2) && !s.ni) x16 = &sha2_256_avx2;
+	else x16 = 0;
+
+	if(x16)
+	{
+		memset(w, 0, sizeof(w));
+		multi_init(&m, in, in_len, out, n, MULTI_PAD_BE);
+
+		for(l = 0; l < MULTI_LANES; l++)
+		{
+			if(multi_start(&m, l))
+				for(i = 0; i < 8; i++) st[i][l] = s.h[i];
+		}
+
+		while(multi_active(&m))
+		{
+			for(l = 0; l < MULTI_LANES; l++)
+			{
+				data = multi_block(&m, l);
+				if(!data) continue;
+
+				for(i = 0; i < 16; i++)
+					w[i][l] = LOAD32B(data + (i << 2));
+			}
+
+			x16(st, (const uint32_t (*)[MULTI_LANES])w, s.r);
+
+			for(l = 0; l < MULTI_LANES; l++)
+			{
+				if(!multi_done(&m, l)) continue;
+
+				for(i = 0; i < 8; i++) h[i] = st[i][l];
+				STORE32B_ARRAY(h, 0, multi_out(&m, l), out_len);
+
+				if(multi_start(&m, l))
+					for(i = 0; i < 8; i++) st[i][l] = s.h[i];
+			}
+		}
+
+		kripto_memory_wipe(st, sizeof(st));
+		kripto_memory_wipe(w, sizeof(w));
+		kripto_memory_wipe(h, sizeof(h));
+		kripto_memory_wipe(&m, sizeof(m));
+
+		return 0;
+	}
+	#endif
+
+	for(i = 0; i < n; i++)
+		(void)sha2_256_hash(desc, r, salt, salt_len, in[i], in_len[i], out[i], out_len);
+
+	return 0;
+}
+
 static const kripto_desc_hash sha2_256 =
 {
 	&sha2_256_create,
 	&sha2_256_recreate,
 	&sha2_256_input,
 	&sha2_256_output,
+	&sha2_256_copy,
 	&sha2_256_destroy,
 	&sha2_256_hash,
+	&sha2_256_multi,
+	&sha2_256_hmac_chain,
 	32, /* max output */
 	64, /* block_size */
 	0 /* max salt */
@@ -16,17 +16,21 @@
 #include <stdint.h>
 #include <stddef.h>
 #include <stdlib.h>
+#include <string.h>
 #include <assert.h>
 
 #include <kripto/cast.h>
 #include <kripto/loadstore.h>
 #include <kripto/rotate.h>
 #include <kripto/memory.h>
+#include <kripto/xor.h>
 #include <kripto/hash.h>
 #include <kripto/desc/hash.h>
 
 #include <kripto/hash/sha2_512.h>
 
+#include "../alloc.h"
+
 struct kripto_hash
 {
 	const kripto_desc_hash *desc;
@@ -324,6 +328,58 @@ static void sha2_512_output(kripto_hash *s, void *out, size_t len)
 	s->i += len;
 }
 
+static void sha2_512_copy(const kripto_hash *s, kripto_hash *c)
+{
+	*c = *s;
+}
+
+static int sha2_512_hmac_chain
+(
+	const kripto_hash *inner,
+	const kripto_hash *outer,
+	const void *u,
+	void *t,
+	unsigned int len,
+	unsigned int iter
+)
+{
+	kripto_hash s;
+	uint8_t block[128];
+	unsigned int i;
+
+	/* keyed states must sit right after the key block */
+	if(len > 64 || inner->i || outer->i || inner->o || outer->o
+	|| inner->len[0] != 1024 || inner->len[1]
+	|| outer->len[0] != 1024 || outer->len[1]) return -1;
+
+	s = *inner;
+
+	/* key block and one digest, padding stays fixed */
+	memcpy(block, u, len);
+	block[len] = 0x80;
+	memset(block + len + 1, 0, 128 - 9 - len);
+	memset(block + 112, 0, 8);
+	STORE64B((uint64_t)(128 + len) << 3, block + 120);
+
+	for(i = 1; i < iter; i++)
+	{
+		memcpy(s.h, inner->h, sizeof(s.h));
+		sha2_512_process(&s, block);
+		STORE64B_ARRAY(s.h, 0, block, len);
+
+		memcpy(s.h, outer->h, sizeof(s.h));
+		sha2_512_process(&s, block);
+		STORE64B_ARRAY(s.h, 0, block, len);
+
+		XOR(t, block, t, len);
+	}
+
+	kripto_memory_wipe(&s, sizeof(kripto_hash));
+	kripto_memory_wipe(block, 128);
+
+	return 0;
+}
+
 static kripto_hash *sha2_512_create
 (
 	const kripto_desc_hash *desc,
@@ -333,7 +389,7 @@ static kripto_hash *sha2_512_create
 	unsigned int out_len
 )
 {
-	kripto_hash *s = (kripto_hash *)malloc(sizeof(kripto_hash));
+	kripto_hash *s = (kripto_hash *)kripto_alloc(sizeof(kripto_hash));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -344,7 +400,7 @@ static kripto_hash *sha2_512_create
 static void sha2_512_destroy(kripto_hash *s)
 {
 	kripto_memory_wipe(s, sizeof(kripto_hash));
-	free(s);
+	kripto_free(s);
 }
 
 static int sha2_512_hash
@@ -377,8 +433,11 @@ static const kripto_desc_hash sha2_512 =
 	&sha2_512_recreate,
 	&sha2_512_input,
 	&sha2_512_output,
+	&sha2_512_copy,
 	&sha2_512_destroy,
 	&sha2_512_hash,
+	0, /* hash multi */
+	&sha2_512_hmac_chain,
 	64, /* max output */
 	128, /* block_size */
 	0 /* max salt */
@@ -29,6 +29,8 @@
 
 #include <kripto/hash/skein1024.h>
 
+#include "../alloc.h"
+
 struct kripto_hash
 {
 	const kripto_desc_hash *desc;
@@ -191,6 +193,14 @@ static void skein1024_output(kripto_hash *s, void *out, size_t len)
 	}
 }
 
+static void skein1024_copy(const kripto_hash *s, kripto_hash *c)
+{
+	kripto_block *block = c->block;
+
+	*c = *s;
+	c->block = block;
+}
+
 static kripto_hash *skein1024_create
 (
 	const kripto_desc_hash *desc,
@@ -200,7 +210,7 @@ static kripto_hash *skein1024_create
 	unsigned int out_len
 )
 {
-	kripto_hash *s = (kripto_hash *)malloc(sizeof(kripto_hash));
+	kripto_hash *s = (kripto_hash *)kripto_alloc(sizeof(kripto_hash));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -208,7 +218,7 @@ static kripto_hash *skein1024_create
 	s->block = kripto_block_create(kripto_block_threefish1024, r, "", 1);
 	if(!s->block)
 	{
-		free(s);
+		kripto_free(s);
 		return 0;
 	}
 
@@ -219,7 +229,7 @@ static void skein1024_destroy(kripto_hash *s)
 {
 	kripto_block_destroy(s->block);
 	kripto_memory_wipe(s, sizeof(kripto_hash));
-	free(s);
+	kripto_free(s);
 }
 
 static int skein1024_hash
@@ -256,8 +266,11 @@ static const kripto_desc_hash skein1024 =
 	&skein1024_recreate,
 	&skein1024_input,
 	&skein1024_output,
+	&skein1024_copy,
 	&skein1024_destroy,
 	&skein1024_hash,
+	0, /* hash multi */
+	0, /* hmac chain */
 	0, /* max output */
 	128, /* block_size */
 	UINT_MAX /* max salt */
@@ -26,6 +26,8 @@
 
 #include <kripto/hash/tiger.h>
 
+#include "../alloc.h"
+
 struct kripto_hash
 {
 	const kripto_desc_hash *desc;
@@ -750,6 +752,11 @@ static void tiger_output(kripto_hash *s, void *out, size_t len)
 	s->i += len;
 }
 
+static void tiger_copy(const kripto_hash *s, kripto_hash *c)
+{
+	*c = *s;
+}
+
 static kripto_hash *tiger_create
 (
 	const kripto_desc_hash *desc,
@@ -759,7 +766,7 @@ static kripto_hash *tiger_create
 	unsigned int out_len
 )
 {
-	kripto_hash *s = (kripto_hash *)malloc(sizeof(kripto_hash));
+	kripto_hash *s = (kripto_hash *)kripto_alloc(sizeof(kripto_hash));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -770,7 +777,7 @@ static kripto_hash *tiger_create
 static void tiger_destroy(kripto_hash *s)
 {
 	kripto_memory_wipe(s, sizeof(kripto_hash));
-	free(s);
+	kripto_free(s);
 }
 
 static int tiger_hash
@@ -803,8 +810,11 @@ static const kripto_desc_hash tiger =
 	&tiger_recreate,
 	&tiger_input,
 	&tiger_output,
+	&tiger_copy,
 	&tiger_destroy,
 	&tiger_hash,
+	0, /* hash multi */
+	0, /* hmac chain */
 	24, /* max output */
 	64, /* block_size */
 	0 /* max salt */
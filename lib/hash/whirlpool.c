@@ -37,6 +37,8 @@
 
 #include <kripto/hash/whirlpool.h>
 
+#include "../alloc.h"
+
 struct kripto_hash
 {
 	const kripto_desc_hash *desc;
@@ -986,6 +988,11 @@ static void whirlpool_output(kripto_hash *s, void *out, size_t len)
 	s->i += len;
 }
 
+static void whirlpool_copy(const kripto_hash *s, kripto_hash *c)
+{
+	*c = *s;
+}
+
 static kripto_hash *whirlpool_create
 (
 	const kripto_desc_hash *desc,
@@ -995,7 +1002,7 @@ static kripto_hash *whirlpool_create
 	unsigned int out_len
 )
 {
-	kripto_hash *s = (kripto_hash *)malloc(sizeof(kripto_hash));
+	kripto_hash *s = (kripto_hash *)kripto_alloc(sizeof(kripto_hash));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -1006,7 +1013,7 @@ static kripto_hash *whirlpool_create
 static void whirlpool_destroy(kripto_hash *s)
 {
 	kripto_memory_wipe(s, sizeof(kripto_hash));
-	free(s);
+	kripto_free(s);
 }
 
 static int whirlpool_hash
@@ -1039,8 +1046,11 @@ static const kripto_desc_hash whirlpool =
 	&whirlpool_recreate,
 	&whirlpool_input,
 	&whirlpool_output,
+	&whirlpool_copy,
 	&whirlpool_destroy,
 	&whirlpool_hash,
+	0, /* hash multi */
+	0, /* hmac chain */
 	64, /* max output */
 	64, /* block_size */
 	0 /* max salt */
@@ -14,11 +14,14 @@
  */
 
 #include <assert.h>
+#include <stdlib.h>
 
 #include <kripto/memory.h>
 #include <kripto/mac.h>
 #include <kripto/desc/mac.h>
 
+#include "alloc.h"
+
 struct kripto_mac
 {
 	const kripto_desc_mac *desc;
@@ -79,6 +82,32 @@ void kripto_mac_tag(kripto_mac *s, void *tag, unsigned int len)
 	s->desc->tag(s, tag, len);
 }
 
+void kripto_mac_reset(kripto_mac *s)
+{
+	assert(s);
+	assert(s->desc);
+	assert(s->desc->reset);
+
+	s->desc->reset(s);
+}
+
+void kripto_mac_chain
+(
+	kripto_mac *s,
+	void *u,
+	void *t,
+	unsigned int len,
+	unsigned int iter
+)
+{
+	assert(s);
+	assert(s->desc);
+	assert(s->desc->chain);
+	assert(iter);
+
+	s->desc->chain(s, u, t, len, iter);
+}
+
 int kripto_mac_verify(kripto_mac *s, const void *tag, unsigned int len)
 {
 	assert(s);
@@ -99,6 +128,67 @@ void kripto_mac_destroy(kripto_mac *s)
 	s->desc->destroy(s);
 }
 
+/* create with a zero key, counting what it takes */
+size_t kripto_mac_ctx_size
+(
+	const kripto_desc_mac *desc,
+	unsigned int rounds,
+	unsigned int key_len,
+	unsigned int tag_len
+)
+{
+	struct kripto_alloc_arena a;
+	kripto_mac *s;
+	void *zero;
+	size_t len;
+
+	assert(desc);
+	assert(desc->create);
+
+	zero = calloc(key_len + 1, 1);
+	if(!zero) return 0;
+
+	kripto_alloc_begin(&a, 0, 0);
+	s = kripto_mac_create(desc, rounds, zero, key_len, tag_len);
+	len = kripto_alloc_end(&a);
+
+	free(zero);
+
+	if(!s) return 0;
+	kripto_mac_destroy(s);
+
+	return len;
+}
+
+kripto_mac *kripto_mac_init
+(
+	const kripto_desc_mac *desc,
+	void *mem,
+	size_t len,
+	unsigned int rounds,
+	const void *key,
+	unsigned int key_len,
+	unsigned int tag_len
+)
+{
+	struct kripto_alloc_arena a;
+	kripto_mac *s;
+
+	assert(mem);
+
+	kripto_alloc_begin(&a, mem, len);
+	s = kripto_mac_create(desc, rounds, key, key_len, tag_len);
+	(void)kripto_alloc_end(&a);
+
+	return s;
+}
+
+/* destroy wipes, kripto_free leaves caller memory alone */
+void kripto_mac_fini(kripto_mac *s)
+{
+	kripto_mac_destroy(s);
+}
+
 int kripto_mac_all
 (
 	const kripto_desc_mac *desc,
@@ -147,3 +237,17 @@ unsigned int kripto_mac_maxkey(const kripto_desc_mac *desc)
 
 	return desc->maxkey;
 }
+
+int kripto_mac_resettable(const kripto_desc_mac *desc)
+{
+	assert(desc);
+
+	return desc->reset != 0;
+}
+
+int kripto_mac_chainable(const kripto_desc_mac *desc)
+{
+	assert(desc);
+
+	return desc->chain != 0;
+}
@@ -19,22 +19,34 @@
 #include <limits.h>
 
 #include <kripto/memory.h>
+#include <kripto/xor.h>
 #include <kripto/hash.h>
+#include <kripto/desc/hash.h>
 #include <kripto/mac.h>
 #include <kripto/desc/mac.h>
 
 #include <kripto/mac/hmac.h>
 
+#include "../alloc.h"
+
 struct kripto_mac
 {
 	const kripto_desc_mac *desc;
 	kripto_hash *hash;
+	kripto_hash *inner;
+	kripto_hash *outer;
 	size_t size;
 	unsigned int r;
 	unsigned int blocksize;
+	unsigned int tag_len;
 	uint8_t *key;
 };
 
+/*
+ * Keyed inner and outer states are hashed once here and copied
+ * on every reset and tag, so neither key block is compressed again.
+ * key keeps the outer block for tags of other lengths.
+ */
 static int hmac_init
 (
 	kripto_mac *s,
@@ -47,6 +59,7 @@ static int hmac_init
 	unsigned int i;
 
 	s->blocksize = kripto_hash_blocksize(hash);
+	s->tag_len = tag_len;
 
 	if(key_len > s->blocksize)
 	{
@@ -73,7 +86,14 @@ static int hmac_init
 
 	while(i--) s->key[i] ^= 0x36;
 
-	kripto_hash_input(s->hash, s->key, s->blocksize);
+	kripto_hash_input(s->inner, s->key, s->blocksize);
+
+	for(i = 0; i < s->blocksize; i++)
+		s->key[i] ^= 0x6A; /* 0x5C ^ 0x36 */
+
+	kripto_hash_input(s->outer, s->key, s->blocksize);
+
+	kripto_hash_copy(s->inner, s->hash);
 
 	return 0;
 }
@@ -85,25 +105,61 @@ static void hmac_input(kripto_mac *s, const void *in, size_t len)
 
 static void hmac_tag(kripto_mac *s, void *tag, unsigned int len)
 {
-	unsigned int i;
-
-	for(i = 0; i < s->blocksize; i++)
-		s->key[i] ^= 0x6A; /* 0x5C ^ 0x36 */
-
 	kripto_hash_output(s->hash, tag, len);
 
-	kripto_hash_recreate(s->hash, s->r, 0, 0, len);
-	kripto_hash_input(s->hash, s->key, i);
+	if(len == s->tag_len)
+	{
+		kripto_hash_copy(s->outer, s->hash);
+	}
+	else
+	{
+		kripto_hash_recreate(s->hash, s->r, 0, 0, len);
+		kripto_hash_input(s->hash, s->key, s->blocksize);
+	}
+
 	kripto_hash_input(s->hash, tag, len);
 	kripto_hash_output(s->hash, tag, len);
 }
 
+static void hmac_reset(kripto_mac *s)
+{
+	kripto_hash_copy(s->inner, s->hash);
+}
+
+/* t ^= U_2 .. U_iter where U_1 = u, straight on the midstates */
+static void hmac_chain
+(
+	kripto_mac *s,
+	void *u,
+	void *t,
+	unsigned int len,
+	unsigned int iter
+)
+{
+	const kripto_desc_hash *hash = kripto_hash_getdesc(s->hash);
+	unsigned int i;
+
+	if(len == s->tag_len && hash->hmac_chain
+	&& !hash->hmac_chain(s->inner, s->outer, u, t, len, iter)) return;
+
+	for(i = 1; i < iter; i++)
+	{
+		hmac_reset(s);
+		hmac_input(s, u, len);
+		hmac_tag(s, u, len);
+
+		XOR(t, u, t, len);
+	}
+}
+
 static void hmac_destroy(kripto_mac *s)
 {
-	kripto_hash_destroy(s->hash);
+	if(s->hash) kripto_hash_destroy(s->hash);
+	if(s->inner) kripto_hash_destroy(s->inner);
+	if(s->outer) kripto_hash_destroy(s->outer);
 
 	kripto_memory_wipe(s, s->size);
-	free(s);
+	kripto_free(s);
 }
 
 struct ext
@@ -123,7 +179,7 @@ static kripto_mac *hmac_create
 	unsigned int tag_len
 )
 {
-	kripto_mac *s = (kripto_mac *)malloc(sizeof(kripto_mac) + kripto_hash_blocksize(EXT(desc)->hash));
+	kripto_mac *s = (kripto_mac *)kripto_alloc(sizeof(kripto_mac) + kripto_hash_blocksize(EXT(desc)->hash));
 	if(!s) return 0;
 
 	s->key = (uint8_t *)s + sizeof(kripto_mac);
@@ -132,9 +188,11 @@ static kripto_mac *hmac_create
 	s->size = sizeof(kripto_mac) + kripto_hash_blocksize(EXT(desc)->hash);
 	s->r = r;
 	s->hash = kripto_hash_create(EXT(desc)->hash, r, 0, 0, tag_len);
-	if(!s->hash)
+	s->inner = kripto_hash_create(EXT(desc)->hash, r, 0, 0, tag_len);
+	s->outer = kripto_hash_create(EXT(desc)->hash, r, 0, 0, tag_len);
+	if(!s->hash || !s->inner || !s->outer)
 	{
-		free(s);
+		hmac_destroy(s);
 		return 0;
 	}
 
@@ -157,10 +215,11 @@ static kripto_mac *hmac_recreate
 )
 {
 	s->hash = kripto_hash_recreate(s->hash, r, 0, 0, tag_len);
-	if(!s->hash)
+	s->inner = kripto_hash_recreate(s->inner, r, 0, 0, tag_len);
+	s->outer = kripto_hash_recreate(s->outer, r, 0, 0, tag_len);
+	if(!s->hash || !s->inner || !s->outer)
 	{
-		kripto_memory_wipe(s, s->size);
-		free(s);
+		hmac_destroy(s);
 		return 0;
 	}
 
@@ -186,6 +245,8 @@ kripto_desc_mac *kripto_mac_hmac(const kripto_desc_hash *hash)
 	s->desc.recreate = &hmac_recreate;
 	s->desc.input = &hmac_input;
 	s->desc.tag = &hmac_tag;
+	s->desc.reset = &hmac_reset;
+	s->desc.chain = &hmac_chain;
 	s->desc.destroy = &hmac_destroy;
 	s->desc.maxtag = kripto_hash_maxout(hash);
 	s->desc.maxkey = UINT_MAX;
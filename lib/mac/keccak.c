@@ -28,6 +28,8 @@
 #include <kripto/mac/keccak1600.h>
 #include <kripto/mac/keccak800.h>
 
+#include "../alloc.h"
+
 struct kripto_mac
 {
 	const kripto_desc_mac *desc;
@@ -74,7 +76,7 @@ static kripto_mac *keccak1600_create
 	unsigned int tag_len
 )
 {
-	kripto_mac *s = (kripto_mac *)malloc(sizeof(kripto_mac));
+	kripto_mac *s = (kripto_mac *)kripto_alloc(sizeof(kripto_mac));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -82,7 +84,7 @@ static kripto_mac *keccak1600_create
 	s->hash = kripto_hash_create(kripto_hash_keccak1600, r, 0, 0, tag_len);
 	if(!s->hash)
 	{
-		free(s);
+		kripto_free(s);
 		return 0;
 	}
 
@@ -100,7 +102,7 @@ static kripto_mac *keccak800_create
 	unsigned int tag_len
 )
 {
-	kripto_mac *s = (kripto_mac *)malloc(sizeof(kripto_mac));
+	kripto_mac *s = (kripto_mac *)kripto_alloc(sizeof(kripto_mac));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -108,7 +110,7 @@ static kripto_mac *keccak800_create
 	s->hash = kripto_hash_create(kripto_hash_keccak800, r, 0, 0, tag_len);
 	if(!s->hash)
 	{
-		free(s);
+		kripto_free(s);
 		return 0;
 	}
 
@@ -120,7 +122,7 @@ static kripto_mac *keccak800_create
 static void keccak_destroy(kripto_mac *s)
 {
 	kripto_hash_destroy(s->hash);
-	free(s);
+	kripto_free(s);
 }
 
 static const kripto_desc_mac keccak1600 =
@@ -129,6 +131,8 @@ static const kripto_desc_mac keccak1600 =
 	&keccak_recreate,
 	&keccak_input,
 	&keccak_tag,
+	0, /* reset */
+	0, /* chain */
 	&keccak_destroy,
 	99, /* max tag */
 	UINT_MAX /* max key */
@@ -142,6 +146,8 @@ static const kripto_desc_mac keccak800 =
 	&keccak_recreate,
 	&keccak_input,
 	&keccak_tag,
+	0, /* reset */
+	0, /* chain */
 	&keccak_destroy,
 	49, /* max tag */
 	UINT_MAX /* max key */
@@ -26,6 +26,9 @@
 
 #include <kripto/mac/omac.h>
 
+#include "../alloc.h"
+#include "../desc.h"
+
 struct kripto_mac
 {
 	const kripto_desc_mac *desc;
@@ -424,7 +427,7 @@ static void omac_destroy(kripto_mac *s)
 	kripto_block_destroy(s->block);
 
 	kripto_memory_wipe(s, sizeof(kripto_mac) + s->len * 4);
-	free(s);
+	kripto_free(s);
 }
 
 struct ext
@@ -444,7 +447,7 @@ static kripto_mac *omac_create
 	unsigned int tag_len
 )
 {
-	kripto_mac *s = (kripto_mac *)malloc(sizeof(kripto_mac) + desc->maxtag * 4);
+	kripto_mac *s = (kripto_mac *)kripto_alloc(sizeof(kripto_mac) + desc->maxtag * 4);
 	if(!s) return 0;
 
 	(void)tag_len;
@@ -458,7 +461,7 @@ static kripto_mac *omac_create
 	s->block = kripto_block_create(EXT(desc)->block, r, key, key_len);
 	if(!s->block)
 	{
-		free(s);
+		kripto_free(s);
 		return 0;
 	}
 
@@ -482,7 +485,7 @@ static kripto_mac *omac_recreate
 	if(!s->block)
 	{
 		kripto_memory_wipe(s, sizeof(kripto_mac) + s->desc->maxtag * 4);
-		free(s);
+		kripto_free(s);
 		return 0;
 	}
 
@@ -491,9 +494,12 @@ static kripto_mac *omac_recreate
 	return s;
 }
 
-kripto_desc_mac *kripto_mac_omac(const kripto_desc_block *block)
+static kripto_desc_mac *omac_desc
+(
+	struct ext *s,
+	const kripto_desc_block *block
+)
 {
-	struct ext *s = (struct ext *)malloc(sizeof(struct ext));
 	if(!s) return 0;
 
 	s->block = block;
@@ -502,6 +508,8 @@ kripto_desc_mac *kripto_mac_omac(const kripto_desc_block *block)
 	s->desc.recreate = &omac_recreate;
 	s->desc.input = &omac_input;
 	s->desc.tag = &omac_tag;
+	s->desc.reset = 0;
+	s->desc.chain = 0;
 	s->desc.destroy = &omac_destroy;
 	s->desc.maxtag = kripto_block_size(block);
 	s->desc.maxkey = kripto_block_maxkey(block);
@@ -510,3 +518,13 @@ kripto_desc_mac *kripto_mac_omac(const kripto_desc_block *block)
 
 	return (kripto_desc_mac *)s;
 }
+
+kripto_desc_mac *kripto_mac_omac(const kripto_desc_block *block)
+{
+	return omac_desc((struct ext *)malloc(sizeof(struct ext)), block);
+}
+
+kripto_desc_mac *kripto_mac_omac_alloc(const kripto_desc_block *block)
+{
+	return omac_desc((struct ext *)kripto_alloc(sizeof(struct ext)), block);
+}
@@ -29,6 +29,8 @@
 
 #include <kripto/mac/skein1024.h>
 
+#include "../alloc.h"
+
 struct kripto_mac
 {
 	const kripto_desc_mac *desc;
@@ -196,7 +198,7 @@ static kripto_mac *skein1024_create
 	unsigned int tag_len
 )
 {
-	kripto_mac *s = (kripto_mac *)malloc(sizeof(kripto_mac));
+	kripto_mac *s = (kripto_mac *)kripto_alloc(sizeof(kripto_mac));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -204,7 +206,7 @@ static kripto_mac *skein1024_create
 	s->block = kripto_block_create(kripto_block_threefish1024, r, "", 1);
 	if(!s->block)
 	{
-		free(s);
+		kripto_free(s);
 		return 0;
 	}
 
@@ -217,7 +219,7 @@ static void skein1024_destroy(kripto_mac *s)
 {
 	kripto_block_destroy(s->block);
 	kripto_memory_wipe(s, sizeof(kripto_mac));
-	free(s);
+	kripto_free(s);
 }
 
 static const kripto_desc_mac skein1024 =
@@ -226,6 +228,8 @@ static const kripto_desc_mac skein1024 =
 	&skein1024_recreate,
 	&skein1024_input,
 	&skein1024_tag,
+	0, /* reset */
+	0, /* chain */
 	&skein1024_destroy,
 	128, /* max tag */
 	UINT_MAX /* max key */
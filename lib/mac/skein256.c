@@ -29,6 +29,8 @@
 
 #include <kripto/mac/skein256.h>
 
+#include "../alloc.h"
+
 struct kripto_mac
 {
 	const kripto_desc_mac *desc;
@@ -196,7 +198,7 @@ static kripto_mac *skein256_create
 	unsigned int tag_len
 )
 {
-	kripto_mac *s = (kripto_mac *)malloc(sizeof(kripto_mac));
+	kripto_mac *s = (kripto_mac *)kripto_alloc(sizeof(kripto_mac));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -204,7 +206,7 @@ static kripto_mac *skein256_create
 	s->block = kripto_block_create(kripto_block_threefish256, r, "", 1);
 	if(!s->block)
 	{
-		free(s);
+		kripto_free(s);
 		return 0;
 	}
 
@@ -217,7 +219,7 @@ static void skein256_destroy(kripto_mac *s)
 {
 	kripto_block_destroy(s->block);
 	kripto_memory_wipe(s, sizeof(kripto_mac));
-	free(s);
+	kripto_free(s);
 }
 
 static const kripto_desc_mac skein256 =
@@ -226,6 +228,8 @@ static const kripto_desc_mac skein256 =
 	&skein256_recreate,
 	&skein256_input,
 	&skein256_tag,
+	0, /* reset */
+	0, /* chain */
 	&skein256_destroy,
 	32, /* max tag */
 	UINT_MAX /* max key */
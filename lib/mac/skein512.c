@@ -29,6 +29,8 @@
 
 #include <kripto/mac/skein512.h>
 
+#include "../alloc.h"
+
 struct kripto_mac
 {
 	const kripto_desc_mac *desc;
@@ -196,7 +198,7 @@ static kripto_mac *skein512_create
 	unsigned int tag_len
 )
 {
-	kripto_mac *s = (kripto_mac *)malloc(sizeof(kripto_mac));
+	kripto_mac *s = (kripto_mac *)kripto_alloc(sizeof(kripto_mac));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -204,7 +206,7 @@ static kripto_mac *skein512_create
 	s->block = kripto_block_create(kripto_block_threefish512, r, "", 1);
 	if(!s->block)
 	{
-		free(s);
+		kripto_free(s);
 		return 0;
 	}
 
@@ -217,7 +219,7 @@ static void skein512_destroy(kripto_mac *s)
 {
 	kripto_block_destroy(s->block);
 	kripto_memory_wipe(s, sizeof(kripto_mac));
-	free(s);
+	kripto_free(s);
 }
 
 static const kripto_desc_mac skein512 =
@@ -226,6 +228,8 @@ static const kripto_desc_mac skein512 =
 	&skein512_recreate,
 	&skein512_input,
 	&skein512_tag,
+	0, /* reset */
+	0, /* chain */
 	&skein512_destroy,
 	64, /* max tag */
 	UINT_MAX /* max key */
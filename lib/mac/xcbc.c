@@ -26,6 +26,8 @@
 
 #include <kripto/mac/xcbc.h>
 
+#include "../alloc.h"
+
 struct kripto_mac
 {
 	const kripto_desc_mac *desc;
@@ -121,7 +123,7 @@ static void xcbc_destroy(kripto_mac *s)
 	kripto_block_destroy(s->block);
 
 	kripto_memory_wipe(s, sizeof(kripto_mac) + s->len * 3);
-	free(s);
+	kripto_free(s);
 }
 
 struct ext
@@ -141,7 +143,7 @@ static kripto_mac *xcbc_create
 	unsigned int tag_len
 )
 {
-	kripto_mac *s = (kripto_mac *)malloc(sizeof(kripto_mac) + desc->maxtag * 3);
+	kripto_mac *s = (kripto_mac *)kripto_alloc(sizeof(kripto_mac) + desc->maxtag * 3);
 	if(!s) return 0;
 
 	(void)tag_len;
@@ -154,13 +156,13 @@ static kripto_mac *xcbc_create
 	s->block = kripto_block_create(EXT(desc)->block, r, key, key_len);
 	if(!s->block)
 	{
-		free(s);
+		kripto_free(s);
 		return 0;
 	}
 
 	if(xcbc_init(s, r))
 	{
-		free(s);
+		kripto_free(s);
 		return 0;
 	}
 
@@ -187,7 +189,7 @@ static kripto_mac *xcbc_recreate
 
 err:
 	kripto_memory_wipe(s, sizeof(kripto_mac) + s->desc->maxtag * 3);
-	free(s);
+	kripto_free(s);
 	return 0;
 }
 
@@ -202,6 +204,8 @@ kripto_desc_mac *kripto_mac_xcbc(const kripto_desc_block *block)
 	s->desc.recreate = &xcbc_recreate;
 	s->desc.input = &xcbc_input;
 	s->desc.tag = &xcbc_tag;
+	s->desc.reset = 0;
+	s->desc.chain = 0;
 	s->desc.destroy = &xcbc_destroy;
 	s->desc.maxtag = kripto_block_size(block);
 	s->desc.maxkey = kripto_block_maxkey(block);
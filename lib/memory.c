@@ -14,26 +14,71 @@
  */
 
 #include <stddef.h>
+#include <stdint.h>
+#include <string.h>
 
 #include <kripto/memory.h>
 
+#if defined(__GNUC__) || defined(__clang__)
+
+/* memory behind P is used by something the compiler can not see */
+#define BARRIER(P) __asm__ __volatile__("" : : "r"(P) : "memory")
+
+/* X is produced by something the compiler can not see */
+#define OPAQUE(X) __asm__ __volatile__("" : "+r"(X))
+
+#else
+
+/* memset can not be proven to be memset through a volatile pointer */
+static void *(*const volatile memset_v)(void *, int, size_t) = &memset;
+
+#endif
+
 void kripto_memory_wipe(void *dst, size_t len)
 {
-	volatile unsigned char *x = (volatile unsigned char *)dst;
-
-	while(len--) *x++ = '\0';
+	#if defined(__GNUC__) || defined(__clang__)
+	memset(dst, 0, len);
+	BARRIER(dst);
+	#else
+	(void)memset_v(dst, 0, len);
+	#endif
 }
 
 unsigned char kripto_memory_equals(const void *a, const void *b, size_t len)
 {
-	const volatile unsigned char *ax = (const volatile unsigned char *)a;
-	const volatile unsigned char *bx = (const volatile unsigned char *)b;
-	volatile unsigned char x = 0;
+	const unsigned char *ax = (const unsigned char *)a;
+	const unsigned char *bx = (const unsigned char *)b;
+	uint64_t w[4];
+	uint64_t v[4];
+	uint64_t x = 0;
+	size_t i = 0;
 
-	for (size_t i = 0; i < len; i++)
+	/* 32 bytes per step, no early exit */
+	for(; i + 32 <= len; i += 32)
+	{
+		memcpy(w, ax + i, 32);
+		memcpy(v, bx + i, 32);
+
+		x |= (w[0] ^ v[0]) | (w[1] ^ v[1]) | (w[2] ^ v[2]) | (w[3] ^ v[3]);
+
+		/* the compiler can not tell x stays non-zero, so it can not exit */
+		#if defined(__GNUC__) || defined(__clang__)
+		OPAQUE(x);
+		#endif
+	}
+
+	for(; i < len; i++)
 	{
 		x |= ax[i] ^ bx[i];
+
+		#if defined(__GNUC__) || defined(__clang__)
+		OPAQUE(x);
+		#endif
 	}
 
-	return !x;
+	/* 1 if x is 0, without a branch */
+	x |= x >> 32;
+	x &= 0xFFFFFFFF;
+
+	return (unsigned char)(1 & ((x - 1) >> 63));
 }
@@ -19,16 +19,124 @@
 #include <assert.h>
 
 #include <kripto/cast.h>
+#include <kripto/loadstore.h>
 #include <kripto/memory.h>
+#include <kripto/xor.h>
 #include <kripto/mac.h>
 
 #include <kripto/pbkdf2.h>
 
-int kripto_pbkdf2
+#include "thread.h"
+
+struct job
+{
+	const kripto_desc_mac *mac;
+	unsigned int mac_rounds;
+	unsigned int iter;
+	const void *pass;
+	unsigned int pass_len;
+	const void *salt;
+	unsigned int salt_len;
+	uint8_t *out;
+	size_t out_len;
+	unsigned int x;
+	size_t first;
+	size_t step;
+	int err;
+};
+
+/* same key again, rehashing it only if the MAC can not reset */
+static kripto_mac *pbkdf2_restart(const struct job *j, kripto_mac *m)
+{
+	if(!m)
+		return kripto_mac_create(j->mac, j->mac_rounds, j->pass, j->pass_len, j->x);
+
+	if(kripto_mac_resettable(j->mac))
+	{
+		kripto_mac_reset(m);
+		return m;
+	}
+
+	return kripto_mac_recreate(m, j->mac_rounds, j->pass, j->pass_len, j->x);
+}
+
+/* output blocks first, first + step, ... */
+static void *pbkdf2_job(void *arg)
+{
+	struct job *j = (struct job *)arg;
+	kripto_mac *m = 0;
+	uint8_t ctr[4];
+	uint8_t *u;
+	uint8_t *t;
+	size_t b;
+	size_t n;
+	unsigned int i;
+
+	u = (uint8_t *)malloc(j->x << 1);
+	if(!u)
+	{
+		j->err = -1;
+		return 0;
+	}
+
+	t = u + j->x;
+
+	for(b = j->first; b < (j->out_len + j->x - 1) / j->x; b += j->step)
+	{
+		m = pbkdf2_restart(j, m);
+		if(!m) goto err;
+
+		STORE32B((uint32_t)(b + 1), ctr);
+
+		kripto_mac_input(m, j->salt, j->salt_len);
+		kripto_mac_input(m, ctr, 4);
+		kripto_mac_tag(m, u, j->x);
+
+		memcpy(t, u, j->x);
+
+		if(kripto_mac_chainable(j->mac))
+		{
+			kripto_mac_chain(m, u, t, j->x, j->iter);
+		}
+		else
+		{
+			for(i = 1; i < j->iter; i++)
+			{
+				m = pbkdf2_restart(j, m);
+				if(!m) goto err;
+
+				kripto_mac_input(m, u, j->x);
+				kripto_mac_tag(m, u, j->x);
+
+				XOR(t, u, t, j->x);
+			}
+		}
+
+		n = j->out_len - b * j->x;
+		if(n > j->x) n = j->x;
+		memcpy(j->out + b * j->x, t, n);
+	}
+
+	if(m) kripto_mac_destroy(m);
+	kripto_memory_wipe(u, j->x << 1);
+	free(u);
+
+	return 0;
+
+err:
+	j->err = -1;
+	kripto_memory_wipe(u, j->x << 1);
+	free(u);
+
+	return 0;
+}
+
+int kripto_pbkdf2_threads
 (
 	const kripto_desc_mac *mac,
 	unsigned int mac_rounds,
 	unsigned int iter,
+	unsigned int threads,
 	const void *pass,
 	unsigned int pass_len,
 	const void *salt,
@@ -37,74 +145,79 @@ int kripto_pbkdf2
 	size_t out_len
 )
 {
-	unsigned int i;
+	struct job j[KRIPTO_THREADS_MAX];
 	unsigned int x;
-	unsigned int y;
-	uint8_t ctr[4] = {0, 0, 0, 0};
-	uint8_t *buf0;
-	uint8_t *buf1;
-	kripto_mac *m;
+	unsigned int i;
+	size_t blocks;
+	int err = 0;
 
 	assert(mac);
 	assert(iter);
 
-	x = kripto_mac_maxtag(mac);
-	if(out_len < x) x = out_len;
+	if(!out_len) return 0;
 
-	buf0 = (uint8_t *)malloc(x << 1);
-	if(!buf0) return -1;
+	/* full length U_i are chained, only the output is truncated */
+	x = kripto_mac_maxtag(mac);
 
-	buf1 = buf0 + x;
+	blocks = (out_len + x - 1) / x;
+	assert(blocks - 1 <= 0xFFFFFFFE);
 
-	m = kripto_mac_create(mac, mac_rounds, pass, pass_len, x);
-	if(!m) goto err;
+	/* at most one thread per output block */
+	if(!threads) threads = thread_count();
+	if(threads > blocks) threads = blocks;
+	if(threads > KRIPTO_THREADS_MAX) threads = KRIPTO_THREADS_MAX;
 
-	for(;;)
+	for(i = 0; i < threads; i++)
 	{
-		for(i = 3; !++ctr[i]; i--)
-			assert(i);
-
-		kripto_mac_input(m, salt, salt_len);
-
-		kripto_mac_input(m, ctr, 4);
-
-		kripto_mac_tag(m, buf0, x);
-
-		memcpy(buf1, buf0, x);
-
-		for(i = 1; i < iter; i++)
-		{
-			m = kripto_mac_recreate(m, mac_rounds, pass, pass_len, x);
-			if(!mac) goto err;
-
-			kripto_mac_input(m, buf0, x);
-			kripto_mac_tag(m, buf0, x);
-
-			for(y = 0; y < x; y++)
-				buf1[y] ^= buf0[y];
-		}
-
-		/* output */
-		for(y = 0; y < x && out_len; y++, out_len--, out = U8(out) + 1)
-			*U8(out) = buf1[y];
-
-		if(!out_len) break;
-
-		m = kripto_mac_recreate(m, mac_rounds, pass, pass_len, x);
-		if(!m) goto err;
+		j[i].mac = mac;
+		j[i].mac_rounds = mac_rounds;
+		j[i].iter = iter;
+		j[i].pass = pass;
+		j[i].pass_len = pass_len;
+		j[i].salt = salt;
+		j[i].salt_len = salt_len;
+		j[i].out = U8(out);
+		j[i].out_len = out_len;
+		j[i].x = x;
+		j[i].first = i;
+		j[i].step = threads;
+		j[i].err = 0;
 	}
 
-	kripto_mac_destroy(m);
-	kripto_memory_wipe(buf0, x);
-	kripto_memory_wipe(buf1, x);
-	free(buf0);
+	thread_run(&pbkdf2_job, j, sizeof(struct job), threads);
 
-	return 0;
+	for(i = 0; i < threads; i++)
+		err |= j[i].err;
 
-err:
-	kripto_memory_wipe(buf0, x);
-	kripto_memory_wipe(buf1, x);
-	free(buf0);
+	if(err) kripto_memory_wipe(out, out_len);
+
+	return err;
+}
 
-	return -1;
+int kripto_pbkdf2
+(
+	const kripto_desc_mac *mac,
+	unsigned int mac_rounds,
+	unsigned int iter,
+	const void *pass,
+	unsigned int pass_len,
+	const void *salt,
+	unsigned int salt_len,
+	void *out,
+	size_t out_len
+)
+{
+	return kripto_pbkdf2_threads
+	(
+		mac,
+		mac_rounds,
+		iter,
+		0,
+		pass,
+		pass_len,
+		salt,
+		salt_len,
+		out,
+		out_len
+	);
 }
@@ -13,6 +13,10 @@
  * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
  */
 
+#if defined(KRIPTO_UNIX) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE /* syscall, O_CLOEXEC */
+#endif
+
 #include <assert.h>
 #include <stdint.h>
 
@@ -22,8 +26,50 @@
 #define KRIPTO_DEV_RANDOM "/dev/urandom"
 #endif
 
+#ifndef KRIPTO_RESEED_OUTPUT
+#define KRIPTO_RESEED_OUTPUT 5242880 /* 5MB */
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+#include <kripto/cast.h>
+#include <kripto/memory.h>
+#include <kripto/stream.h>
+#include <kripto/stream/chacha.h>
+
+#include "thread.h"
+
+/*
+ * ChaCha20 with fast key erasure, one generator per thread. A refill
+ * makes RANDOM_BUF bytes of output and one more block, which keys the
+ * next refill. Served bytes are wiped from the buffer, so a captured
+ * state does not reveal earlier output.
+ */
+
+#define RANDOM_BUF 1024
+
+struct state
+{
+	kripto_stream *stream;
+	size_t used;
+	size_t output;
+	unsigned int fork;
+	uint8_t buf[RANDOM_BUF + 64];
+};
+
+/* with KRIPTO_RANDOM set, reads come from that file instead */
+struct kripto_random
+{
+	FILE *fp;
+};
 
 #elif defined(KRIPTO_WINDOWS)
 
@@ -86,7 +132,238 @@ struct kripto_random
 
 #include <kripto/random.h>
 
-#if !defined(KRIPTO_WINDOWS) && !defined(KRIPTO_UNIX)
+#if defined(KRIPTO_UNIX)
+
+/* bumped in the child after fork, generators reseed when it changes */
+static unsigned int fork_count = 0;
+
+#ifdef KRIPTO_THREADS
+static pthread_once_t once = PTHREAD_ONCE_INIT;
+static pthread_key_t key;
+static int key_ok = 0;
+#else
+static struct state *single = 0;
+static pid_t single_pid;
+#endif
+
+static int entropy(void *out, size_t len)
+{
+	ssize_t r;
+	int fd;
+
+	#ifdef SYS_getrandom
+	while(len)
+	{
+		r = syscall(SYS_getrandom, out, len, 0);
+		if(r < 0)
+		{
+			if(errno == EINTR) continue;
+			if(errno == ENOSYS) break;
+			return -1;
+		}
+
+		out = U8(out) + r;
+		len -= (size_t)r;
+	}
+
+	if(!len) return 0;
+	#endif
+
+	fd = open(KRIPTO_DEV_RANDOM, O_RDONLY | O_CLOEXEC);
+	if(fd < 0) return -1;
+
+	while(len)
+	{
+		r = read(fd, out, len);
+		if(r <= 0)
+		{
+			if(r < 0 && errno == EINTR) continue;
+			(void)close(fd);
+			return -1;
+		}
+
+		out = U8(out) + r;
+		len -= (size_t)r;
+	}
+
+	(void)close(fd);
+
+	return 0;
+}
+
+/* next buffer, the block after it keys the stream */
+static void refill(struct state *st)
+{
+	kripto_stream_prng(st->stream, st->buf, RANDOM_BUF + 64);
+
+	(void)kripto_stream_recreate(st->stream, 0, st->buf + RANDOM_BUF, 32, 0, 0);
+	kripto_memory_wipe(st->buf + RANDOM_BUF, 64);
+	st->used = 0;
+}
+
+/*
+ * Entropy into the key before anything else is generated. Buffered
+ * output is dropped, after a fork the parent may serve it too.
+ */
+static int reseed(struct state *st)
+{
+	uint8_t k[32];
+	uint8_t e[32];
+	unsigned int i;
+
+	if(entropy(e, 32)) return -1;
+
+	kripto_stream_prng(st->stream, k, 32);
+	for(i = 0; i < 32; i++) k[i] ^= e[i];
+
+	(void)kripto_stream_recreate(st->stream, 0, k, 32, 0, 0);
+	kripto_memory_wipe(k, 32);
+	kripto_memory_wipe(e, 32);
+
+	kripto_memory_wipe(st->buf, RANDOM_BUF + 64);
+	refill(st);
+
+	return 0;
+}
+
+static void state_destroy(void *arg)
+{
+	struct state *st = (struct state *)arg;
+
+	kripto_stream_destroy(st->stream);
+
+	kripto_memory_wipe(st, sizeof(struct state));
+	free(st);
+}
+
+static struct state *state_create(void)
+{
+	struct state *st;
+	uint8_t k[32];
+
+	st = (struct state *)malloc(sizeof(struct state));
+	if(!st) return 0;
+
+	if(entropy(k, 32))
+	{
+		free(st);
+		return 0;
+	}
+
+	st->stream = kripto_stream_create(kripto_stream_chacha, 0, k, 32, 0, 0);
+	kripto_memory_wipe(k, 32);
+	if(!st->stream)
+	{
+		free(st);
+		return 0;
+	}
+
+	st->output = 0;
+	st->fork = fork_count;
+	refill(st);
+
+	return st;
+}
+
+#ifdef KRIPTO_THREADS
+
+static void forked(void)
+{
+	fork_count++;
+}
+
+static void init(void)
+{
+	key_ok = !pthread_key_create(&key, &state_destroy);
+	if(key_ok) (void)pthread_atfork(0, 0, &forked);
+}
+
+#endif
+
+/* generator of the calling thread */
+static struct state *state_get(void)
+{
+	struct state *st;
+
+	#ifdef KRIPTO_THREADS
+	st = (struct state *)pthread_getspecific(key);
+	if(st) return st;
+
+	st = state_create();
+	if(st && pthread_setspecific(key, st))
+	{
+		state_destroy(st);
+		return 0;
+	}
+	#else
+	/* no atfork without threads */
+	if(single && single_pid != getpid())
+	{
+		single_pid = getpid();
+		fork_count++;
+	}
+
+	if(single) return single;
+
+	st = single = state_create();
+	single_pid = getpid();
+	#endif
+
+	return st;
+}
+
+static size_t gen(void *out, size_t len)
+{
+	struct state *st;
+	size_t left = len;
+	size_t n;
+
+	st = state_get();
+	if(!st) return 0;
+
+	if(st->fork != fork_count || st->output > KRIPTO_RESEED_OUTPUT)
+	{
+		if(reseed(st)) return 0;
+
+		st->fork = fork_count;
+		st->output = 0;
+	}
+
+	st->output += len;
+
+	while(left)
+	{
+		if(st->used == RANDOM_BUF)
+		{
+			/* large requests come straight from the stream */
+			if(left >= RANDOM_BUF)
+			{
+				n = left & ~(size_t)63;
+				kripto_stream_prng(st->stream, out, n);
+
+				out = U8(out) + n;
+				left -= n;
+			}
+
+			refill(st);
+			continue;
+		}
+
+		n = RANDOM_BUF - st->used;
+		if(n > left) n = left;
+
+		memcpy(out, st->buf + st->used, n);
+		kripto_memory_wipe(st->buf + st->used, n);
+		st->used += n;
+
+		out = U8(out) + n;
+		left -= n;
+	}
+
+	return len;
+}
+
+#elif !defined(KRIPTO_WINDOWS)
 
 static int seed(kripto_random *s, uint8_t *out, unsigned int len)
 {
@@ -179,24 +456,37 @@ err:
 
 kripto_random *kripto_random_create(void)
 {
-	#if defined(KRIPTO_DEV_RANDOM)
+	#if defined(KRIPTO_UNIX)
 
 	const char *dev_random;
-	/*FILE *fp;*/
+
+	kripto_random *s = (kripto_random *)malloc(sizeof(kripto_random));
+	if(!s) return 0;
+
+	s->fp = 0;
 
 	dev_random = getenv("KRIPTO_RANDOM");
-	if(!dev_random)
-		#ifdef KRIPTO_DEV_RANDOM
-		dev_random = KRIPTO_DEV_RANDOM;
-		#else
-		return create();
-		#endif
+	if(dev_random)
+	{
+		s->fp = fopen(dev_random, "rb");
+		if(!s->fp)
+		{
+			free(s);
+			return 0;
+		}
 
-	return (kripto_random *)fopen(dev_random, "rb");
+		return s;
+	}
 
-	/*fp = fopen(dev_random, "rb");
-	if(fp) return (kripto_random *)fp;
-	else return create();*/
+	#ifdef KRIPTO_THREADS
+	if(pthread_once(&once, &init) || !key_ok)
+	{
+		free(s);
+		return 0;
+	}
+	#endif
+
+	return s;
 
 	#elif defined(KRIPTO_RTLGENRANDOM)
 
@@ -249,9 +539,11 @@ size_t kripto_random_gen(kripto_random *s, void *out, size_t len)
 {
 	assert(s);
 
-	#if defined(KRIPTO_DEV_RANDOM)
+	#if defined(KRIPTO_UNIX)
+
+	if(s->fp) return fread(out, sizeof(char), len, s->fp);
 
-	return fread(out, sizeof(char), len, (FILE *)s);
+	return gen(out, len);
 
 	#elif defined(KRIPTO_RTLGENRANDOM)
 
@@ -306,9 +598,11 @@ void kripto_random_destroy(kripto_random *s)
 {
 	assert(s);
 
-	#if defined(KRIPTO_DEV_RANDOM)
+	#if defined(KRIPTO_UNIX)
 
-	fclose((FILE *)s);
+	/* generators of threads stay until the thread exits */
+	if(s->fp) fclose(s->fp);
+	free(s);
 
 	#elif defined(KRIPTO_RTLGENRANDOM)
 
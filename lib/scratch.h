@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2026 by Gregor Pintar <grpintar@gmail.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef LIB_SCRATCH_H
+#define LIB_SCRATCH_H
+
+/*
+ * Large scratch memory for the memory-hard KDFs, faulted in up front.
+ * On unix it is an anonymous mapping kept out of core dumps, the
+ * including file has to define _DEFAULT_SOURCE before any header.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+#if defined(KRIPTO_UNIX)
+#include <sys/mman.h>
+#endif
+
+#define SCRATCH_HUGE 1 /* huge pages, reserved or transparent */
+#define SCRATCH_LOCK 2 /* mlock, fail if not allowed */
+
+#if defined(KRIPTO_UNIX) && defined(MAP_ANONYMOUS)
+
+#define SCRATCH_HUGE_PAGE 2097152
+
+/* *map gets the mapped size, len rounded up for huge pages */
+static inline void *scratch_map(size_t len, size_t *map, unsigned int flags)
+{
+	void *m = MAP_FAILED;
+	int populate = 0;
+
+	#ifdef MAP_POPULATE
+	populate = MAP_POPULATE;
+	#endif
+
+	#ifdef MAP_HUGETLB
+	if(flags & SCRATCH_HUGE)
+	{
+		*map = (len + SCRATCH_HUGE_PAGE - 1) & ~(size_t)(SCRATCH_HUGE_PAGE - 1);
+		m = mmap(0, *map, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | populate, -1, 0);
+	}
+	#endif
+
+	if(m == MAP_FAILED)
+	{
+		*map = len;
+		m = mmap(0, *map, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS | populate, -1, 0);
+		if(m == MAP_FAILED) return 0;
+
+		/* transparent huge pages when no reserved ones are left */
+		#ifdef MADV_HUGEPAGE
+		if(flags & SCRATCH_HUGE)
+			(void)madvise(m, *map, MADV_HUGEPAGE);
+		#endif
+	}
+
+	/* keep password derived scratch out of core dumps and swap */
+	#ifdef MADV_DONTDUMP
+	(void)madvise(m, *map, MADV_DONTDUMP);
+	#endif
+
+	if((flags & SCRATCH_LOCK) && mlock(m, *map))
+	{
+		(void)munmap(m, *map);
+		return 0;
+	}
+
+	return m;
+}
+
+static inline void scratch_unmap(void *m, size_t map)
+{
+	(void)munmap(m, map);
+}
+
+#else
+
+static inline void *scratch_map(size_t len, size_t *map, unsigned int flags)
+{
+	uint8_t *m;
+	size_t i;
+
+	(void)flags;
+
+	*map = len;
+	m = (uint8_t *)malloc(len);
+	if(!m) return 0;
+
+	/* fault it in now rather than in the first pass */
+	for(i = 0; i < len; i += 4096) m[i] = 0;
+
+	return m;
+}
+
+static inline void scratch_unmap(void *m, size_t map)
+{
+	(void)map;
+	free(m);
+}
+
+#endif
+
+#endif
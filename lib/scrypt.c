@@ -13,20 +13,41 @@
  * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
  */
 
+#if defined(KRIPTO_UNIX) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE /* MAP_ANONYMOUS, madvise */
+#endif
+
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
 
+#if (defined(__GNUC__) || defined(__clang__)) \
+&& (defined(__i386__) || defined(__x86_64__))
+#define SIMD
+#include <immintrin.h>
+#endif
+
 #include <kripto/memory.h>
 #include <kripto/cast.h>
 #include <kripto/loadstore.h>
 #include <kripto/rotate.h>
+#include <kripto/cpu.h>
 #include <kripto/mac.h>
 #include <kripto/pbkdf2.h>
 
 #include <kripto/scrypt.h>
 
+#include "thread.h"
+#include "scratch.h"
+
+/*
+ * Inside smix every 64-byte block is kept as words in diagonal
+ * order, word i holding Salsa20 word i * 5 % 16. The columns and
+ * rows of Salsa20 are then plain 4-word vectors and only need a
+ * rotation of lanes between the half rounds.
+ */
+
 #define QR(A, B, C, D)		\
 {				\
 	B ^= ROL32_07(A + D);	\
@@ -35,175 +56,406 @@
 	A ^= ROL32_18(D + C);	\
 }
 
+/* Salsa20/8 on a diagonal ordered block */
 static void salsa20_core(uint32_t *x)
 {
 	uint32_t x0 = x[0];
-	uint32_t x1 = x[1];
-	uint32_t x2 = x[2];
-	uint32_t x3 = x[3];
+	uint32_t x5 = x[1];
+	uint32_t x10 = x[2];
+	uint32_t x15 = x[3];
 	uint32_t x4 = x[4];
-	uint32_t x5 = x[5];
-	uint32_t x6 = x[6];
-	uint32_t x7 = x[7];
+	uint32_t x9 = x[5];
+	uint32_t x14 = x[6];
+	uint32_t x3 = x[7];
 	uint32_t x8 = x[8];
-	uint32_t x9 = x[9];
-	uint32_t x10 = x[10];
-	uint32_t x11 = x[11];
+	uint32_t x13 = x[9];
+	uint32_t x2 = x[10];
+	uint32_t x7 = x[11];
 	uint32_t x12 = x[12];
-	uint32_t x13 = x[13];
-	uint32_t x14 = x[14];
-	uint32_t x15 = x[15];
-
-	/* columnround 1 */
-	QR(x0, x4, x8, x12);
-	QR(x5, x9, x13, x1);
-	QR(x10, x14, x2, x6);
-	QR(x15, x3, x7, x11);
-
-	/* rowround 2 */
-	QR(x0, x1, x2, x3);
-	QR(x5, x6, x7, x4);
-	QR(x10, x11, x8, x9);
-	QR(x15, x12, x13, x14);
-
-	/* columnround 3 */
-	QR(x0, x4, x8, x12);
-	QR(x5, x9, x13, x1);
-	QR(x10, x14, x2, x6);
-	QR(x15, x3, x7, x11);
-
-	/* rowround 4 */
-	QR(x0, x1, x2, x3);
-	QR(x5, x6, x7, x4);
-	QR(x10, x11, x8, x9);
-	QR(x15, x12, x13, x14);
-
-	/* columnround 5 */
-	QR(x0, x4, x8, x12);
-	QR(x5, x9, x13, x1);
-	QR(x10, x14, x2, x6);
-	QR(x15, x3, x7, x11);
-
-	/* rowround 6 */
-	QR(x0, x1, x2, x3);
-	QR(x5, x6, x7, x4);
-	QR(x10, x11, x8, x9);
-	QR(x15, x12, x13, x14);
-
-	/* columnround 7 */
-	QR(x0, x4, x8, x12);
-	QR(x5, x9, x13, x1);
-	QR(x10, x14, x2, x6);
-	QR(x15, x3, x7, x11);
-
-	/* rowround 8 */
-	QR(x0, x1, x2, x3);
-	QR(x5, x6, x7, x4);
-	QR(x10, x11, x8, x9);
-	QR(x15, x12, x13, x14);
+	uint32_t x1 = x[13];
+	uint32_t x6 = x[14];
+	uint32_t x11 = x[15];
+	unsigned int i;
+
+	for(i = 0; i < 4; i++)
+	{
+		/* columnround */
+		QR(x0, x4, x8, x12);
+		QR(x5, x9, x13, x1);
+		QR(x10, x14, x2, x6);
+		QR(x15, x3, x7, x11);
+
+		/* rowround */
+		QR(x0, x1, x2, x3);
+		QR(x5, x6, x7, x4);
+		QR(x10, x11, x8, x9);
+		QR(x15, x12, x13, x14);
+	}
 
 	x[0] += x0;
-	x[1] += x1;
-	x[2] += x2;
-	x[3] += x3;
+	x[1] += x5;
+	x[2] += x10;
+	x[3] += x15;
 	x[4] += x4;
-	x[5] += x5;
-	x[6] += x6;
-	x[7] += x7;
+	x[5] += x9;
+	x[6] += x14;
+	x[7] += x3;
 	x[8] += x8;
-	x[9] += x9;
-	x[10] += x10;
-	x[11] += x11;
+	x[9] += x13;
+	x[10] += x2;
+	x[11] += x7;
 	x[12] += x12;
-	x[13] += x13;
-	x[14] += x14;
-	x[15] += x15;
+	x[13] += x1;
+	x[14] += x6;
+	x[15] += x11;
 }
 
-static void blockmix(uint32_t *b, uint32_t *t, const size_t r)
+/*
+ * out = BlockMix(b ^ v), v may be NULL. Sub-block i is written
+ * straight to its final place, even ones first, then odd ones.
+ */
+static void blockmix
+(
+	const uint32_t *b,
+	const uint32_t *v,
+	uint32_t *out,
+	size_t r
+)
 {
 	uint32_t x[16];
 	size_t i;
+	unsigned int j;
 
-	memcpy(x, b + (r << 5) - 16, 64);
+	for(j = 0; j < 16; j++)
+	{
+		x[j] = b[(r << 5) - 16 + j];
+		if(v) x[j] ^= v[(r << 5) - 16 + j];
+	}
 
-	for(i = 0; i < (r << 5);)
+	for(i = 0; i < (r << 1); i++)
 	{
-		x[0] ^= b[i++];
-		x[1] ^= b[i++];
-		x[2] ^= b[i++];
-		x[3] ^= b[i++];
-		x[4] ^= b[i++];
-		x[5] ^= b[i++];
-		x[6] ^= b[i++];
-		x[7] ^= b[i++];
-		x[8] ^= b[i++];
-		x[9] ^= b[i++];
-		x[10] ^= b[i++];
-		x[11] ^= b[i++];
-		x[12] ^= b[i++];
-		x[13] ^= b[i++];
-		x[14] ^= b[i++];
-		x[15] ^= b[i++];
+		for(j = 0; j < 16; j++)
+		{
+			x[j] ^= b[(i << 4) + j];
+			if(v) x[j] ^= v[(i << 4) + j];
+		}
 
 		salsa20_core(x);
-		memcpy(t + i - 16, x, 64);
+
+		memcpy(out + (((i & 1) * r + (i >> 1)) << 4), x, 64);
 	}
 
-	for(i = 0; i < r; i++)
-	{
-		memcpy(b + (i << 4), t + (i << 5), 64);
-		memcpy(b + ((i + r) << 4), t + (i << 5) + 16, 64);
-	}	
+	kripto_memory_wipe(x, 64);
+}
+
+#ifdef SIMD
+
+#define ROL_SSE2(X, N) \
+	_mm_or_si128(_mm_slli_epi32(X, N), _mm_srli_epi32(X, 32 - (N)))
+
+#define ROL_AVX512(X, N) _mm_rol_epi32(X, N)
+
+#define LOAD128(P) _mm_loadu_si128((const __m128i *)(P))
+
+/* whole BlockMix in four registers, one per diagonal row */
+#define BLOCKMIX_V(ROL)							\
+{									\
+	__m128i x0;							\
+	__m128i x1;							\
+	__m128i x2;							\
+	__m128i x3;							\
+	__m128i t0;							\
+	__m128i t1;							\
+	__m128i t2;							\
+	__m128i t3;							\
+	size_t i;							\
+	unsigned int j;							\
+	const uint32_t *p;						\
+	uint32_t *o;							\
+									\
+	p = b + (r << 5) - 16;						\
+	x0 = LOAD128(p);						\
+	x1 = LOAD128(p + 4);						\
+	x2 = LOAD128(p + 8);						\
+	x3 = LOAD128(p + 12);						\
+	if(v)								\
+	{								\
+		p = v + (r << 5) - 16;					\
+		x0 = _mm_xor_si128(x0, LOAD128(p));			\
+		x1 = _mm_xor_si128(x1, LOAD128(p + 4));			\
+		x2 = _mm_xor_si128(x2, LOAD128(p + 8));			\
+		x3 = _mm_xor_si128(x3, LOAD128(p + 12));		\
+	}								\
+									\
+	for(i = 0; i < (r << 1); i++)					\
+	{								\
+		p = b + (i << 4);					\
+		x0 = _mm_xor_si128(x0, LOAD128(p));			\
+		x1 = _mm_xor_si128(x1, LOAD128(p + 4));			\
+		x2 = _mm_xor_si128(x2, LOAD128(p + 8));			\
+		x3 = _mm_xor_si128(x3, LOAD128(p + 12));		\
+		if(v)							\
+		{							\
+			p = v + (i << 4);				\
+			x0 = _mm_xor_si128(x0, LOAD128(p));		\
+			x1 = _mm_xor_si128(x1, LOAD128(p + 4));		\
+			x2 = _mm_xor_si128(x2, LOAD128(p + 8));		\
+			x3 = _mm_xor_si128(x3, LOAD128(p + 12));	\
+		}							\
+									\
+		t0 = x0;						\
+		t1 = x1;						\
+		t2 = x2;						\
+		t3 = x3;						\
+									\
+		for(j = 0; j < 4; j++)					\
+		{							\
+			/* columns */					\
+			x1 = _mm_xor_si128(x1, ROL(_mm_add_epi32(x0, x3), 7));	\
+			x2 = _mm_xor_si128(x2, ROL(_mm_add_epi32(x1, x0), 9));	\
+			x3 = _mm_xor_si128(x3, ROL(_mm_add_epi32(x2, x1), 13));	\
+			x0 = _mm_xor_si128(x0, ROL(_mm_add_epi32(x3, x2), 18));	\
+									\
+			x1 = _mm_shuffle_epi32(x1, 0x93);		\
+			x2 = _mm_shuffle_epi32(x2, 0x4E);		\
+			x3 = _mm_shuffle_epi32(x3, 0x39);		\
+									\
+			/* rows */					\
+			x3 = _mm_xor_si128(x3, ROL(_mm_add_epi32(x0, x1), 7));	\
+			x2 = _mm_xor_si128(x2, ROL(_mm_add_epi32(x3, x0), 9));	\
+			x1 = _mm_xor_si128(x1, ROL(_mm_add_epi32(x2, x3), 13));	\
+			x0 = _mm_xor_si128(x0, ROL(_mm_add_epi32(x1, x2), 18));	\
+									\
+			x1 = _mm_shuffle_epi32(x1, 0x39);		\
+			x2 = _mm_shuffle_epi32(x2, 0x4E);		\
+			x3 = _mm_shuffle_epi32(x3, 0x93);		\
+		}							\
+									\
+		x0 = _mm_add_epi32(x0, t0);				\
+		x1 = _mm_add_epi32(x1, t1);				\
+		x2 = _mm_add_epi32(x2, t2);				\
+		x3 = _mm_add_epi32(x3, t3);				\
+									\
+		o = out + (((i & 1) * r + (i >> 1)) << 4);		\
+		_mm_storeu_si128((__m128i *)o, x0);			\
+		_mm_storeu_si128((__m128i *)(o + 4), x1);		\
+		_mm_storeu_si128((__m128i *)(o + 8), x2);		\
+		_mm_storeu_si128((__m128i *)(o + 12), x3);		\
+	}								\
 }
 
+__attribute__((target("sse2")))
+static void blockmix_sse2
+(
+	const uint32_t *b,
+	const uint32_t *v,
+	uint32_t *out,
+	size_t r
+)
+BLOCKMIX_V(ROL_SSE2)
+
+/* same code, VEX encoded without register copies */
+__attribute__((target("avx2")))
+static void blockmix_avx2
+(
+	const uint32_t *b,
+	const uint32_t *v,
+	uint32_t *out,
+	size_t r
+)
+BLOCKMIX_V(ROL_SSE2)
+
+/* native rotates */
+__attribute__((target("avx512f,avx512vl")))
+static void blockmix_avx512
+(
+	const uint32_t *b,
+	const uint32_t *v,
+	uint32_t *out,
+	size_t r
+)
+BLOCKMIX_V(ROL_AVX512)
+
+#endif
+
+/* words 0 and 1 of the last sub-block, in diagonal order at 0 and 13 */
+#define INTEGERIFY(X, R, N)					\
+	((((uint64_t)(X)[((R) << 5) - 3] << 32)			\
+	| (X)[((R) << 5) - 16]) & ((N) - 1))
+
+/* v holds n blocks, x and y one each */
 static void smix
 (
 	uint8_t *b,
 	const size_t r,
 	uint64_t n,
-	uint32_t *t0,
-	uint32_t *t1,
-	uint32_t *t2
+	uint32_t *v,
+	uint32_t *x,
+	uint32_t *y
 )
 {
+	void (*mix)(const uint32_t *, const uint32_t *, uint32_t *, size_t);
 	uint64_t i;
-	uint64_t tn;
-	uint64_t j;
+	size_t k;
+	unsigned int j;
+
+	mix = &blockmix;
 
-	for(i = 0; i < (r << 5); i++)
-		t1[i] = LOAD32L(b + (i << 2));
+	#ifdef SIMD
+	if(kripto_cpu() & KRIPTO_CPU_SSE2) mix = &blockmix_sse2;
+	if(kripto_cpu() & KRIPTO_CPU_AVX2) mix = &blockmix_avx2;
+	if(kripto_cpu() & KRIPTO_CPU_AVX512) mix = &blockmix_avx512;
+	#endif
 
-	for(i = 0; i < n; i++)
+	/* bytes to diagonal words, straight into V_0 */
+	for(k = 0; k < (r << 5); k += 16)
 	{
-		memcpy(t0 + (r << 5) * i, t1, r << 7);
-		blockmix(t1, t2, r);
+		for(j = 0; j < 16; j++)
+			v[k + j] = LOAD32L(b + ((k + (j * 5 & 15)) << 2));
 	}
 
-	for(i = 0; i < n; i++)
+	for(i = 0; i < n - 1; i++)
+		mix(v + (r << 5) * i, 0, v + (r << 5) * (i + 1), r);
+
+	mix(v + (r << 5) * (n - 1), 0, x, r);
+
+	/* n is even, x and y take turns */
+	for(i = 0; i < n; i += 2)
 	{
-		/* integrify */
-		tn = (((uint64_t)t1[(r << 5) - 15] << 32)
-			| t1[(r << 5) - 16])
-			& (n - 1);
+		mix(x, v + (r << 5) * INTEGERIFY(x, r, n), y, r);
+		mix(y, v + (r << 5) * INTEGERIFY(y, r, n), x, r);
+	}
 
-		for(j = 0; j < (r << 5); j++)
-			t1[j] ^= t0[(r << 5) * tn + j];
+	for(k = 0; k < (r << 5); k += 16)
+	{
+		for(j = 0; j < 16; j++)
+			STORE32L(x[k + j], b + ((k + (j * 5 & 15)) << 2));
+	}
+}
 
-		blockmix(t1, t2, r);
+struct lane
+{
+	uint8_t *b;
+	size_t r;
+	uint64_t n;
+	uint32_t p;
+	uint32_t first;
+	uint32_t step;
+	uint32_t *v;
+};
+
+/* lanes first, first + step, ... on own V and XY */
+static void *lane_run(void *arg)
+{
+	const struct lane *l = (const struct lane *)arg;
+	uint32_t i;
+
+	for(i = l->first; i < l->p; i += l->step)
+	{
+		smix
+		(
+			l->b + (l->r << 7) * i, l->r, l->n,
+			l->v,
+			l->v + (l->r << 5) * l->n,
+			l->v + (l->r << 5) * (l->n + 1)
+		);
 	}
 
-	for(i = 0; i < (r << 5); i++)
-		STORE32L(t1[i], b + (i << 2));
+	return 0;
 }
 
-int kripto_scrypt
+size_t kripto_scrypt_memory
 (
-	const kripto_desc_mac *mac,
-	unsigned int mac_rounds,
 	uint64_t n,
 	uint32_t r,
 	uint32_t p,
+	unsigned int threads
+)
+{
+	uint64_t lane;
+	uint64_t b;
+
+	assert(r);
+	assert(p);
+
+	if(!threads) threads = thread_count();
+	if(threads > p) threads = p;
+	if(threads > KRIPTO_THREADS_MAX) threads = KRIPTO_THREADS_MAX;
+
+	/* V and XY of one thread, B shared */
+	if(n > (UINT64_MAX >> 7) / r - 2) return 0;
+	lane = ((uint64_t)r << 7) * (n + 2);
+	b = ((uint64_t)r << 7) * p;
+
+	if(lane > (UINT64_MAX - b) / threads) return 0;
+	if(lane * threads + b > SIZE_MAX) return 0;
+
+	return (size_t)(lane * threads + b);
+}
+
+struct kripto_scrypt_ctx
+{
+	uint8_t *mem;
+	size_t len;
+	size_t map;
+	uint64_t n;
+	uint32_t r;
+	uint32_t p;
+	unsigned int threads;
+};
+
+kripto_scrypt_ctx *kripto_scrypt_ctx_create
+(
+	uint64_t n,
+	uint32_t r,
+	uint32_t p,
+	unsigned int threads,
+	unsigned int flags
+)
+{
+	kripto_scrypt_ctx *s;
+
+	assert(n > 1 && !(n & (n - 1)));
+	assert(r);
+	assert(p);
+
+	s = (kripto_scrypt_ctx *)malloc(sizeof(kripto_scrypt_ctx));
+	if(!s) return 0;
+
+	if(!threads) threads = thread_count();
+	if(threads > p) threads = p;
+	if(threads > KRIPTO_THREADS_MAX) threads = KRIPTO_THREADS_MAX;
+
+	s->n = n;
+	s->r = r;
+	s->p = p;
+	s->threads = threads;
+
+	s->len = kripto_scrypt_memory(n, r, p, threads);
+	if(s->len) s->mem = (uint8_t *)scratch_map(s->len, &s->map,
+		((flags & KRIPTO_SCRYPT_HUGEPAGES) ? SCRATCH_HUGE : 0)
+		| ((flags & KRIPTO_SCRYPT_LOCK) ? SCRATCH_LOCK : 0));
+	if(!s->len || !s->mem)
+	{
+		free(s);
+		return 0;
+	}
+
+	return s;
+}
+
+size_t kripto_scrypt_ctx_memory(const kripto_scrypt_ctx *s)
+{
+	assert(s);
+
+	return s->map;
+}
+
+int kripto_scrypt_ctx_run
+(
+	kripto_scrypt_ctx *s,
+	const kripto_desc_mac *mac,
+	unsigned int mac_rounds,
 	const void *pass,
 	unsigned int pass_len,
 	const void *salt,
@@ -212,56 +464,141 @@ int kripto_scrypt
 	size_t out_len
 )
 {
-	uint8_t *b;
-	uint32_t *t0;
-	uint32_t *t1;
-	uint32_t *t2;
-	uint32_t i;
-
-	b = (uint8_t *)malloc((r << 7) * p + (r << 7) * n + (r << 8));
-	if(!b) return -1;
-
-	t0 = (uint32_t *)(void *)(b + (r << 7) * p);
-	t1 = t0 + (r << 5);
-	t2 = t1 + (r << 5);
-
-	if(kripto_pbkdf2
+	struct lane l[KRIPTO_THREADS_MAX];
+	const size_t r = s->r;
+	const size_t lane = (r << 7) * (s->n + 2);
+	unsigned int i;
+	int err;
+
+	/* one iteration, not worth a thread */
+	if(kripto_pbkdf2_threads
 	(
 		mac,
 		mac_rounds,
 		1,
+		1,
 		pass,
 		pass_len,
 		salt,
 		salt_len,
-		b,
-		p * (r << 7)
-	)) goto err;
+		s->mem,
+		(r << 7) * s->p
+	)) return -1;
 
-	for(i = 0; i < p; i++)
-		smix(b + (r << 7) * i, r, n, t0, t1, t2);
+	for(i = 0; i < s->threads; i++)
+	{
+		l[i].b = s->mem;
+		l[i].r = r;
+		l[i].n = s->n;
+		l[i].p = s->p;
+		l[i].first = i;
+		l[i].step = s->threads;
+		l[i].v = (uint32_t *)(void *)(s->mem + (r << 7) * s->p + lane * i);
+	}
 
-	if(kripto_pbkdf2
+	thread_run(&lane_run, l, sizeof(struct lane), s->threads);
+
+	err = kripto_pbkdf2_threads
 	(
 		mac,
 		mac_rounds,
 		1,
+		1,
 		pass,
 		pass_len,
-		b,
-		p * (r << 7),
+		s->mem,
+		(r << 7) * s->p,
 		out,
 		out_len
-	)) goto err;
+	);
 
-	kripto_memory_wipe(b, (r << 7) * p + (r << 7) * n + (r << 8));
-	free(b);
+	/* B, X and Y; V is overwritten by the next run and wiped on destroy */
+	kripto_memory_wipe(s->mem, (r << 7) * s->p);
+	for(i = 0; i < s->threads; i++)
+		kripto_memory_wipe(s->mem + (r << 7) * s->p + lane * i + (r << 7) * s->n, r << 8);
 
-	return 0;
+	return err;
+}
+
+void kripto_scrypt_ctx_destroy(kripto_scrypt_ctx *s)
+{
+	assert(s);
 
-err:
-	kripto_memory_wipe(b, (r << 7) * p + (r << 7) * n + (r << 8));
-	free(b);
+	kripto_memory_wipe(s->mem, s->len);
+	scratch_unmap(s->mem, s->map);
 
-	return -1;
+	kripto_memory_wipe(s, sizeof(kripto_scrypt_ctx));
+	free(s);
+}
+
+int kripto_scrypt_threads
+(
+	const kripto_desc_mac *mac,
+	unsigned int mac_rounds,
+	uint64_t n,
+	uint32_t r,
+	uint32_t p,
+	unsigned int threads,
+	const void *pass,
+	unsigned int pass_len,
+	const void *salt,
+	unsigned int salt_len,
+	void *out,
+	size_t out_len
+)
+{
+	kripto_scrypt_ctx *s;
+	int err;
+
+	s = kripto_scrypt_ctx_create(n, r, p, threads, 0);
+	if(!s) return -1;
+
+	err = kripto_scrypt_ctx_run
+	(
+		s,
+		mac,
+		mac_rounds,
+		pass,
+		pass_len,
+		salt,
+		salt_len,
+		out,
+		out_len
+	);
+
+	kripto_scrypt_ctx_destroy(s);
+
+	return err;
+}
+
+int kripto_scrypt
+(
+	const kripto_desc_mac *mac,
+	unsigned int mac_rounds,
+	uint64_t n,
+	uint32_t r,
+	uint32_t p,
+	const void *pass,
+	unsigned int pass_len,
+	const void *salt,
+	unsigned int salt_len,
+	void *out,
+	size_t out_len
+)
+{
+	return kripto_scrypt_threads
+	(
+		mac,
+		mac_rounds,
+		n,
+		r,
+		p,
+		1,
+		pass,
+		pass_len,
+		salt,
+		salt_len,
+		out,
+		out_len
+	);
 }
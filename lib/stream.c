@@ -14,11 +14,14 @@
  */
 
 #include <assert.h>
+#include <stdlib.h>
 #include <stdint.h>
 
 #include <kripto/stream.h>
 #include <kripto/desc/stream.h>
 
+#include "alloc.h"
+
 struct kripto_stream
 {
 	const kripto_desc_stream *desc;
@@ -116,6 +119,20 @@ void kripto_stream_prng
 	s->desc->prng(s, out, len);
 }
 
+void kripto_stream_seek
+(
+	kripto_stream *s,
+	uint64_t offset
+)
+{
+	assert(s);
+	assert(s->desc);
+	assert(s->desc->seek);
+	assert(offset % kripto_stream_multof(s) == 0);
+
+	s->desc->seek(s, offset);
+}
+
 void kripto_stream_destroy(kripto_stream *s)
 {
 	assert(s);
@@ -125,6 +142,68 @@ void kripto_stream_destroy(kripto_stream *s)
 	s->desc->destroy(s);
 }
 
+/* create with a zero key, counting what it takes */
+size_t kripto_stream_ctx_size
+(
+	const kripto_desc_stream *desc,
+	unsigned int rounds,
+	unsigned int key_len,
+	unsigned int iv_len
+)
+{
+	struct kripto_alloc_arena a;
+	kripto_stream *s;
+	void *zero;
+	size_t len;
+
+	assert(desc);
+	assert(desc->create);
+
+	zero = calloc(key_len + iv_len + 1, 1);
+	if(!zero) return 0;
+
+	kripto_alloc_begin(&a, 0, 0);
+	s = kripto_stream_create(desc, rounds, zero, key_len, iv_len ? zero : 0, iv_len);
+	len = kripto_alloc_end(&a);
+
+	free(zero);
+
+	if(!s) return 0;
+	kripto_stream_destroy(s);
+
+	return len;
+}
+
+kripto_stream *kripto_stream_init
+(
+	const kripto_desc_stream *desc,
+	void *mem,
+	size_t len,
+	unsigned int rounds,
+	const void *key,
+	unsigned int key_len,
+	const void *iv,
+	unsigned int iv_len
+)
+{
+	struct kripto_alloc_arena a;
+	kripto_stream *s;
+
+	assert(mem);
+
+	kripto_alloc_begin(&a, mem, len);
+	s = kripto_stream_create(desc, rounds, key, key_len, iv, iv_len);
+	(void)kripto_alloc_end(&a);
+
+	return s;
+}
+
+/* destroy wipes, kripto_free leaves caller memory alone */
+void kripto_stream_fini(kripto_stream *s)
+{
+	kripto_stream_destroy(s);
+}
+
 unsigned int kripto_stream_multof(const kripto_stream *s)
 {
 	assert(s);
@@ -155,3 +234,10 @@ unsigned int kripto_stream_maxiv(const kripto_desc_stream *desc)
 
 	return desc->maxiv;
 }
+
+int kripto_stream_seekable(const kripto_desc_stream *desc)
+{
+	assert(desc);
+
+	return desc->seek != 0;
+}
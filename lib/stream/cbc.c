@@ -16,8 +16,10 @@
 #include <stdint.h>
 #include <string.h>
 #include <stdlib.h>
+#include <assert.h>
 
 #include <kripto/cast.h>
+#include <kripto/xor.h>
 #include <kripto/memory.h>
 #include <kripto/block.h>
 #include <kripto/stream.h>
@@ -25,16 +27,35 @@
 
 #include <kripto/stream/cbc.h>
 
+#include "../alloc.h"
+
 struct kripto_stream
 {
 	const kripto_desc_stream *desc;
 	unsigned int multof;
 	kripto_block *block;
 	unsigned int blocksize;
+	unsigned int blocks;
 	uint8_t *iv;
+	uint8_t *last;
 	uint8_t *buf;
 };
 
+/* overlapping decryption buffer */
+#define CBC_BUF 256
+
+#define CBC_SIZE(BS) (sizeof(kripto_stream) + ((BS) << 1) + cbc_blocks(BS) * (BS))
+
+static unsigned int cbc_blocks(unsigned int blocksize)
+{
+	if(blocksize >= CBC_BUF) return 1;
+
+	return CBC_BUF / blocksize;
+}
+
+/* streams advanced together by kripto_stream_cbc_encrypt_multi */
+#define CBC_MULTI 16
+
 static void cbc_encrypt
 (
 	kripto_stream *s,
@@ -69,32 +90,140 @@ static void cbc_decrypt
 	size_t len
 )
 {
-	size_t i;
-	unsigned int n;
+	size_t n;
 
-	for(i = 0; i < len; i += n)
+	if(!len) return;
+
+	if(CU8(pt) + len <= CU8(ct) || CU8(ct) + len <= CU8(pt))
 	{
-		for(n = 0; n < s->blocksize; n++)
-			s->buf[n] = CU8(ct)[n];
+		kripto_block_decrypt_blocks(s->block, ct, pt, len / s->blocksize);
 
-		kripto_block_decrypt(s->block, ct, pt);
+		XOR(pt, s->iv, pt, s->blocksize);
+		XOR(U8(pt) + s->blocksize, ct, U8(pt) + s->blocksize, len - s->blocksize);
 
-		for(n = 0; n < s->blocksize; n++)
+		memcpy(s->iv, CU8(ct) + len - s->blocksize, s->blocksize);
+
+		return;
+	}
+
+	if(CU8(pt) > CU8(ct))
+	{
+		/* plaintext runs ahead of ciphertext, decrypt from the end */
+		memcpy(s->last, CU8(ct) + len - s->blocksize, s->blocksize);
+
+		while(len)
+		{
+			n = len / s->blocksize;
+			if(n > s->blocks) n = s->blocks;
+			len -= n * s->blocksize;
+
+			kripto_block_decrypt_blocks(s->block, CU8(ct) + len, s->buf, n);
+
+			if(len) XOR(s->buf, CU8(ct) + len - s->blocksize, s->buf, s->blocksize);
+			else XOR(s->buf, s->iv, s->buf, s->blocksize);
+
+			XOR
+			(
+				s->buf + s->blocksize,
+				CU8(ct) + len,
+				s->buf + s->blocksize,
+				(n - 1) * s->blocksize
+			);
+
+			memcpy(U8(pt) + len, s->buf, n * s->blocksize);
+		}
+
+		memcpy(s->iv, s->last, s->blocksize);
+
+		return;
+	}
+
+	/* plaintext at or behind ciphertext, each block is read before overwritten */
+	for(; len; len -= n * s->blocksize)
+	{
+		n = len / s->blocksize;
+		if(n > s->blocks) n = s->blocks;
+
+		kripto_block_decrypt_blocks(s->block, ct, s->buf, n);
+
+		XOR(s->buf, s->iv, s->buf, s->blocksize);
+		XOR
+		(
+			s->buf + s->blocksize,
+			ct,
+			s->buf + s->blocksize,
+			(n - 1) * s->blocksize
+		);
+		memcpy(s->iv, CU8(ct) + (n - 1) * s->blocksize, s->blocksize);
+
+		memcpy(pt, s->buf, n * s->blocksize);
+
+		ct = CU8(ct) + n * s->blocksize;
+		pt = U8(pt) + n * s->blocksize;
+	}
+}
+
+void kripto_stream_cbc_encrypt_multi
+(
+	kripto_stream *const *s,
+	const void *const *pt,
+	void *const *ct,
+	const size_t *len,
+	unsigned int n
+)
+{
+	const kripto_block *block[CBC_MULTI];
+	const void *in[CBC_MULTI];
+	void *out[CBC_MULTI];
+	unsigned int lanes;
+	unsigned int i;
+	unsigned int m;
+	size_t off;
+
+	for(; n; n -= lanes)
+	{
+		lanes = n < CBC_MULTI ? n : CBC_MULTI;
+
+		for(off = 0;; off += s[0]->blocksize)
 		{
-			U8(pt)[n] ^=  s->iv[n];
-			s->iv[n] = s->buf[n];
+			/* next block of every stream that has one left */
+			for(i = m = 0; i < lanes; i++)
+			{
+				assert(s[i]->desc == s[0]->desc);
+				assert(s[i]->desc->encrypt == &cbc_encrypt);
+				assert(!(len[i] % s[i]->blocksize));
+
+				if(len[i] <= off) continue;
+
+				XOR(CU8(pt[i]) + off, s[i]->iv, s[i]->iv, s[i]->blocksize);
+
+				block[m] = s[i]->block;
+				in[m] = out[m] = s[i]->iv;
+				m++;
+			}
+			if(!m) break;
+
+			kripto_block_encrypt_multi(block, in, out, m);
+
+			for(i = 0; i < lanes; i++)
+			{
+				if(len[i] > off)
+					memcpy(U8(ct[i]) + off, s[i]->iv, s[i]->blocksize);
+			}
 		}
 
-		ct = CU8(ct) + n;
-		pt = U8(pt) + n;
+		s += lanes;
+		pt += lanes;
+		ct += lanes;
+		len += lanes;
 	}
 }
 
 static void cbc_destroy(kripto_stream *s)
 {
 	kripto_block_destroy(s->block);
-	kripto_memory_wipe(s, sizeof(kripto_stream) + (s->blocksize << 1));
-	free(s);
+	kripto_memory_wipe(s, CBC_SIZE(s->blocksize));
+	kripto_free(s);
 }
 
 struct ext
@@ -115,21 +244,23 @@ static kripto_stream *cbc_create
 	unsigned int iv_len
 )
 {
-	kripto_stream *s = (kripto_stream *)malloc(sizeof(kripto_stream) + (desc->maxiv << 1));
+	kripto_stream *s = (kripto_stream *)kripto_alloc(CBC_SIZE(desc->maxiv));
 	if(!s) return 0;
 
 	s->desc = desc;
 	s->multof = s->blocksize = desc->maxiv;
+	s->blocks = cbc_blocks(s->blocksize);
 
 	s->iv = (uint8_t *)s + sizeof(kripto_stream);
-	s->buf = s->iv + s->blocksize;
+	s->last = s->iv + s->blocksize;
+	s->buf = s->last + s->blocksize;
 
 	/* block cipher */
 	s->block = kripto_block_create(EXT(desc)->block, rounds, key, key_len);
 	if(!s->block)
 	{
-		kripto_memory_wipe(s, sizeof(kripto_stream) + (s->blocksize << 1));
-		free(s);
+		kripto_memory_wipe(s, CBC_SIZE(s->blocksize));
+		kripto_free(s);
 		return 0;
 	}
 
@@ -154,8 +285,8 @@ static kripto_stream *cbc_recreate
 	s->block = kripto_block_recreate(s->block, rounds, key, key_len);
 	if(!s->block)
 	{
-		kripto_memory_wipe(s, sizeof(kripto_stream) + (s->blocksize << 1));
-		free(s);
+		kripto_memory_wipe(s, CBC_SIZE(s->blocksize));
+		kripto_free(s);
 		return 0;
 	}
 
@@ -178,6 +309,7 @@ kripto_desc_stream *kripto_stream_cbc(const kripto_desc_block *block)
 	s->desc.encrypt = &cbc_encrypt;
 	s->desc.decrypt = &cbc_decrypt;
 	s->desc.prng = 0;
+	s->desc.seek = 0;
 	s->desc.destroy = &cbc_destroy;
 	s->desc.maxkey = kripto_block_maxkey(block);
 	s->desc.maxiv = kripto_block_size(block);
@@ -25,6 +25,8 @@
 
 #include <kripto/stream/cfb.h>
 
+#include "../alloc.h"
+
 struct kripto_stream
 {
 	const kripto_desc_stream *desc;
@@ -105,7 +107,7 @@ static void cfb_destroy(kripto_stream *s)
 {
 	kripto_block_destroy(s->block);
 	kripto_memory_wipe(s, sizeof(kripto_stream) + s->blocksize);
-	free(s);
+	kripto_free(s);
 }
 
 struct ext
@@ -126,7 +128,7 @@ static kripto_stream *cfb_create
 	unsigned int iv_len
 )
 {
-	kripto_stream *s = (kripto_stream *)malloc(sizeof(kripto_stream) + desc->maxiv);
+	kripto_stream *s = (kripto_stream *)kripto_alloc(sizeof(kripto_stream) + desc->maxiv);
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -141,7 +143,7 @@ static kripto_stream *cfb_create
 	if(!s->block)
 	{
 		kripto_memory_wipe(s, sizeof(kripto_stream) + s->blocksize);
-		free(s);
+		kripto_free(s);
 		return 0;
 	}
 
@@ -167,7 +169,7 @@ static kripto_stream *cfb_recreate
 	if(!s->block)
 	{
 		kripto_memory_wipe(s, sizeof(kripto_stream) + s->blocksize);
-		free(s);
+		kripto_free(s);
 		return 0;
 	}
 
@@ -192,6 +194,7 @@ kripto_desc_stream *kripto_stream_cfb(const kripto_desc_block *block)
 	s->desc.encrypt = &cfb_encrypt;
 	s->desc.decrypt = &cfb_decrypt;
 	s->desc.prng = &cfb_prng;
+	s->desc.seek = 0;
 	s->desc.destroy = &cfb_destroy;
 	s->desc.maxkey = kripto_block_maxkey(block);
 	s->desc.maxiv = kripto_block_size(block);
@@ -15,16 +15,28 @@
 
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 #include <assert.h>
 
+#if (defined(__GNUC__) || defined(__clang__)) \
+&& (defined(__i386__) || defined(__x86_64__))
+#define SIMD
+#include <immintrin.h>
+#endif
+
+#include <kripto/cast.h>
 #include <kripto/loadstore.h>
 #include <kripto/rotate.h>
+#include <kripto/xor.h>
+#include <kripto/cpu.h>
 #include <kripto/memory.h>
 #include <kripto/stream.h>
 #include <kripto/desc/stream.h>
 
 #include <kripto/stream/chacha.h>
 
+#include "../alloc.h"
+
 struct kripto_stream
 {
 	const kripto_desc_stream *desc;
@@ -33,6 +45,8 @@ struct kripto_stream
 	uint32_t x[16];
 	uint8_t buf[64];
 	unsigned int used;
+	unsigned int lanes;
+	uint64_t ctr;
 };
 
 #define QR(A, B, C, D)			\
@@ -117,29 +131,433 @@ static void chacha_core
 	STORE32L(x15, U8(out) + 60);
 }
 
-static void chacha_crypt
+static void chacha_inc(uint32_t *x, size_t n)
+{
+	const uint64_t ctr = x[12] | ((uint64_t)x[13] << 32);
+
+	assert(ctr + n > ctr);
+
+	x[12] = (uint32_t)(ctr + n);
+	x[13] = (uint32_t)((ctr + n) >> 32);
+}
+
+#ifdef SIMD
+
+/*
+ * Vectorized ChaCha: state word i of W consecutive blocks is kept in
+ * vector v[i], one block per lane, and transposed back on output.
+ */
+
+#define QRV(ADD, XOR, ROL, A, B, C, D)		\
+{						\
+	A = ADD(A, B); D = ROL(XOR(D, A), 16);	\
+	C = ADD(C, D); B = ROL(XOR(B, C), 12);	\
+	A = ADD(A, B); D = ROL(XOR(D, A), 8);	\
+	C = ADD(C, D); B = ROL(XOR(B, C), 7);	\
+}
+
+#define ROUNDSV(ADD, XOR, ROL)						\
+{									\
+	for(i = 0; i < r; i++)						\
+	{								\
+		QRV(ADD, XOR, ROL, v[0], v[4], v[ 8], v[12]);		\
+		QRV(ADD, XOR, ROL, v[1], v[5], v[ 9], v[13]);		\
+		QRV(ADD, XOR, ROL, v[2], v[6], v[10], v[14]);		\
+		QRV(ADD, XOR, ROL, v[3], v[7], v[11], v[15]);		\
+									\
+		if(++i == r) break;					\
+									\
+		QRV(ADD, XOR, ROL, v[0], v[5], v[10], v[15]);		\
+		QRV(ADD, XOR, ROL, v[1], v[6], v[11], v[12]);		\
+		QRV(ADD, XOR, ROL, v[2], v[7], v[ 8], v[13]);		\
+		QRV(ADD, XOR, ROL, v[3], v[4], v[ 9], v[14]);		\
+	}								\
+}
+
+/* SSE2, 4 blocks */
+
+#define ROL128(X, N) \
+	_mm_or_si128(_mm_slli_epi32(X, N), _mm_srli_epi32(X, 32 - (N)))
+
+#define OUT128(X, OFFSET)						\
+{									\
+	if(in) X = _mm_xor_si128(X,					\
+		_mm_loadu_si128((const __m128i *)(CU8(in) + (OFFSET))));	\
+	_mm_storeu_si128((__m128i *)(U8(out) + (OFFSET)), X);		\
+}
+
+__attribute__((target("sse2")))
+static void chacha_sse2
+(
+	unsigned int r,
+	uint32_t *x,
+	const void *in,
+	void *out,
+	size_t blocks
+)
+{
+	__m128i v[16];
+	__m128i t0;
+	__m128i t1;
+	__m128i t2;
+	__m128i t3;
+	__m128i lo;
+	__m128i hi;
+	uint64_t ctr;
+	unsigned int i;
+
+	for(; blocks >= 4; blocks -= 4)
+	{
+		ctr = x[12] | ((uint64_t)x[13] << 32);
+
+		lo = _mm_set_epi32
+		(
+			(int)(uint32_t)(ctr + 3), (int)(uint32_t)(ctr + 2),
+			(int)(uint32_t)(ctr + 1), (int)(uint32_t)ctr
+		);
+		hi = _mm_set_epi32
+		(
+			(int)((ctr + 3) >> 32), (int)((ctr + 2) >> 32),
+			(int)((ctr + 1) >> 32), (int)(ctr >> 32)
+		);
+
+		for(i = 0; i < 16; i++) v[i] = _mm_set1_epi32((int)x[i]);
+		v[12] = lo;
+		v[13] = hi;
+
+		ROUNDSV(_mm_add_epi32, _mm_xor_si128, ROL128);
+
+		for(i = 0; i < 16; i++)
+			v[i] = _mm_add_epi32(v[i], _mm_set1_epi32((int)x[i]));
+		v[12] = _mm_add_epi32(v[12], _mm_sub_epi32(lo, _mm_set1_epi32((int)x[12])));
+		v[13] = _mm_add_epi32(v[13], _mm_sub_epi32(hi, _mm_set1_epi32((int)x[13])));
+
+		/* transpose and output */
+		for(i = 0; i < 16; i += 4)
+		{
+			t0 = _mm_unpacklo_epi32(v[i], v[i + 1]);
+			t1 = _mm_unpacklo_epi32(v[i + 2], v[i + 3]);
+			t2 = _mm_unpackhi_epi32(v[i], v[i + 1]);
+			t3 = _mm_unpackhi_epi32(v[i + 2], v[i + 3]);
+
+			v[i] = _mm_unpacklo_epi64(t0, t1);
+			v[i + 1] = _mm_unpackhi_epi64(t0, t1);
+			v[i + 2] = _mm_unpacklo_epi64(t2, t3);
+			v[i + 3] = _mm_unpackhi_epi64(t2, t3);
+
+			OUT128(v[i], (i << 2));
+			OUT128(v[i + 1], 64 + (i << 2));
+			OUT128(v[i + 2], 128 + (i << 2));
+			OUT128(v[i + 3], 192 + (i << 2));
+		}
+
+		chacha_inc(x, 4);
+
+		if(in) in = CU8(in) + 256;
+		out = U8(out) + 256;
+	}
+}
+
+/* AVX2, 8 blocks */
+
+#define ROL256(X, N)							\
+(									\
+	(N) == 16 ? _mm256_shuffle_epi8(X, rot16) :			\
+	(N) == 8 ? _mm256_shuffle_epi8(X, rot8) :			\
+	_mm256_or_si256(_mm256_slli_epi32(X, N), _mm256_srli_epi32(X, 32 - (N)))	\
+)
+
+#define OUT256(X, OFFSET)						\
+{									\
+	if(in) X = _mm256_xor_si256(X,					\
+		_mm256_loadu_si256((const __m256i *)(CU8(in) + (OFFSET))));	\
+	_mm256_storeu_si256((__m256i *)(U8(out) + (OFFSET)), X);	\
+}
+
+__attribute__((target("avx2")))
+static void chacha_avx2
+(
+	unsigned int r,
+	uint32_t *x,
+	const void *in,
+	void *out,
+	size_t blocks
+)
+{
+	const __m256i rot16 = _mm256_set_epi8
+	(
+		13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2,
+		13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2
+	);
+	const __m256i rot8 = _mm256_set_epi8
+	(
+		14, 13, 12, 15, 10, 9, 8, 11, 6, 5, 4, 7, 2, 1, 0, 3,
+		14, 13, 12, 15, 10, 9, 8, 11, 6, 5, 4, 7, 2, 1, 0, 3
+	);
+	__m256i v[16];
+	__m256i t0;
+	__m256i t1;
+	__m256i t2;
+	__m256i t3;
+	__m256i lo;
+	__m256i hi;
+	uint32_t c[16];
+	uint64_t ctr;
+	unsigned int i;
+
+	for(; blocks >= 8; blocks -= 8)
+	{
+		ctr = x[12] | ((uint64_t)x[13] << 32);
+
+		for(i = 0; i < 8; i++)
+		{
+			c[i] = (uint32_t)(ctr + i);
+			c[i + 8] = (uint32_t)((ctr + i) >> 32);
+		}
+		lo = _mm256_loadu_si256((const __m256i *)c);
+		hi = _mm256_loadu_si256((const __m256i *)(c + 8));
+
+		for(i = 0; i < 16; i++) v[i] = _mm256_set1_epi32((int)x[i]);
+		v[12] = lo;
+		v[13] = hi;
+
+		ROUNDSV(_mm256_add_epi32, _mm256_xor_si256, ROL256);
+
+		for(i = 0; i < 16; i++)
+			v[i] = _mm256_add_epi32(v[i], _mm256_set1_epi32((int)x[i]));
+		v[12] = _mm256_add_epi32(v[12], _mm256_sub_epi32(lo, _mm256_set1_epi32((int)x[12])));
+		v[13] = _mm256_add_epi32(v[13], _mm256_sub_epi32(hi, _mm256_set1_epi32((int)x[13])));
+
+		/* transpose within 128-bit lanes */
+		for(i = 0; i < 16; i += 4)
+		{
+			t0 = _mm256_unpacklo_epi32(v[i], v[i + 1]);
+			t1 = _mm256_unpacklo_epi32(v[i + 2], v[i + 3]);
+			t2 = _mm256_unpackhi_epi32(v[i], v[i + 1]);
+			t3 = _mm256_unpackhi_epi32(v[i + 2], v[i + 3]);
+
+			v[i] = _mm256_unpacklo_epi64(t0, t1);
+			v[i + 1] = _mm256_unpackhi_epi64(t0, t1);
+			v[i + 2] = _mm256_unpacklo_epi64(t2, t3);
+			v[i + 3] = _mm256_unpackhi_epi64(t2, t3);
+		}
+
+		/* block i in low lanes, block i + 4 in high lanes */
+		for(i = 0; i < 4; i++)
+		{
+			t0 = _mm256_permute2x128_si256(v[i], v[i + 4], 0x20);
+			t1 = _mm256_permute2x128_si256(v[i + 8], v[i + 12], 0x20);
+			t2 = _mm256_permute2x128_si256(v[i], v[i + 4], 0x31);
+			t3 = _mm256_permute2x128_si256(v[i + 8], v[i + 12], 0x31);
+
+			OUT256(t0, (i << 6));
+			OUT256(t1, (i << 6) + 32);
+			OUT256(t2, (i << 6) + 256);
+			OUT256(t3, (i << 6) + 288);
+		}
+
+		chacha_inc(x, 8);
+
+		if(in) in = CU8(in) + 512;
+		out = U8(out) + 512;
+	}
+}
+
+/* AVX-512, 16 blocks */
+
+#define OUT512(X, OFFSET)						\
+{									\
+	if(in) X = _mm512_xor_si512(X,					\
+		_mm512_loadu_si512((const void *)(CU8(in) + (OFFSET))));	\
+	_mm512_storeu_si512((void *)(U8(out) + (OFFSET)), X);		\
+}
+
+__attribute__((target("avx512f")))
+static void chacha_avx512
+(
+	unsigned int r,
+	uint32_t *x,
+	const void *in,
+	void *out,
+	size_t blocks
+)
+{
+	__m512i v[16];
+	__m512i t0;
+	__m512i t1;
+	__m512i t2;
+	__m512i t3;
+	__m512i lo;
+	__m512i hi;
+	uint32_t c[32];
+	uint64_t ctr;
+	unsigned int i;
+
+	for(; blocks >= 16; blocks -= 16)
+	{
+		ctr = x[12] | ((uint64_t)x[13] << 32);
+
+		for(i = 0; i < 16; i++)
+		{
+			c[i] = (uint32_t)(ctr + i);
+			c[i + 16] = (uint32_t)((ctr + i) >> 32);
+		}
+		lo = _mm512_loadu_si512((const void *)c);
+		hi = _mm512_loadu_si512((const void *)(c + 16));
+
+		for(i = 0; i < 16; i++) v[i] = _mm512_set1_epi32((int)x[i]);
+		v[12] = lo;
+		v[13] = hi;
+
+		ROUNDSV(_mm512_add_epi32, _mm512_xor_si512, _mm512_rol_epi32);
+
+		for(i = 0; i < 16; i++)
+			v[i] = _mm512_add_epi32(v[i], _mm512_set1_epi32((int)x[i]));
+		v[12] = _mm512_add_epi32(v[12], _mm512_sub_epi32(lo, _mm512_set1_epi32((int)x[12])));
+		v[13] = _mm512_add_epi32(v[13], _mm512_sub_epi32(hi, _mm512_set1_epi32((int)x[13])));
+
+		/* transpose within 128-bit lanes */
+		for(i = 0; i < 16; i += 4)
+		{
+			t0 = _mm512_unpacklo_epi32(v[i], v[i + 1]);
+			t1 = _mm512_unpacklo_epi32(v[i + 2], v[i + 3]);
+			t2 = _mm512_unpackhi_epi32(v[i], v[i + 1]);
+			t3 = _mm512_unpackhi_epi32(v[i + 2], v[i + 3]);
+
+			v[i] = _mm512_unpacklo_epi64(t0, t1);
+			v[i + 1] = _mm512_unpackhi_epi64(t0, t1);
+			v[i + 2] = _mm512_unpacklo_epi64(t2, t3);
+			v[i + 3] = _mm512_unpackhi_epi64(t2, t3);
+		}
+
+		/* transpose 128-bit lanes, lane k holds block i + 4k */
+		for(i = 0; i < 4; i++)
+		{
+			t0 = _mm512_shuffle_i32x4(v[i], v[i + 4], 0x44);
+			t1 = _mm512_shuffle_i32x4(v[i], v[i + 4], 0xEE);
+			t2 = _mm512_shuffle_i32x4(v[i + 8], v[i + 12], 0x44);
+			t3 = _mm512_shuffle_i32x4(v[i + 8], v[i + 12], 0xEE);
+
+			lo = _mm512_shuffle_i32x4(t0, t2, 0x88);
+			hi = _mm512_shuffle_i32x4(t0, t2, 0xDD);
+			t0 = _mm512_shuffle_i32x4(t1, t3, 0x88);
+			t1 = _mm512_shuffle_i32x4(t1, t3, 0xDD);
+
+			OUT512(lo, (i << 6));
+			OUT512(hi, (i << 6) + 256);
+			OUT512(t0, (i << 6) + 512);
+			OUT512(t1, (i << 6) + 768);
+		}
+
+		chacha_inc(x, 16);
+
+		if(in) in = CU8(in) + 1024;
+		out = U8(out) + 1024;
+	}
+}
+
+#endif
+
+/* full blocks, in may be NULL for keystream only */
+static void chacha_blocks
 (
 	kripto_stream *s,
 	const void *in,
 	void *out,
-	size_t len
+	size_t blocks
 )
 {
-	for(size_t i = 0; i < len; i++)
+	size_t n;
+
+	#ifdef SIMD
+	if(s->lanes >= 16 && blocks >= 16)
+	{
+		n = blocks & ~(size_t)15;
+		chacha_avx512(s->r, s->x, in, out, n);
+		if(in) in = CU8(in) + (n << 6);
+		out = U8(out) + (n << 6);
+		blocks -= n;
+	}
+
+	if(s->lanes >= 8 && blocks >= 8)
+	{
+		n = blocks & ~(size_t)7;
+		chacha_avx2(s->r, s->x, in, out, n);
+		if(in) in = CU8(in) + (n << 6);
+		out = U8(out) + (n << 6);
+		blocks -= n;
+	}
+
+	if(s->lanes >= 4 && blocks >= 4)
+	{
+		n = blocks & ~(size_t)3;
+		chacha_sse2(s->r, s->x, in, out, n);
+		if(in) in = CU8(in) + (n << 6);
+		out = U8(out) + (n << 6);
+		blocks -= n;
+	}
+	#endif
+
+	for(; blocks; blocks--)
 	{
-		if(s->used == 64)
+		chacha_core(s->r, s->x, s->buf);
+		chacha_inc(s->x, 1);
+
+		if(in)
+		{
+			XOR(in, s->buf, out, 64);
+			in = CU8(in) + 64;
+		}
+		else
 		{
-			chacha_core(s->r, s->x, s->buf);
-			s->used = 0;
-
-			if(!++s->x[12])
-			{
-				s->x[13]++;
-				assert(s->x[13]);
-			}
+			memcpy(out, s->buf, 64);
 		}
 
-		U8(out)[i] = CU8(in)[i] ^ s->buf[s->used++];
+		out = U8(out) + 64;
+	}
+}
+
+static void chacha_crypt
+(
+	kripto_stream *s,
+	const void *in,
+	void *out,
+	size_t len
+)
+{
+	size_t n;
+
+	/* buffered keystream */
+	if(s->used < 64)
+	{
+		n = 64 - s->used;
+		if(n > len) n = len;
+
+		XOR(in, s->buf + s->used, out, n);
+		s->used += (unsigned int)n;
+
+		in = CU8(in) + n;
+		out = U8(out) + n;
+		len -= n;
+	}
+
+	if(len >= 64)
+	{
+		n = len >> 6;
+		chacha_blocks(s, in, out, n);
+
+		in = CU8(in) + (n << 6);
+		out = U8(out) + (n << 6);
+		len &= 63;
+	}
+
+	if(len)
+	{
+		chacha_core(s->r, s->x, s->buf);
+		chacha_inc(s->x, 1);
+
+		XOR(in, s->buf, out, len);
+		s->used = (unsigned int)len;
 	}
 }
 
@@ -150,21 +568,53 @@ static void chacha_prng
 	size_t len
 )
 {
-	for(size_t i = 0; i < len; i++)
+	size_t n;
+
+	/* buffered keystream */
+	if(s->used < 64)
 	{
-		if(s->used == 64)
-		{
-			chacha_core(s->r, s->x, s->buf);
-			s->used = 0;
-
-			if(!++s->x[12])
-			{
-				s->x[13]++;
-				assert(s->x[13]);
-			}
-		}
+		n = 64 - s->used;
+		if(n > len) n = len;
+
+		memcpy(out, s->buf + s->used, n);
+		s->used += (unsigned int)n;
+
+		out = U8(out) + n;
+		len -= n;
+	}
+
+	if(len >= 64)
+	{
+		n = len >> 6;
+		chacha_blocks(s, 0, out, n);
+
+		out = U8(out) + (n << 6);
+		len &= 63;
+	}
+
+	if(len)
+	{
+		chacha_core(s->r, s->x, s->buf);
+		chacha_inc(s->x, 1);
 
-		U8(out)[i] = s->buf[s->used++];
+		memcpy(out, s->buf, len);
+		s->used = (unsigned int)len;
+	}
+}
+
+static void chacha_seek(kripto_stream *s, uint64_t offset)
+{
+	const uint64_t ctr = s->ctr + (offset >> 6);
+
+	s->x[12] = (uint32_t)ctr;
+	s->x[13] = (uint32_t)(ctr >> 32);
+	s->used = 64;
+
+	if(offset & 63)
+	{
+		chacha_core(s->r, s->x, s->buf);
+		chacha_inc(s->x, 1);
+		s->used = (unsigned int)(offset & 63);
 	}
 }
 
@@ -245,8 +695,16 @@ static kripto_stream *chacha_recreate
 		}
 	}
 
+	s->ctr = s->x[12] | ((uint64_t)s->x[13] << 32);
 	s->used = 64;
 
+	s->lanes = 1;
+	#ifdef SIMD
+	if(kripto_cpu() & KRIPTO_CPU_SSE2) s->lanes = 4;
+	if(kripto_cpu() & KRIPTO_CPU_AVX2) s->lanes = 8;
+	if(kripto_cpu() & KRIPTO_CPU_AVX512) s->lanes = 16;
+	#endif
+
 	return s;
 }
 
@@ -260,7 +718,7 @@ static kripto_stream *chacha_create
 	unsigned int iv_len
 )
 {
-	kripto_stream *s = (kripto_stream *)malloc(sizeof(kripto_stream));
+	kripto_stream *s = (kripto_stream *)kripto_alloc(sizeof(kripto_stream));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -272,7 +730,7 @@ static kripto_stream *chacha_create
 static void chacha_destroy(kripto_stream *s)
 {
 	kripto_memory_wipe(s, sizeof(kripto_stream));
-	free(s);
+	kripto_free(s);
 }
 
 static const struct kripto_desc_stream chacha =
@@ -282,6 +740,7 @@ static const struct kripto_desc_stream chacha =
 	&chacha_crypt,
 	&chacha_crypt,
 	&chacha_prng,
+	&chacha_seek,
 	&chacha_destroy,
 	32, /* max key */
 	24 /* max iv */
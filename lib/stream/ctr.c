@@ -18,6 +18,8 @@
 #include <stdlib.h>
 
 #include <kripto/cast.h>
+#include <kripto/loadstore.h>
+#include <kripto/xor.h>
 #include <kripto/memory.h>
 #include <kripto/block.h>
 #include <kripto/stream.h>
@@ -25,17 +27,87 @@
 
 #include <kripto/stream/ctr.h>
 
+#include "../alloc.h"
+#include "../desc.h"
+
 struct kripto_stream
 {
 	const kripto_desc_stream *desc;
 	unsigned int multof;
 	kripto_block *block;
 	uint8_t *x;
+	uint8_t *iv;
 	uint8_t *buf;
 	unsigned int blocksize;
+	unsigned int blocks;
+	unsigned int len;
 	unsigned int used;
 };
 
+/* keystream buffer */
+#define CTR_BUF 256
+
+#define CTR_SIZE(BS) (sizeof(kripto_stream) + ((BS) << 1) + ctr_blocks(BS) * (BS))
+
+static unsigned int ctr_blocks(unsigned int blocksize)
+{
+	if(blocksize >= CTR_BUF) return 1;
+
+	return CTR_BUF / blocksize;
+}
+
+static void ctr_inc(uint8_t *x, unsigned int len)
+{
+	uint32_t t;
+
+	/* first byte is never incremented */
+	if(len >= 8)
+	{
+		t = LOAD32B(x + len - 4) + 1;
+		STORE32B(t, x + len - 4);
+		if(t) return;
+
+		len -= 4;
+	}
+
+	while(--len)
+		if(++x[len]) break;
+}
+
+static void ctr_add(uint8_t *x, unsigned int len, uint64_t n)
+{
+	unsigned int t;
+
+	/* first byte is never incremented */
+	while(--len && n)
+	{
+		t = x[len] + (unsigned int)(n & 0xFF);
+		x[len] = (uint8_t)t;
+		n = (n >> 8) + (t >> 8);
+	}
+}
+
+/* encrypts only as many counter blocks as needed for len bytes */
+static void ctr_keystream(kripto_stream *s, size_t len)
+{
+	unsigned int n;
+	unsigned int i;
+
+	if(len / s->blocksize >= s->blocks) n = s->blocks;
+	else n = (unsigned int)((len + s->blocksize - 1) / s->blocksize);
+
+	for(i = 0; i < n; i++)
+	{
+		memcpy(s->buf + i * s->blocksize, s->x, s->blocksize);
+		ctr_inc(s->x, s->blocksize);
+	}
+
+	kripto_block_encrypt_blocks(s->block, s->buf, s->buf, n);
+
+	s->len = n * s->blocksize;
+	s->used = 0;
+}
+
 static void ctr_crypt
 (
 	kripto_stream *s,
@@ -44,21 +116,21 @@ static void ctr_crypt
 	size_t len
 )
 {
-	size_t i;
-	unsigned int n;
+	size_t n;
 
-	for(i = 0; i < len; i++)
+	while(len)
 	{
-		if(s->used == s->blocksize)
-		{
-			kripto_block_encrypt(s->block, s->x, s->buf);
-			s->used = 0;
+		if(s->used == s->len) ctr_keystream(s, len);
+
+		n = s->len - s->used;
+		if(n > len) n = len;
 
-			for(n = s->blocksize - 1; n; n--)
-				if(++s->x[n]) break;
-		}
+		XOR(in, s->buf + s->used, out, n);
+		s->used += (unsigned int)n;
 
-		U8(out)[i] = CU8(in)[i] ^ s->buf[s->used++];
+		in = CU8(in) + n;
+		out = U8(out) + n;
+		len -= n;
 	}
 }
 
@@ -69,29 +141,42 @@ static void ctr_prng
 	size_t len
 )
 {
-	size_t i;
-	unsigned int n;
+	size_t n;
 
-	for(i = 0; i < len; i++)
+	while(len)
 	{
-		if(s->used == s->blocksize)
-		{
-			kripto_block_encrypt(s->block, s->x, s->buf);
-			s->used = 0;
+		if(s->used == s->len) ctr_keystream(s, len);
+
+		n = s->len - s->used;
+		if(n > len) n = len;
+
+		memcpy(out, s->buf + s->used, n);
+		s->used += (unsigned int)n;
+
+		out = U8(out) + n;
+		len -= n;
+	}
+}
 
-			for(n = s->blocksize - 1; n; n--)
-				if(++s->x[n]) break;
-		}
+static void ctr_seek(kripto_stream *s, uint64_t offset)
+{
+	memcpy(s->x, s->iv, s->blocksize);
+	ctr_add(s->x, s->blocksize, offset / s->blocksize);
+
+	s->used = s->len = 0;
 
-		U8(out)[i] = s->buf[s->used++];
+	if(offset % s->blocksize)
+	{
+		ctr_keystream(s, 1);
+		s->used = (unsigned int)(offset % s->blocksize);
 	}
 }
 
 static void ctr_destroy(kripto_stream *s)
 {
 	kripto_block_destroy(s->block);
-	kripto_memory_wipe(s, sizeof(kripto_stream) + (s->blocksize << 1));
-	free(s);
+	kripto_memory_wipe(s, CTR_SIZE(s->blocksize));
+	kripto_free(s);
 }
 
 struct ext
@@ -112,29 +197,33 @@ static kripto_stream *ctr_create
 	unsigned int iv_len
 )
 {
-	kripto_stream *s = (kripto_stream *)malloc(sizeof(kripto_stream) + (desc->maxiv << 1));
+	kripto_stream *s = (kripto_stream *)kripto_alloc(CTR_SIZE(desc->maxiv));
 	if(!s) return 0;
 
 	s->desc = desc;
 	s->multof = 1;
 
-	s->used = s->blocksize = desc->maxiv;
+	s->blocksize = desc->maxiv;
+	s->blocks = ctr_blocks(s->blocksize);
+	s->used = s->len = 0;
 
 	s->x = (uint8_t *)s + sizeof(kripto_stream);
-	s->buf = s->x + s->blocksize;
+	s->iv = s->x + s->blocksize;
+	s->buf = s->iv + s->blocksize;
 
 	/* block cipher */
 	s->block = kripto_block_create(EXT(desc)->block, rounds, key, key_len);
 	if(!s->block)
 	{
-		kripto_memory_wipe(s, sizeof(kripto_stream) + (s->blocksize << 1));
-		free(s);
+		kripto_memory_wipe(s, CTR_SIZE(s->blocksize));
+		kripto_free(s);
 		return 0;
 	}
 
 	/* IV (nonce) */
-	if(iv_len) memcpy(s->x, iv, iv_len);
-	memset(s->x + iv_len, 0, s->blocksize - iv_len);
+	if(iv_len) memcpy(s->iv, iv, iv_len);
+	memset(s->iv + iv_len, 0, s->blocksize - iv_len);
+	memcpy(s->x, s->iv, s->blocksize);
 
 	return s;
 }
@@ -153,23 +242,27 @@ static kripto_stream *ctr_recreate
 	s->block = kripto_block_recreate(s->block, rounds, key, key_len);
 	if(!s->block)
 	{
-		kripto_memory_wipe(s, sizeof(kripto_stream) + (s->blocksize << 1));
-		free(s);
+		kripto_memory_wipe(s, CTR_SIZE(s->blocksize));
+		kripto_free(s);
 		return 0;
 	}
 
 	/* IV (nonce) */
-	if(iv_len) memcpy(s->x, iv, iv_len);
-	memset(s->x + iv_len, 0, s->blocksize - iv_len);
+	if(iv_len) memcpy(s->iv, iv, iv_len);
+	memset(s->iv + iv_len, 0, s->blocksize - iv_len);
+	memcpy(s->x, s->iv, s->blocksize);
 
-	s->used = s->blocksize;
+	s->used = s->len = 0;
 
 	return s;
 }
 
-kripto_desc_stream *kripto_stream_ctr(const kripto_desc_block *block)
+static kripto_desc_stream *ctr_desc
+(
+	struct ext *s,
+	const kripto_desc_block *block
+)
 {
-	struct ext *s = (struct ext *)malloc(sizeof(struct ext));
 	if(!s) return 0;
 
 	s->block = block;
@@ -179,9 +272,20 @@ kripto_desc_stream *kripto_stream_ctr(const kripto_desc_block *block)
 	s->desc.encrypt = &ctr_crypt;
 	s->desc.decrypt = &ctr_crypt;
 	s->desc.prng = &ctr_prng;
+	s->desc.seek = &ctr_seek;
 	s->desc.destroy = &ctr_destroy;
 	s->desc.maxkey = kripto_block_maxkey(block);
 	s->desc.maxiv = kripto_block_size(block);
 
 	return (kripto_desc_stream *)s;
 }
+
+kripto_desc_stream *kripto_stream_ctr(const kripto_desc_block *block)
+{
+	return ctr_desc((struct ext *)malloc(sizeof(struct ext)), block);
+}
+
+kripto_desc_stream *kripto_stream_ctr_alloc(const kripto_desc_block *block)
+{
+	return ctr_desc((struct ext *)kripto_alloc(sizeof(struct ext)), block);
+}
@@ -25,6 +25,8 @@
 
 #include <kripto/stream/ecb.h>
 
+#include "../alloc.h"
+
 struct kripto_stream
 {
 	const kripto_desc_stream *desc;
@@ -41,10 +43,7 @@ static void ecb_encrypt
 	size_t len
 )
 {
-	size_t i;
-
-	for(i = 0; i < len; i += s->blocksize)
-		kripto_block_encrypt(s->block, CU8(pt) + i, U8(ct) + i);
+	kripto_block_encrypt_blocks(s->block, pt, ct, len / s->blocksize);
 }
 
 static void ecb_decrypt
@@ -55,17 +54,14 @@ static void ecb_decrypt
 	size_t len
 )
 {
-	size_t i;
-
-	for(i = 0; i < len; i += s->blocksize)
-		kripto_block_decrypt(s->block, CU8(ct) + i, U8(pt) + i);
+	kripto_block_decrypt_blocks(s->block, ct, pt, len / s->blocksize);
 }
 
 static void ecb_destroy(kripto_stream *s)
 {
 	kripto_block_destroy(s->block);
 	kripto_memory_wipe(s, sizeof(kripto_stream));
-	free(s);
+	kripto_free(s);
 }
 
 struct ext
@@ -86,7 +82,7 @@ static kripto_stream *ecb_create
 	unsigned int iv_len
 )
 {
-	kripto_stream *s = (kripto_stream *)malloc(sizeof(kripto_stream));
+	kripto_stream *s = (kripto_stream *)kripto_alloc(sizeof(kripto_stream));
 	if(!s) return 0;
 
 	(void)iv;
@@ -102,7 +98,7 @@ static kripto_stream *ecb_create
 	if(!s->block)
 	{
 		kripto_memory_wipe(s, sizeof(kripto_stream));
-		free(s);
+		kripto_free(s);
 		return 0;
 	}
 
@@ -127,7 +123,7 @@ static kripto_stream *ecb_recreate
 	if(!s->block)
 	{
 		kripto_memory_wipe(s, sizeof(kripto_stream));
-		free(s);
+		kripto_free(s);
 		return 0;
 	}
 
@@ -146,6 +142,7 @@ kripto_desc_stream *kripto_stream_ecb(const kripto_desc_block *block)
 	s->desc.encrypt = &ecb_encrypt;
 	s->desc.decrypt = &ecb_decrypt;
 	s->desc.prng = 0;
+	s->desc.seek = 0;
 	s->desc.destroy = &ecb_destroy;
 	s->desc.maxkey = kripto_block_maxkey(block);
 	s->desc.maxiv = 0;
@@ -28,6 +28,8 @@
 #include <kripto/stream/keccak1600.h>
 #include <kripto/stream/keccak800.h>
 
+#include "../alloc.h"
+
 struct kripto_stream
 {
 	const kripto_desc_stream *desc;
@@ -91,7 +93,7 @@ static kripto_stream *keccak_recreate
 static void keccak_destroy(kripto_stream *s)
 {
 	kripto_hash_destroy(s->hash);
-	free(s);
+	kripto_free(s);
 }
 
 /* 1600 */
@@ -105,7 +107,7 @@ static kripto_stream *keccak1600_create
 	unsigned int iv_len
 )
 {
-	kripto_stream *s = (kripto_stream *)malloc(sizeof(kripto_stream));
+	kripto_stream *s = (kripto_stream *)kripto_alloc(sizeof(kripto_stream));
 	if(!s) return 0;
 
 	(void)desc;
@@ -116,7 +118,7 @@ static kripto_stream *keccak1600_create
 	s->hash = kripto_hash_create(kripto_hash_keccak1600, r, 0, 0, key_len);
 	if(!s->hash)
 	{
-		free(s);
+		kripto_free(s);
 		return 0;
 	}
 
@@ -133,6 +135,7 @@ static const kripto_desc_stream keccak1600 =
 	&keccak_crypt,
 	&keccak_crypt,
 	&keccak_prng,
+	0, /* seek */
 	&keccak_destroy,
 	99, /* max key */
 	UINT_MAX /* max iv */
@@ -151,7 +154,7 @@ static kripto_stream *keccak800_create
 	unsigned int iv_len
 )
 {
-	kripto_stream *s = (kripto_stream *)malloc(sizeof(kripto_stream));
+	kripto_stream *s = (kripto_stream *)kripto_alloc(sizeof(kripto_stream));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -160,7 +163,7 @@ static kripto_stream *keccak800_create
 	s->hash = kripto_hash_create(kripto_hash_keccak800, r, 0, 0, key_len);
 	if(!s->hash)
 	{
-		free(s);
+		kripto_free(s);
 		return 0;
 	}
 
@@ -177,6 +180,7 @@ static const kripto_desc_stream keccak800 =
 	&keccak_crypt,
 	&keccak_crypt,
 	&keccak_prng,
+	0, /* seek */
 	&keccak_destroy,
 	49, /* max key */
 	UINT_MAX /* max iv */
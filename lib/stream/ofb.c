@@ -25,6 +25,8 @@
 
 #include <kripto/stream/ofb.h>
 
+#include "../alloc.h"
+
 struct kripto_stream
 {
 	const kripto_desc_stream *desc;
@@ -82,7 +84,7 @@ static void ofb_destroy(kripto_stream *s)
 {
 	kripto_block_destroy(s->block);
 	kripto_memory_wipe(s, sizeof(kripto_stream) + s->blocksize);
-	free(s);
+	kripto_free(s);
 }
 
 struct ext
@@ -103,7 +105,7 @@ static kripto_stream *ofb_create
 	unsigned int iv_len
 )
 {
-	kripto_stream *s = (kripto_stream *)malloc(sizeof(kripto_stream) + desc->maxiv);
+	kripto_stream *s = (kripto_stream *)kripto_alloc(sizeof(kripto_stream) + desc->maxiv);
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -118,7 +120,7 @@ static kripto_stream *ofb_create
 	if(!s->block)
 	{
 		kripto_memory_wipe(s, sizeof(kripto_stream) + s->blocksize);
-		free(s);
+		kripto_free(s);
 		return 0;
 	}
 
@@ -144,7 +146,7 @@ static kripto_stream *ofb_recreate
 	if(!s->block)
 	{
 		kripto_memory_wipe(s, sizeof(kripto_stream) + s->blocksize);
-		free(s);
+		kripto_free(s);
 		return 0;
 	}
 
@@ -169,6 +171,7 @@ kripto_desc_stream *kripto_stream_ofb(const kripto_desc_block *block)
 	s->desc.encrypt = &ofb_crypt;
 	s->desc.decrypt = &ofb_crypt;
 	s->desc.prng = &ofb_prng;
+	s->desc.seek = 0;
 	s->desc.destroy = &ofb_destroy;
 	s->desc.maxkey = kripto_block_maxkey(block);
 	s->desc.maxiv = kripto_block_size(block);
@@ -24,6 +24,8 @@
 
 #include <kripto/stream/rc4.h>
 
+#include "../alloc.h"
+
 struct kripto_stream
 {
 	const kripto_desc_stream *desc;
@@ -142,7 +144,7 @@ static kripto_stream *rc4_create
 	unsigned int iv_len
 )
 {
-	kripto_stream *s = (kripto_stream *)malloc(sizeof(kripto_stream));
+	kripto_stream *s = (kripto_stream *)kripto_alloc(sizeof(kripto_stream));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -154,7 +156,7 @@ static kripto_stream *rc4_create
 static void rc4_destroy(kripto_stream *s)
 {
 	kripto_memory_wipe(s, sizeof(kripto_stream));
-	free(s);
+	kripto_free(s);
 }
 
 static const struct kripto_desc_stream rc4_desc =
@@ -164,6 +166,7 @@ static const struct kripto_desc_stream rc4_desc =
 	&rc4_crypt,
 	&rc4_crypt,
 	&rc4_prng,
+	0, /* seek */
 	&rc4_destroy,
 	256, /* max key */
 	0 /* max iv */
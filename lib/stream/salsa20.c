@@ -25,6 +25,8 @@
 
 #include <kripto/stream/salsa20.h>
 
+#include "../alloc.h"
+
 struct kripto_stream
 {
 	const kripto_desc_stream *desc;
@@ -33,6 +35,7 @@ struct kripto_stream
 	uint32_t x[16];
 	uint8_t buf[64];
 	unsigned int used;
+	uint64_t ctr;
 };
 
 #define QR(A, B, C, D)		\
@@ -168,6 +171,27 @@ static void salsa20_prng
 	}
 }
 
+static void salsa20_seek(kripto_stream *s, uint64_t offset)
+{
+	const uint64_t ctr = s->ctr + (offset >> 6);
+
+	s->x[8] = (uint32_t)ctr;
+	s->x[9] = (uint32_t)(ctr >> 32);
+	s->used = 64;
+
+	if(offset & 63)
+	{
+		salsa20_core(s->r, s->x, s->buf);
+		s->used = (unsigned int)(offset & 63);
+
+		if(!++s->x[8])
+		{
+			s->x[9]++;
+			assert(s->x[9]);
+		}
+	}
+}
+
 static kripto_stream *salsa20_recreate
 (
 	kripto_stream *s,
@@ -247,6 +271,7 @@ static kripto_stream *salsa20_recreate
 		s->x[14] = s->x[9]; s->x[9] = 0;
 	}
 
+	s->ctr = s->x[8] | ((uint64_t)s->x[9] << 32);
 	s->used = 64;
 
 	return s;
@@ -262,7 +287,7 @@ static kripto_stream *salsa20_create
 	unsigned int iv_len
 )
 {
-	kripto_stream *s = (kripto_stream *)malloc(sizeof(kripto_stream));
+	kripto_stream *s = (kripto_stream *)kripto_alloc(sizeof(kripto_stream));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -274,7 +299,7 @@ static kripto_stream *salsa20_create
 static void salsa20_destroy(kripto_stream *s)
 {
 	kripto_memory_wipe(s, sizeof(kripto_stream));
-	free(s);
+	kripto_free(s);
 }
 
 static const struct kripto_desc_stream salsa20 =
@@ -284,6 +309,7 @@ static const struct kripto_desc_stream salsa20 =
 	&salsa20_crypt,
 	&salsa20_crypt,
 	&salsa20_prng,
+	&salsa20_seek,
 	&salsa20_destroy,
 	32, /* max key */
 	24 /* max iv */
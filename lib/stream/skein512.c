@@ -29,6 +29,8 @@
 
 #include <kripto/stream/skein512.h>
 
+#include "../alloc.h"
+
 struct kripto_stream
 {
 	const kripto_desc_stream *desc;
@@ -76,7 +78,7 @@ static kripto_stream *skein512_recreate
 	unsigned int i;
 
 	s->r = r;
-	s->i = 0;
+	s->i = 64;
 	memset(k, 0, 64);
 	memset(s->ctr, 0, 64);
 
@@ -167,6 +169,29 @@ static kripto_stream *skein512_recreate
 	return s;
 }
 
+static void skein512_output(kripto_stream *s)
+{
+	unsigned int i;
+
+	kripto_block_encrypt(s->block, s->ctr, s->buf);
+	for(i = 0; i < 64; i++)
+		s->buf[i] ^= s->ctr[i];
+
+	if(!++s->ctr[0])
+	if(!++s->ctr[1])
+	if(!++s->ctr[2])
+	if(!++s->ctr[3])
+	if(!++s->ctr[4])
+	if(!++s->ctr[5])
+	if(!++s->ctr[6])
+	{
+		s->ctr[7]++;
+		assert(s->ctr[7]);
+	}
+
+	s->i = 0;
+}
+
 static void skein512_crypt
 (
 	kripto_stream *s,
@@ -179,26 +204,7 @@ static void skein512_crypt
 
 	for(i = 0; i < len; i++)
 	{
-		if(s->i == 64)
-		{
-			kripto_block_encrypt(s->block, s->ctr, s->buf);
-			for(s->i = 0; s->i < 64; s->i++)
-				s->buf[s->i] ^= s->ctr[s->i];
-
-			if(!++s->ctr[0])
-			if(!++s->ctr[1])
-			if(!++s->ctr[2])
-			if(!++s->ctr[3])
-			if(!++s->ctr[4])
-			if(!++s->ctr[5])
-			if(!++s->ctr[6])
-			{
-				s->ctr[7]++;
-				assert(s->ctr[7]);
-			}
-
-			s->i = 0;
-		}
+		if(s->i == 64) skein512_output(s);
 
 		U8(out)[i] = CU8(in)[i] ^ s->buf[s->i++];
 	}
@@ -210,31 +216,24 @@ static void skein512_prng(kripto_stream *s, void *out, size_t len)
 
 	for(i = 0; i < len; i++)
 	{
-		if(s->i == 64)
-		{
-			kripto_block_encrypt(s->block, s->ctr, s->buf);
-			for(s->i = 0; s->i < 64; s->i++)
-				s->buf[s->i] ^= s->ctr[s->i];
-
-			if(!++s->ctr[0])
-			if(!++s->ctr[1])
-			if(!++s->ctr[2])
-			if(!++s->ctr[3])
-			if(!++s->ctr[4])
-			if(!++s->ctr[5])
-			if(!++s->ctr[6])
-			{
-				s->ctr[7]++;
-				assert(s->ctr[7]);
-			}
-
-			s->i = 0;
-		}
+		if(s->i == 64) skein512_output(s);
 
 		U8(out)[i] = s->buf[s->i++];
 	}
 }
 
+static void skein512_seek(kripto_stream *s, uint64_t offset)
+{
+	STORE64L(offset / 64, s->ctr);
+	s->i = 64;
+
+	if(offset % 64)
+	{
+		skein512_output(s);
+		s->i = (unsigned int)(offset % 64);
+	}
+}
+
 static kripto_stream *skein512_create
 (
 	const kripto_desc_stream *desc,
@@ -245,7 +244,7 @@ static kripto_stream *skein512_create
 	unsigned int iv_len
 )
 {
-	kripto_stream *s = (kripto_stream *)malloc(sizeof(kripto_stream));
+	kripto_stream *s = (kripto_stream *)kripto_alloc(sizeof(kripto_stream));
 	if(!s) return 0;
 
 	s->desc = desc;
@@ -254,7 +253,7 @@ static kripto_stream *skein512_create
 	s->block = kripto_block_create(kripto_block_threefish512, r, "", 1);
 	if(!s->block)
 	{
-		free(s);
+		kripto_free(s);
 		return 0;
 	}
 
@@ -265,7 +264,7 @@ static void skein512_destroy(kripto_stream *s)
 {
 	kripto_block_destroy(s->block);
 	kripto_memory_wipe(s, sizeof(kripto_stream));
-	free(s);
+	kripto_free(s);
 }
 
 static const kripto_desc_stream skein512 =
@@ -275,6 +274,7 @@ static const kripto_desc_stream skein512 =
 	&skein512_crypt,
 	&skein512_crypt,
 	&skein512_prng,
+	&skein512_seek,
 	&skein512_destroy,
 	UINT_MAX, /* max key */
 	UINT_MAX /* max iv */
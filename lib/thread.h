@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2026 by Gregor Pintar <grpintar@gmail.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef LIB_THREAD_H
+#define LIB_THREAD_H
+
+/*
+ * Fork and join for independent work items. Items that can not
+ * get a thread (no threads on this target, pthread_create failed)
+ * run on the calling thread, so the result never depends on it.
+ * Define KRIPTO_NO_THREADS to build without threads.
+ */
+
+#include <stddef.h>
+#include <assert.h>
+
+#include <kripto/cast.h>
+
+#if defined(KRIPTO_UNIX) && !defined(KRIPTO_NO_THREADS)
+#define KRIPTO_THREADS
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#ifndef KRIPTO_THREADS_MAX
+#define KRIPTO_THREADS_MAX 64
+#endif
+
+/* online cpus, at most KRIPTO_THREADS_MAX */
+static inline unsigned int thread_count(void)
+{
+	#ifdef KRIPTO_THREADS
+	long n = sysconf(_SC_NPROCESSORS_ONLN);
+
+	if(n < 1) return 1;
+	if(n > KRIPTO_THREADS_MAX) return KRIPTO_THREADS_MAX;
+
+	return (unsigned int)n;
+	#else
+	return 1;
+	#endif
+}
+
+/* f(arg + i * size) for i < n, the first on the calling thread */
+static inline void thread_run
+(
+	void *(*f)(void *),
+	void *arg,
+	size_t size,
+	unsigned int n
+)
+{
+	#ifdef KRIPTO_THREADS
+	pthread_t t[KRIPTO_THREADS_MAX];
+	int ok[KRIPTO_THREADS_MAX];
+	unsigned int i;
+
+	assert(n <= KRIPTO_THREADS_MAX);
+
+	for(i = 1; i < n; i++)
+		ok[i] = !pthread_create(&t[i], 0, f, U8(arg) + i * size);
+
+	if(n) (void)f(arg);
+
+	for(i = 1; i < n; i++)
+	{
+		if(ok[i]) (void)pthread_join(t[i], 0);
+		else (void)f(U8(arg) + i * size);
+	}
+	#else
+	unsigned int i;
+
+	for(i = 0; i < n; i++)
+		(void)f(U8(arg) + i * size);
+	#endif
+}
+
+#endif
@@ -0,0 +1,229 @@
+/*
+ * Copyright (C) 2026 by Gregor Pintar <grpintar@gmail.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/* cc -Wall -Wextra -std=c99 -pedantic perf/ae.c -Iinclude lib/libkripto.a -O2 -DPERF_UNIX -D_GNU_SOURCE */
+/* cc -Wall -Wextra -std=c99 -pedantic perf/ae.c -Iinclude lib/libkripto.a -O2 -DPERF_WINDOWS /lib/w32api/libpowrprof.a */
+
+/* optional argument: only AE whose name contains it, e.g. "EAX Rijndael" */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include <kripto/block.h>
+#include <kripto/stream.h>
+#include <kripto/hash.h>
+#include <kripto/mac.h>
+#include <kripto/ae.h>
+
+#include <kripto/stream/chacha.h>
+#include <kripto/stream/ctr.h>
+#include <kripto/stream/keccak1600.h>
+#include <kripto/stream/salsa20.h>
+#include <kripto/stream/skein512.h>
+
+#include <kripto/hash/sha2_256.h>
+
+#include <kripto/mac/hmac.h>
+#include <kripto/mac/keccak1600.h>
+#include <kripto/mac/omac.h>
+#include <kripto/mac/skein256.h>
+#include <kripto/mac/skein512.h>
+
+#include <kripto/ae/eax.h>
+#include <kripto/ae/eax2.h>
+
+#include "ciphers.h"
+#include "message.h"
+
+#define BULK (1 << 20)
+
+#define MAXKEY 64
+#define MAXTAG 16
+#define MAXIV 32
+
+static const size_t message[4] = {64, 576, 1500, 16384};
+
+static void ae
+(
+	const char *name,
+	const kripto_desc_ae *desc,
+	unsigned int key_len,
+	uint8_t *buf
+)
+{
+	perf_int cycles;
+	uint8_t k[MAXKEY];
+	uint8_t iv[MAXIV];
+	uint8_t tag[MAXTAG];
+
+	if(key_len > kripto_ae_maxkey(desc)) key_len = kripto_ae_maxkey(desc);
+
+	unsigned int tag_len = kripto_ae_maxtag(desc);
+	if(tag_len > MAXTAG) tag_len = MAXTAG;
+
+	unsigned int iv_len = kripto_ae_maxiv(desc);
+	if(iv_len > MAXIV) iv_len = MAXIV;
+
+	memset(k, 0x5A, key_len);
+	memset(iv, 0xA5, iv_len);
+
+	kripto_ae *s = kripto_ae_create(desc, 0, k, key_len, iv, iv_len, tag_len);
+	if(!s)
+	{
+		printf("%s: not supported\n\n", name);
+		return;
+	}
+
+	puts(name);
+
+	/* setup, new key and nonce */
+	perf_n = SETUP_ITERATIONS;
+	PERF_START
+	for(unsigned int r = 0; r < SETUP_BATCH; r++)
+	{
+		s = kripto_ae_recreate(s, 0, k, key_len, iv, iv_len, tag_len);
+		if(!s) perf_die("kripto_ae_recreate()");
+	}
+	PERF_STOP
+
+	printf("%u-bit setup: %lu cycles\n", key_len * 8,
+		(unsigned long)(cycles / SETUP_BATCH));
+	perf_report(SETUP_BATCH);
+	perf_record(name, key_len * 8, "setup", 0, SETUP_BATCH, cycles);
+
+	/* whole packet, with setup and tag */
+	unsigned int multof = kripto_ae_multof(s);
+
+	for(unsigned int i = 0; i < 4; i++)
+	{
+		if(message[i] % multof) continue;
+
+		size_t batch = perf_batch(message[i], SETUP_BATCH);
+
+		PERF_START
+		for(size_t r = 0; r < batch; r++)
+		{
+			s = kripto_ae_recreate(s, 0, k, key_len, iv, iv_len, tag_len);
+			if(!s) perf_die("kripto_ae_recreate()");
+			kripto_ae_encrypt(s, buf, buf, message[i]);
+			kripto_ae_tag(s, tag, tag_len);
+		}
+		PERF_STOP
+
+		printf("%5lu B message: %lu cycles, %.2f cpb",
+			(unsigned long)message[i],
+			(unsigned long)(cycles / batch),
+			cycles / ((double)message[i] * batch));
+		if(perf_hz)
+		{
+			printf(", %.0f messages/s, %.3f GB/s",
+				batch * perf_hz / cycles,
+				message[i] * batch * perf_hz / cycles / 1e9);
+		}
+		putchar('\n');
+		perf_report(batch);
+		perf_record(name, key_len * 8, "message", message[i], batch, cycles);
+	}
+
+	/* bulk encrypt, without setup and tag */
+	s = kripto_ae_recreate(s, 0, k, key_len, iv, iv_len, tag_len);
+	if(!s) perf_die("kripto_ae_recreate()");
+
+	perf_n = BYTES / BULK;
+	PERF_START
+	kripto_ae_encrypt(s, buf, buf, BULK);
+	PERF_STOP
+
+	printf("bulk: %.2f cpb", cycles / (double)BULK);
+	if(perf_hz) printf(", %.3f GB/s", BULK * perf_hz / cycles / 1e9);
+	putchar('\n');
+	perf_report(BULK);
+	perf_record(name, key_len * 8, "encrypt", BULK, 1, cycles);
+
+	kripto_ae_destroy(s);
+
+	perf_rest();
+	fflush(stdout);
+	putchar('\n');
+}
+
+int main(int argc, char *argv[])
+{
+	const struct perf_cipher ciphers[PERF_CIPHERS] = {PERF_CIPHER_LIST};
+	const char *filter = argc > 1 ? argv[1] : "";
+	char name[64];
+
+	uint8_t *buf = (uint8_t *)malloc(BULK);
+	if(!buf) perf_die("malloc()");
+	memset(buf, 0, BULK);
+
+	perf_init();
+
+	/* EAX over each block cipher */
+	for(unsigned int i = 0; i < PERF_CIPHERS; i++)
+	{
+		(void)snprintf(name, sizeof(name), "EAX %s", ciphers[i].name);
+		if(!strstr(name, filter)) continue;
+
+		kripto_desc_ae *desc = kripto_ae_eax(ciphers[i].desc);
+		if(!desc) perf_die("kripto_ae_eax()");
+
+		ae(name, desc, 32, buf);
+
+		free(desc);
+	}
+
+	/* EAX2 over stream and MAC pairs, key is split between them */
+	kripto_desc_stream *ctr = kripto_stream_ctr(kripto_block_rijndael128);
+	kripto_desc_mac *omac = kripto_mac_omac(kripto_block_rijndael128);
+	kripto_desc_mac *hmac = kripto_mac_hmac(kripto_hash_sha2_256);
+	if(!ctr || !omac || !hmac) perf_die("malloc()");
+
+	struct
+	{
+		const char *name;
+		const kripto_desc_stream *stream;
+		const kripto_desc_mac *mac;
+	} pairs[6] =
+	{
+		{"EAX2 CTR Rijndael-128 OMAC Rijndael-128", ctr, omac},
+		{"EAX2 ChaCha HMAC SHA2-256", kripto_stream_chacha, hmac},
+		{"EAX2 ChaCha Skein-256", kripto_stream_chacha, kripto_mac_skein256},
+		{"EAX2 Salsa20 Skein-256", kripto_stream_salsa20, kripto_mac_skein256},
+		{"EAX2 Keccak-1600", kripto_stream_keccak1600, kripto_mac_keccak1600},
+		{"EAX2 Skein-512", kripto_stream_skein512, kripto_mac_skein512}
+	};
+
+	for(unsigned int i = 0; i < 6; i++)
+	{
+		if(!strstr(pairs[i].name, filter)) continue;
+
+		kripto_desc_ae *desc = kripto_ae_eax2(pairs[i].stream, pairs[i].mac);
+		if(!desc) perf_die("kripto_ae_eax2()");
+
+		ae(pairs[i].name, desc, MAXKEY, buf);
+
+		free(desc);
+	}
+
+	free(hmac);
+	free(omac);
+	free(ctr);
+	free(buf);
+
+	return 0;
+}
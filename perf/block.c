@@ -16,6 +16,13 @@
 /* cc -Wall -Wextra -std=c99 -pedantic perf/block.c -Iinclude lib/libkripto.a -O2 -DPERF_UNIX -D_GNU_SOURCE */
 /* cc -Wall -Wextra -std=c99 -pedantic perf/block.c -Iinclude lib/libkripto.a -O2 -DPERF_WINDOWS /lib/w32api/libpowrprof.a */
 
+/*
+ * -DKEYS=1024 rotates through that many pre-expanded keys and -DEVICT=1048576
+ * touches that many bytes before each operation to push tables and key
+ * schedules out of the cache. Either one adds key setup, first block and
+ * steady state lines, as means rather than minimums.
+ */
+
 #include <stdint.h>
 #include <stdio.h>
 #include <string.h>
@@ -23,48 +30,7 @@
 
 #include <kripto/block.h>
 
-#include <kripto/block/3way.h>
-#include <kripto/block/anubis.h>
-#include <kripto/block/aria.h>
-#include <kripto/block/blowfish.h>
-#include <kripto/block/camellia.h>
-#include <kripto/block/cast5.h>
-#include <kripto/block/crax_s.h>
-#include <kripto/block/des.h>
-#include <kripto/block/gost.h>
-#include <kripto/block/idea.h>
-#include <kripto/block/khazad.h>
-#include <kripto/block/lea.h>
-#include <kripto/block/noekeon.h>
-#include <kripto/block/rc2.h>
-#include <kripto/block/rc5.h>
-#include <kripto/block/rc6.h>
-#include <kripto/block/rectangle.h>
-#include <kripto/block/rijndael128.h>
-#include <kripto/block/rijndael256.h>
-#include <kripto/block/safer.h>
-#include <kripto/block/safer_sk.h>
-#include <kripto/block/saferpp.h>
-#include <kripto/block/seed.h>
-#include <kripto/block/serpent.h>
-#include <kripto/block/shacal2.h>
-#include <kripto/block/simon32.h>
-#include <kripto/block/simon64.h>
-#include <kripto/block/simon128.h>
-#include <kripto/block/skipjack.h>
-#include <kripto/block/sm4.h>
-#include <kripto/block/speck32.h>
-#include <kripto/block/speck64.h>
-#include <kripto/block/speck128.h>
-#include <kripto/block/tea.h>
-#include <kripto/block/threefish256.h>
-#include <kripto/block/threefish512.h>
-#include <kripto/block/threefish1024.h>
-#include <kripto/block/trax_m.h>
-#include <kripto/block/trax_l.h>
-#include <kripto/block/twofish.h>
-#include <kripto/block/xtea.h>
-
+#include "ciphers.h"
 #include "perf.h"
 
 #ifndef KEYSTART
@@ -77,70 +43,149 @@
 
 #define MAXKEY 32
 
-static void die(const char *str)
+#ifndef KEYS
+#define KEYS 1
+#endif
+
+#ifndef EVICT
+#define EVICT 0
+#endif
+
+#ifndef AGILE_ITERATIONS
+#define AGILE_ITERATIONS 10000
+#endif
+
+/* blocks after the first one, with the same key */
+#define STEADY 64
+
+static uint8_t *evict_buf;
+
+static void evict(void)
 {
-	perror(str);
-	exit(-1);
+	/* dirty every line, the library could read it so it is not elided */
+	#if EVICT
+	for(size_t i = 0; i < EVICT; i += 64) evict_buf[i]++;
+	#endif
 }
 
-int main(void)
+/* key setup, first block and steady state with KEYS keys in rotation */
+static void agile
+(
+	const char *name,
+	const kripto_desc_block *desc,
+	unsigned int key_len,
+	uint8_t *t
+)
 {
-	struct
+	char op[64];
+	kripto_block **s = (kripto_block **)malloc(KEYS * sizeof(kripto_block *));
+	uint8_t (*k)[MAXKEY] = (uint8_t (*)[MAXKEY])malloc(KEYS * MAXKEY);
+	unsigned int size = kripto_block_size(desc);
+	const char *cold = EVICT ? " cold" : "";
+	perf_int setup = 0;
+	perf_int first = 0;
+	perf_int steady = 0;
+
+	if(!s || !k) perf_die("malloc()");
+
+	for(unsigned int i = 0; i < KEYS; i++)
 	{
-		const char *name;
-		const kripto_desc_block *desc;
-	} ciphers[41] =
+		memset(k[i], 0x5A, MAXKEY);
+		memcpy(k[i], &i, sizeof(i));
+
+		s[i] = kripto_block_create(desc, 0, k[i], key_len);
+		if(!s[i]) perf_die("kripto_block_create()");
+	}
+
+	/* setup */
+	perf_hist_reset();
+	for(unsigned int a = 0; a < AGILE_ITERATIONS; a++)
 	{
-		{"3-Way", kripto_block_3way},
-		{"Anubis", kripto_block_anubis},
-		{"ARIA", kripto_block_aria},
-		{"Blowfish", kripto_block_blowfish},
-		{"Camellia", kripto_block_camellia},
-		{"CAST5", kripto_block_cast5},
-		{"CRAX-S", kripto_block_crax_s},
-		{"DES", kripto_block_des},
-		{"GOST 28147-89", kripto_block_gost_r34_12_2015()},
-		{"IDEA", kripto_block_idea},
-		{"KHAZAD", kripto_block_khazad},
-		{"LEA", kripto_block_lea},
-		{"NOEKEON", kripto_block_noekeon},
-		{"RC2", kripto_block_rc2},
-		{"RC5", kripto_block_rc5},
-		{"RC6", kripto_block_rc6},
-		{"RECTANGLE", kripto_block_rectangle},
-		{"Rijndael-128", kripto_block_rijndael128},
-		{"Rijndael-256", kripto_block_rijndael256},
-		{"SAFER", kripto_block_safer},
-		{"SAFER-SK", kripto_block_safer_sk},
-		{"SAFER++", kripto_block_saferpp},
-		{"SEED", kripto_block_seed},
-		{"Serpent", kripto_block_serpent},
-		{"SHACAL-2", kripto_block_shacal2},
-		{"Simon32", kripto_block_simon32},
-		{"Simon64", kripto_block_simon64},
-		{"Simon128", kripto_block_simon128},
-		{"Skipjack", kripto_block_skipjack},
-		{"SM4", kripto_block_sm4},
-		{"Speck32", kripto_block_speck32},
-		{"Speck64", kripto_block_speck64},
-		{"Speck128", kripto_block_speck128},
-		{"TEA", kripto_block_tea},
-		{"Threefish-256", kripto_block_threefish256},
-		{"Threefish-512", kripto_block_threefish512},
-		{"Threefish-1024", kripto_block_threefish1024},
-		{"TRAX-M", kripto_block_trax_m},
-		{"TRAX-L", kripto_block_trax_l},
-		{"Twofish", kripto_block_twofish},
-		{"XTEA", kripto_block_xtea}
-	};
+		unsigned int j = a % KEYS;
+
+		evict();
+
+		perf_int t0 = perf_clock();
+		s[j] = kripto_block_recreate(s[j], 0, k[j], key_len);
+		perf_int t1 = perf_clock();
+
+		if(!s[j]) perf_die("kripto_block_recreate()");
+
+		/* a sample below the calibration counts as zero */
+		perf_int d = t1 - t0 > perf_c ? t1 - t0 - perf_c : 0;
+
+		setup += d;
+		perf_hist_add(d);
+	}
+
+	printf("%u-bit %u keys%s setup: %lu cycles\n", key_len * 8, KEYS,
+		cold, (unsigned long)(setup / AGILE_ITERATIONS));
+	perf_report(1);
+
+	(void)snprintf(op, sizeof(op), "setup %u keys%s", KEYS, cold);
+	perf_record(name, key_len * 8, op, 0, 1, setup / AGILE_ITERATIONS);
+
+	/* first block on the next key, then more with the same key */
+	perf_hist_reset();
+	for(unsigned int a = 0; a < AGILE_ITERATIONS; a++)
+	{
+		unsigned int j = a % KEYS;
+
+		evict();
+
+		perf_int t0 = perf_clock();
+		kripto_block_encrypt(s[j], t, t);
+		perf_int t1 = perf_clock();
+		for(unsigned int b = 0; b < STEADY; b++)
+			kripto_block_encrypt(s[j], t, t);
+		perf_int t2 = perf_clock();
+
+		perf_int d = t1 - t0 > perf_c ? t1 - t0 - perf_c : 0;
+
+		first += d;
+		steady += t2 - t1 > perf_c ? t2 - t1 - perf_c : 0;
+		perf_hist_add(d);
+	}
+
+	printf("%u-bit %u keys%s first block: %lu cycles\n", key_len * 8, KEYS,
+		cold, (unsigned long)(first / AGILE_ITERATIONS));
+	perf_report(1);
+
+	(void)snprintf(op, sizeof(op), "first block %u keys%s", KEYS, cold);
+	perf_record(name, key_len * 8, op, size, 1, first / AGILE_ITERATIONS);
+
+	printf("%u-bit %u keys%s steady: %.1f cpb\n", key_len * 8, KEYS,
+		cold, steady / ((double)AGILE_ITERATIONS * STEADY * size));
+
+	/* a mean only, no percentiles */
+	perf_hist_reset();
+	(void)snprintf(op, sizeof(op), "steady %u keys%s", KEYS, cold);
+	perf_record(name, key_len * 8, op, size, STEADY, steady / AGILE_ITERATIONS);
+
+	for(unsigned int i = 0; i < KEYS; i++)
+		kripto_block_destroy(s[i]);
+
+	free(k);
+	free(s);
+}
+
+int main(void)
+{
+	const struct perf_cipher ciphers[PERF_CIPHERS] = {PERF_CIPHER_LIST};
 	perf_int cycles;
 
+	if(EVICT)
+	{
+		evict_buf = (uint8_t *)calloc(EVICT, 1);
+		if(!evict_buf) perf_die("calloc()");
+	}
+
 	perf_init();
 
 	uint8_t k[MAXKEY];
 	memset(k, 0x5A, MAXKEY);
 
-	for(unsigned int i = 0; i < 41; i++)
+	for(unsigned int i = 0; i < PERF_CIPHERS; i++)
 	{
 		puts(ciphers[i].name);
 
@@ -157,15 +202,17 @@ int main(void)
 		for(unsigned int n = minkey; n <= maxkey; n += KEYSTEP)
 		{
 			kripto_block *s = kripto_block_create(ciphers[i].desc, 0, k, n);
-			if(!s) die("kripto_block_create()");
+			if(!s) perf_die("kripto_block_create()");
 
 			/* setup */
 			PERF_START
 			s = kripto_block_recreate(s, 0, k, n);
-			if(!s) die("kripto_block_recreate()");
+			if(!s) perf_die("kripto_block_recreate()");
 			PERF_STOP
 
 			printf("%u-bit setup: %lu cycles\n", n * 8, cycles);
+			perf_report(1);
+			perf_record(ciphers[i].name, n * 8, "setup", 0, 1, cycles);
 
 			/* encrypt */
 			PERF_START
@@ -174,6 +221,8 @@ int main(void)
 
 			printf("%u-bit encrypt: %.1f cpb\n",
 				n * 8, cycles / (float)size);
+			perf_report(size);
+			perf_record(ciphers[i].name, n * 8, "encrypt", size, 1, cycles);
 
 			/* decrypt */
 			PERF_START
@@ -182,9 +231,13 @@ int main(void)
 
 			printf("%u-bit decrypt: %.1f cpb\n",
 				n * 8, cycles / (float)size);
+			perf_report(size);
+			perf_record(ciphers[i].name, n * 8, "decrypt", size, 1, cycles);
 
 			kripto_block_destroy(s);
 
+			if(KEYS > 1 || EVICT) agile(ciphers[i].name, ciphers[i].desc, n, t);
+
 			perf_rest();
 			fflush(stdout);
 			putchar('\n');
@@ -0,0 +1,381 @@
+/*
+ * Copyright (C) 2026 by Gregor Pintar <grpintar@gmail.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/* cc -Wall -Wextra -std=c99 -pedantic perf/compare.c -o compare -lm */
+
+/*
+ * compare old new [percent]
+ *
+ * Reads two files of PERF_CSV or PERF_JSON records and compares the median
+ * (p50) of each algorithm, key size, operation, size and backend. Records
+ * of the same kind in one file are runs, appended by running a benchmark
+ * more than once. With at least MIN_RUNS runs on both sides the change
+ * must pass a one-sided Welch t-test at 1%. With fewer runs the variance
+ * estimate is too unreliable, the new median must be above the old p90,
+ * slower than the old run's own spread. Either way it must also be more
+ * than percent (default 5) slower. Records found in only one file are
+ * listed as new or missing. Exits with 1 if anything regressed, if old
+ * records are missing from new or if nothing could be compared.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define FIELD 128
+
+/* runs per side for the t-test */
+#define MIN_RUNS 5
+
+struct record
+{
+	char alg[FIELD];
+	char op[FIELD];
+	char backend[FIELD];
+	unsigned long key_bits;
+	unsigned long size;
+	double p50;
+	double p90;
+};
+
+struct set
+{
+	struct record *r;
+	size_t n;
+	size_t max;
+};
+
+static void die(const char *str)
+{
+	perror(str);
+	exit(2);
+}
+
+/* value of "key": in a flat JSON object */
+static const char *json(const char *line, const char *key)
+{
+	char k[FIELD];
+	const char *p;
+
+	(void)snprintf(k, sizeof(k), "\"%s\":", key);
+
+	p = strstr(line, k);
+	if(!p) return 0;
+
+	return p + strlen(k);
+}
+
+static int json_str(const char *line, const char *key, char *out)
+{
+	const char *p = json(line, key);
+	size_t i = 0;
+
+	if(!p || *p++ != '"') return -1;
+
+	while(*p && *p != '"' && i < FIELD - 1) out[i++] = *p++;
+	out[i] = 0;
+
+	return 0;
+}
+
+static int json_num(const char *line, const char *key, double *out)
+{
+	const char *p = json(line, key);
+	char *end;
+
+	if(!p) return -1;
+
+	*out = strtod(p, &end);
+
+	return end == p ? -1 : 0;
+}
+
+/* next CSV field, quotes are stripped */
+static const char *csv(const char *p, char *out)
+{
+	size_t i = 0;
+
+	if(*p == '"')
+	{
+		p++;
+		while(*p && *p != '"')
+		{
+			if(i < FIELD - 1) out[i++] = *p;
+			p++;
+		}
+		if(*p == '"') p++;
+	}
+	else
+	{
+		while(*p && *p != ',' && *p != '\n' && *p != '\r')
+		{
+			if(i < FIELD - 1) out[i++] = *p;
+			p++;
+		}
+	}
+	out[i] = 0;
+
+	return *p == ',' ? p + 1 : 0;
+}
+
+static int parse(const char *line, struct record *r)
+{
+	char f[13][FIELD];
+	double v;
+	unsigned int i;
+
+	if(*line == '{')
+	{
+		if(json_str(line, "algorithm", r->alg)) return -1;
+		if(json_str(line, "operation", r->op)) return -1;
+		if(json_str(line, "backend", r->backend)) return -1;
+
+		if(json_num(line, "key_bits", &v)) return -1;
+		r->key_bits = (unsigned long)v;
+
+		if(json_num(line, "size", &v)) return -1;
+		r->size = (unsigned long)v;
+
+		if(json_num(line, "p50", &r->p50)) return -1;
+		if(json_num(line, "p90", &r->p90)) return -1;
+
+		return 0;
+	}
+
+	/* algorithm,key_bits,operation,size,backend,samples,cycles,cpb,gbps,p50,p90,p99,max */
+	for(i = 0; i < 13; i++)
+	{
+		if(!line) return -1;
+		line = csv(line, f[i]);
+	}
+
+	if(!strcmp(f[0], "algorithm")) return -1; /* header */
+
+	strcpy(r->alg, f[0]);
+	strcpy(r->op, f[2]);
+	strcpy(r->backend, f[4]);
+	r->key_bits = strtoul(f[1], 0, 10);
+	r->size = strtoul(f[3], 0, 10);
+	r->p50 = strtod(f[9], 0);
+	r->p90 = strtod(f[10], 0);
+
+	return 0;
+}
+
+static void load(const char *path, struct set *s)
+{
+	char line[1024];
+	FILE *fp;
+
+	fp = fopen(path, "r");
+	if(!fp) die(path);
+
+	while(fgets(line, sizeof(line), fp))
+	{
+		if(s->n == s->max)
+		{
+			s->max = s->max ? s->max << 1 : 256;
+			s->r = (struct record *)realloc(s->r, s->max * sizeof(struct record));
+			if(!s->r) die("realloc()");
+		}
+
+		if(!parse(line, s->r + s->n)) s->n++;
+	}
+
+	fclose(fp);
+}
+
+static int same(const struct record *a, const struct record *b)
+{
+	return a->key_bits == b->key_bits
+		&& a->size == b->size
+		&& !strcmp(a->alg, b->alg)
+		&& !strcmp(a->op, b->op)
+		&& !strcmp(a->backend, b->backend);
+}
+
+struct runs
+{
+	size_t n;
+	double mean;
+	double var;
+	double p50;
+	double p90;
+};
+
+/* first record of its kind in s */
+static int first(const struct set *s, size_t i)
+{
+	size_t j;
+
+	for(j = 0; j < i; j++)
+		if(same(s->r + j, s->r + i)) return 0;
+
+	return 1;
+}
+
+/* mean and variance of p50 over the runs of r in s */
+static struct runs runs(const struct set *s, const struct record *r)
+{
+	struct runs x = {0, 0, 0, 0, 0};
+	double d;
+	size_t i;
+
+	for(i = 0; i < s->n; i++)
+	{
+		if(!same(s->r + i, r)) continue;
+
+		x.n++;
+		d = s->r[i].p50 - x.mean;
+		x.mean += d / x.n;
+		x.var += d * (s->r[i].p50 - x.mean);
+
+		x.p50 = s->r[i].p50;
+		x.p90 = s->r[i].p90;
+	}
+
+	if(x.n > 1) x.var /= x.n - 1;
+
+	return x;
+}
+
+/* one-sided Student t at 1%, for the next smaller tabulated df */
+static double t99(double df)
+{
+	const double d[15] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 12, 15, 20, 30, 60};
+	const double t[15] =
+	{
+		31.821, 6.965, 4.541, 3.747, 3.365, 3.143, 2.998, 2.896,
+		2.821, 2.764, 2.681, 2.602, 2.528, 2.457, 2.390
+	};
+	unsigned int i = 14;
+
+	while(i && df < d[i]) i--;
+
+	return t[i];
+}
+
+int main(int argc, char *argv[])
+{
+	struct set a = {0, 0, 0};
+	struct set b = {0, 0, 0};
+	double limit = 5;
+	unsigned int compared = 0;
+	unsigned int regressed = 0;
+	unsigned int improved = 0;
+	unsigned int added = 0;
+	unsigned int missing = 0;
+	size_t i;
+
+	if(argc < 3 || argc > 4)
+	{
+		fprintf(stderr, "usage: %s old new [percent]\n", argv[0]);
+		return 2;
+	}
+
+	if(argc == 4) limit = strtod(argv[3], 0);
+
+	load(argv[1], &a);
+	load(argv[2], &b);
+
+	for(i = 0; i < b.n; i++)
+	{
+		const struct record *r = b.r + i;
+		struct runs x;
+		struct runs y;
+		double change;
+		int slower;
+		int faster;
+
+		if(!first(&b, i)) continue;
+
+		x = runs(&a, r);
+		if(!x.n)
+		{
+			added++;
+			printf("new %s %lu-bit %s %lu B [%s]\n",
+				r->alg, r->key_bits, r->op, r->size, r->backend);
+			continue;
+		}
+		if(!x.mean) continue;
+
+		y = runs(&b, r);
+		change = (y.mean - x.mean) * 100 / x.mean;
+
+		if(x.n >= MIN_RUNS && y.n >= MIN_RUNS)
+		{
+			double sx = x.var / x.n;
+			double sy = y.var / y.n;
+			double se = sqrt(sx + sy);
+			double df;
+
+			if(se)
+			{
+				df = (sx + sy) * (sx + sy)
+					/ (sx * sx / (x.n - 1) + sy * sy / (y.n - 1));
+				slower = (y.mean - x.mean) / se > t99(df);
+				faster = (x.mean - y.mean) / se > t99(df);
+			}
+			else
+			{
+				slower = y.mean > x.mean;
+				faster = y.mean < x.mean;
+			}
+		}
+		else
+		{
+			/* few runs, the shift has to clear the last run's spread */
+			slower = y.p50 > x.p90;
+			faster = x.p50 > y.p90;
+		}
+
+		compared++;
+
+		if(slower && change > limit)
+		{
+			regressed++;
+			printf("REGRESSION %s %lu-bit %s %lu B [%s]: %.2f -> %.2f (%+.1f%%)\n",
+				r->alg, r->key_bits, r->op, r->size, r->backend,
+				x.mean, y.mean, change);
+		}
+		else if(faster && -change > limit)
+		{
+			improved++;
+			printf("improved %s %lu-bit %s %lu B [%s]: %.2f -> %.2f (%+.1f%%)\n",
+				r->alg, r->key_bits, r->op, r->size, r->backend,
+				x.mean, y.mean, change);
+		}
+	}
+
+	for(i = 0; i < a.n; i++)
+	{
+		const struct record *r = a.r + i;
+
+		if(!first(&a, i) || runs(&b, r).n) continue;
+
+		missing++;
+		printf("MISSING %s %lu-bit %s %lu B [%s]\n",
+			r->alg, r->key_bits, r->op, r->size, r->backend);
+	}
+
+	printf("%u compared, %u regressed, %u improved, %u new, %u missing\n",
+		compared, regressed, improved, added, missing);
+
+	free(a.r);
+	free(b.r);
+
+	return regressed || missing || !compared ? 1 : 0;
+}
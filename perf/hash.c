@@ -97,6 +97,8 @@ int main(void)
 		PERF_STOP
 
 		printf("%s: %.1f cpb\n", hashes[i].name, cycles / (float)INPUT_LEN);
+		perf_report(INPUT_LEN);
+		perf_record(hashes[i].name, 0, "hash", INPUT_LEN, 1, cycles);
 
 		kripto_hash_destroy(s);
 
@@ -0,0 +1,251 @@
+/*
+ * Copyright (C) 2026 by Gregor Pintar <grpintar@gmail.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/* cc -Wall -Wextra -std=c99 -pedantic perf/mac.c -Iinclude lib/libkripto.a -O2 -DPERF_UNIX -D_GNU_SOURCE */
+/* cc -Wall -Wextra -std=c99 -pedantic perf/mac.c -Iinclude lib/libkripto.a -O2 -DPERF_WINDOWS /lib/w32api/libpowrprof.a */
+
+/* optional argument: only MACs whose name contains it, e.g. "HMAC SHA2" */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include <kripto/block.h>
+#include <kripto/hash.h>
+#include <kripto/mac.h>
+
+#include <kripto/hash/blake256.h>
+#include <kripto/hash/blake512.h>
+#include <kripto/hash/blake2s.h>
+#include <kripto/hash/blake2b.h>
+#include <kripto/hash/keccak800.h>
+#include <kripto/hash/keccak1600.h>
+#include <kripto/hash/md5.h>
+#include <kripto/hash/sha1.h>
+#include <kripto/hash/sha2_256.h>
+#include <kripto/hash/sha2_512.h>
+#include <kripto/hash/sha3.h>
+#include <kripto/hash/skein256.h>
+#include <kripto/hash/skein512.h>
+#include <kripto/hash/skein1024.h>
+#include <kripto/hash/tiger.h>
+#include <kripto/hash/whirlpool.h>
+
+#include <kripto/mac/hmac.h>
+#include <kripto/mac/keccak1600.h>
+#include <kripto/mac/keccak800.h>
+#include <kripto/mac/omac.h>
+#include <kripto/mac/skein256.h>
+#include <kripto/mac/skein512.h>
+#include <kripto/mac/skein1024.h>
+#include <kripto/mac/xcbc.h>
+
+#include "ciphers.h"
+#include "message.h"
+
+#define BULK (1 << 20)
+
+#define MAXKEY 32
+/* sponge MACs get slower with longer tags, maxtag is not typical */
+#define MAXTAG 32
+
+static const size_t message[4] = {64, 576, 1500, 16384};
+
+static void mac
+(
+	const char *name,
+	const kripto_desc_mac *desc,
+	uint8_t *buf
+)
+{
+	perf_int cycles;
+	uint8_t k[MAXKEY];
+	uint8_t tag[MAXTAG];
+
+	unsigned int key_len = kripto_mac_maxkey(desc);
+	if(key_len > MAXKEY) key_len = MAXKEY;
+
+	unsigned int tag_len = kripto_mac_maxtag(desc);
+	if(tag_len > MAXTAG) tag_len = MAXTAG;
+
+	memset(k, 0x5A, key_len);
+
+	kripto_mac *s = kripto_mac_create(desc, 0, k, key_len, tag_len);
+	if(!s)
+	{
+		printf("%s: not supported\n\n", name);
+		return;
+	}
+
+	puts(name);
+
+	/* setup */
+	perf_n = SETUP_ITERATIONS;
+	PERF_START
+	for(unsigned int r = 0; r < SETUP_BATCH; r++)
+	{
+		s = kripto_mac_recreate(s, 0, k, key_len, tag_len);
+		if(!s) perf_die("kripto_mac_recreate()");
+	}
+	PERF_STOP
+
+	printf("%u-bit setup: %lu cycles\n", key_len * 8,
+		(unsigned long)(cycles / SETUP_BATCH));
+	perf_report(SETUP_BATCH);
+	perf_record(name, key_len * 8, "setup", 0, SETUP_BATCH, cycles);
+
+	/* whole message, with setup */
+	for(unsigned int i = 0; i < 4; i++)
+	{
+		size_t batch = perf_batch(message[i], SETUP_BATCH);
+
+		PERF_START
+		for(size_t r = 0; r < batch; r++)
+		{
+			s = kripto_mac_recreate(s, 0, k, key_len, tag_len);
+			if(!s) perf_die("kripto_mac_recreate()");
+			kripto_mac_input(s, buf, message[i]);
+			kripto_mac_tag(s, tag, tag_len);
+		}
+		PERF_STOP
+
+		printf("%5lu B message: %lu cycles, %.2f cpb\n",
+			(unsigned long)message[i],
+			(unsigned long)(cycles / batch),
+			cycles / ((double)message[i] * batch));
+		perf_report(batch);
+		perf_record(name, key_len * 8, "message", message[i], batch, cycles);
+	}
+
+	/* bulk input, without setup and tag */
+	s = kripto_mac_recreate(s, 0, k, key_len, tag_len);
+	if(!s) perf_die("kripto_mac_recreate()");
+
+	perf_n = BYTES / BULK;
+	PERF_START
+	kripto_mac_input(s, buf, BULK);
+	PERF_STOP
+
+	printf("bulk: %.2f cpb", cycles / (double)BULK);
+	if(perf_hz) printf(", %.3f GB/s", BULK * perf_hz / cycles / 1e9);
+	putchar('\n');
+	perf_report(BULK);
+	perf_record(name, key_len * 8, "input", BULK, 1, cycles);
+
+	kripto_mac_destroy(s);
+
+	perf_rest();
+	fflush(stdout);
+	putchar('\n');
+}
+
+int main(int argc, char *argv[])
+{
+	const struct perf_cipher ciphers[PERF_CIPHERS] = {PERF_CIPHER_LIST};
+	struct
+	{
+		const char *name;
+		const kripto_desc_hash *desc;
+	} hashes[16] =
+	{
+		{"BLAKE-256", kripto_hash_blake256},
+		{"BLAKE-512", kripto_hash_blake512},
+		{"BLAKE2s", kripto_hash_blake2s},
+		{"BLAKE2b", kripto_hash_blake2b},
+		{"Keccak800", kripto_hash_keccak800},
+		{"Keccak1600", kripto_hash_keccak1600},
+		{"MD5", kripto_hash_md5},
+		{"SHA1", kripto_hash_sha1},
+		{"SHA2-256", kripto_hash_sha2_256},
+		{"SHA2-512", kripto_hash_sha2_512},
+		{"SHA3", kripto_hash_sha3},
+		{"Skein256", kripto_hash_skein256},
+		{"Skein512", kripto_hash_skein512},
+		{"Skein1024", kripto_hash_skein1024},
+		{"Tiger", kripto_hash_tiger},
+		{"WHIRLPOOL", kripto_hash_whirlpool}
+	};
+	struct
+	{
+		const char *name;
+		kripto_desc_mac *(*mode)(const kripto_desc_block *);
+	} modes[2] =
+	{
+		{"OMAC", kripto_mac_omac},
+		{"XCBC", kripto_mac_xcbc}
+	};
+	struct
+	{
+		const char *name;
+		const kripto_desc_mac *desc;
+	} macs[5] =
+	{
+		{"Keccak-1600", kripto_mac_keccak1600},
+		{"Keccak-800", kripto_mac_keccak800},
+		{"Skein-256", kripto_mac_skein256},
+		{"Skein-512", kripto_mac_skein512},
+		{"Skein-1024", kripto_mac_skein1024}
+	};
+	const char *filter = argc > 1 ? argv[1] : "";
+	char name[64];
+
+	uint8_t *buf = (uint8_t *)malloc(BULK);
+	if(!buf) perf_die("malloc()");
+	memset(buf, 0, BULK);
+
+	perf_init();
+
+	for(unsigned int i = 0; i < 5; i++)
+	{
+		if(!strstr(macs[i].name, filter)) continue;
+
+		mac(macs[i].name, macs[i].desc, buf);
+	}
+
+	for(unsigned int i = 0; i < 16; i++)
+	{
+		(void)snprintf(name, sizeof(name), "HMAC %s", hashes[i].name);
+		if(!strstr(name, filter)) continue;
+
+		kripto_desc_mac *desc = kripto_mac_hmac(hashes[i].desc);
+		if(!desc) perf_die("kripto_mac_hmac()");
+
+		mac(name, desc, buf);
+
+		free(desc);
+	}
+
+	for(unsigned int m = 0; m < 2; m++)
+	{
+		for(unsigned int i = 0; i < PERF_CIPHERS; i++)
+		{
+			(void)snprintf(name, sizeof(name), "%s %s",
+				modes[m].name, ciphers[i].name);
+			if(!strstr(name, filter)) continue;
+
+			kripto_desc_mac *desc = modes[m].mode(ciphers[i].desc);
+			if(!desc) perf_die("mode");
+
+			mac(name, desc, buf);
+
+			free(desc);
+		}
+	}
+
+	free(buf);
+
+	return 0;
+}
@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2026 by Gregor Pintar <grpintar@gmail.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/*
+ * Sizing shared by the message size benchmarks. Iterations depend on
+ * the message size, so PERF_ITERATIONS is perf_n, set per measurement.
+ */
+
+static unsigned int perf_n = 1000;
+#define PERF_ITERATIONS perf_n
+
+#include "perf.h"
+
+/* bytes processed per size, in samples of at least BATCH bytes */
+#ifndef BYTES
+#define BYTES (1 << 24)
+#endif
+
+#define BATCH (1 << 16)
+
+/* small messages and setups are timed in batches, cpuid is not free */
+#ifndef SETUP_ITERATIONS
+#define SETUP_ITERATIONS 1000
+#endif
+
+#define SETUP_BATCH 16
+
+/* messages of len bytes per sample, at least min, and perf_n to match */
+static PERF_UNUSED size_t perf_batch(size_t len, size_t min)
+{
+	size_t batch = len < BATCH / min ? BATCH / len : min;
+
+	perf_n = BYTES / (len * batch);
+
+	return batch;
+}
@@ -13,11 +13,25 @@
  * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
  */
 
+/*
+ * Without PERF_AVG every iteration also goes into a histogram, perf_report()
+ * prints its percentiles. With PERF_EVENTS on Linux, cycles, instructions,
+ * L1D misses and branch misses are counted around each iteration too.
+ * PERF_CSV=file or PERF_JSON=file in the environment appends one record
+ * per perf_record() to that file, perf/compare.c compares two of them.
+ */
+
 #ifndef PERF_ITERATIONS
 #define PERF_ITERATIONS 1000000
 #endif
 
+#include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <kripto/cpu.h>
 
 #if defined(PERF_UNIX)
 
@@ -33,10 +47,34 @@
 
 #endif
 
+#if defined(PERF_EVENTS) && defined(__linux__)
+
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+#else
+#undef PERF_EVENTS
+#endif
+
+/* not every program uses every helper */
+#if defined(__GNUC__) || defined(__clang__)
+#define PERF_UNUSED __attribute__((unused))
+#else
+#define PERF_UNUSED
+#endif
+
 #if (defined(__GNUC__) || defined(__clang__)) && (defined(__i386__) || defined(__x86_64__))
 #define PERF_RDTSC
 #endif
 
+static PERF_UNUSED void perf_die(const char *str)
+{
+	perror(str);
+	exit(-1);
+}
+
 #if defined(PERF_WINDOWS) || defined(PERF_RDTSC)
 
 #include <stdint.h>
@@ -46,8 +84,6 @@ typedef uint64_t perf_int;
 
 #else
 
-#include <time.h>
-
 typedef clock_t perf_int;
 #define PERF_INT_MAX (clock_t)UINT64_MAX
 
@@ -86,7 +122,8 @@ static inline perf_int perf_clock(void)
 	if(clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &x))
 		perror("clock_gettime()");
 
-	return (((uint64_t)x.tv_sec) << 32) | x.tv_nsec;
+	/* nanoseconds, so that differences are linear */
+	return (uint64_t)x.tv_sec * 1000000000 + x.tv_nsec;
 
 	#else
 
@@ -95,10 +132,164 @@ static inline perf_int perf_clock(void)
 	#endif
 }
 
+/* log-linear buckets, 32 per power of two, within 3% */
+#define PERF_HIST_SUB 5
+#define PERF_HIST_LEN ((64 - PERF_HIST_SUB + 1) << PERF_HIST_SUB)
+
+static uint64_t perf_hist[PERF_HIST_LEN];
+static uint64_t perf_hist_n;
+static uint64_t perf_hist_max;
+
+static PERF_UNUSED void perf_hist_reset(void)
+{
+	memset(perf_hist, 0, sizeof(perf_hist));
+	perf_hist_n = 0;
+	perf_hist_max = 0;
+}
+
+static PERF_UNUSED void perf_hist_add(uint64_t x)
+{
+	unsigned int e = 0;
+
+	/* top PERF_HIST_SUB + 1 bits, the highest one is implied by e */
+	while(x >> e >> (PERF_HIST_SUB + 1)) e++;
+
+	perf_hist[(e << PERF_HIST_SUB) + (x >> e)]++;
+
+	perf_hist_n++;
+	if(perf_hist_max < x) perf_hist_max = x;
+}
+
+/* lower bound of the bucket holding the p-th fraction of samples */
+static PERF_UNUSED uint64_t perf_hist_pct(double p)
+{
+	uint64_t n = 0;
+	unsigned int i;
+	unsigned int e;
+
+	for(i = 0; i < PERF_HIST_LEN - 1; i++)
+	{
+		n += perf_hist[i];
+		if(n > p * perf_hist_n) break;
+	}
+
+	if(i < (2 << PERF_HIST_SUB)) return i;
+
+	e = (i >> PERF_HIST_SUB) - 1;
+	return (uint64_t)(i - (e << PERF_HIST_SUB)) << e;
+}
+
+#if defined(PERF_EVENTS)
+
+#define PERF_EVENTS_N 4
+
+static const char *const perf_events_name[PERF_EVENTS_N] =
+{
+	"cycles", "instructions", "L1D misses", "branch misses"
+};
+
+static int perf_events_fd[PERF_EVENTS_N] = {-1, -1, -1, -1};
+static double perf_events[PERF_EVENTS_N]; /* per iteration */
+static double perf_events_c[PERF_EVENTS_N]; /* empty iteration */
+
+static void perf_events_open(void)
+{
+	struct perf_event_attr a;
+	const uint32_t type[PERF_EVENTS_N] =
+	{
+		PERF_TYPE_HARDWARE,
+		PERF_TYPE_HARDWARE,
+		PERF_TYPE_HW_CACHE,
+		PERF_TYPE_HARDWARE
+	};
+	const uint64_t config[PERF_EVENTS_N] =
+	{
+		PERF_COUNT_HW_CPU_CYCLES,
+		PERF_COUNT_HW_INSTRUCTIONS,
+		PERF_COUNT_HW_CACHE_L1D
+			| (PERF_COUNT_HW_CACHE_OP_READ << 8)
+			| (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+		PERF_COUNT_HW_BRANCH_MISSES
+	};
+	unsigned int i;
+
+	for(i = 0; i < PERF_EVENTS_N; i++)
+	{
+		memset(&a, 0, sizeof(a));
+		a.size = sizeof(a);
+		a.type = type[i];
+		a.config = config[i];
+		a.disabled = !i;
+		a.exclude_kernel = 1;
+		a.exclude_hv = 1;
+		a.read_format = PERF_FORMAT_GROUP;
+
+		perf_events_fd[i] = syscall(SYS_perf_event_open, &a, 0, -1,
+			i ? perf_events_fd[0] : -1, 0);
+		if(perf_events_fd[i] < 0) break;
+	}
+
+	if(i == PERF_EVENTS_N) return;
+
+	perror("perf_event_open()");
+	while(i--)
+	{
+		(void)close(perf_events_fd[i]);
+		perf_events_fd[i] = -1;
+	}
+}
+
+#define PERF_EVENTS_RESET						\
+	if(perf_events_fd[0] >= 0)					\
+		(void)ioctl(perf_events_fd[0], PERF_EVENT_IOC_RESET,	\
+			PERF_IOC_FLAG_GROUP);
+
+#define PERF_EVENTS_ENABLE						\
+	if(perf_events_fd[0] >= 0)					\
+		(void)ioctl(perf_events_fd[0], PERF_EVENT_IOC_ENABLE,	\
+			PERF_IOC_FLAG_GROUP);
+
+#define PERF_EVENTS_DISABLE						\
+	if(perf_events_fd[0] >= 0)					\
+		(void)ioctl(perf_events_fd[0], PERF_EVENT_IOC_DISABLE,	\
+			PERF_IOC_FLAG_GROUP);
+
+/* totals since reset, over n iterations, less the empty iteration */
+static void perf_events_read(unsigned int n)
+{
+	uint64_t v[1 + PERF_EVENTS_N];
+	unsigned int i;
+
+	if(perf_events_fd[0] < 0) return;
+
+	if(read(perf_events_fd[0], v, sizeof(v)) != (ssize_t)sizeof(v))
+	{
+		perror("read()");
+		return;
+	}
+
+	for(i = 0; i < PERF_EVENTS_N; i++)
+	{
+		perf_events[i] = (double)v[1 + i] / n - perf_events_c[i];
+		if(perf_events[i] < 0) perf_events[i] = 0;
+	}
+}
+
+#else
+
+#define PERF_EVENTS_RESET
+#define PERF_EVENTS_ENABLE
+#define PERF_EVENTS_DISABLE
+#define perf_events_read(N) (void)(N)
+
+#endif
+
 #if defined(PERF_AVG)
 
 #define PERF_START							\
 {									\
+	PERF_EVENTS_RESET						\
+	PERF_EVENTS_ENABLE						\
 	cycles = perf_clock();						\
 	for(unsigned int perf_i = 0; perf_i < PERF_ITERATIONS; perf_i++)\
 	{
@@ -106,6 +297,8 @@ static inline perf_int perf_clock(void)
 #define PERF_STOP						\
 	}							\
 	cycles = (perf_clock() - cycles) / PERF_ITERATIONS;	\
+	PERF_EVENTS_DISABLE					\
+	perf_events_read(PERF_ITERATIONS);			\
 }
 
 #else
@@ -115,21 +308,146 @@ static inline perf_int perf_clock(void)
 	perf_int t0;							\
 	perf_int t1;							\
 	cycles = PERF_INT_MAX;						\
+	perf_hist_reset();						\
+	PERF_EVENTS_RESET						\
 	for(unsigned int perf_i = 0; perf_i < PERF_ITERATIONS; perf_i++)\
 	{								\
+		PERF_EVENTS_ENABLE					\
 		t0 = perf_clock();
 
 #define PERF_STOP					\
-		t1 = perf_clock() - t0 - perf_c;	\
+		t1 = perf_clock() - t0;			\
+		PERF_EVENTS_DISABLE			\
+		t1 = t1 > perf_c ? t1 - perf_c : 0;	\
+		perf_hist_add(t1);			\
 		if(cycles > t1) cycles = t1;		\
-	}										\
+	}						\
+	perf_events_read(PERF_ITERATIONS);		\
 }
 
 #endif
 
-perf_int perf_c;
+static perf_int perf_c;
+
+/* perf_clock() ticks per second, 0 if unknown */
+static double perf_hz;
 
-static void perf_init(void)
+static void perf_freq(void)
+{
+	/* same order as perf_clock() */
+	#if defined(PERF_WINDOWS) && defined(PERF_QPC)
+
+	LARGE_INTEGER f;
+
+	if(QueryPerformanceFrequency(&f)) perf_hz = (double)f.QuadPart;
+
+	#elif defined(PERF_RDTSC) && defined(PERF_WINDOWS)
+
+	LARGE_INTEGER f;
+	LARGE_INTEGER t0;
+	LARGE_INTEGER t1;
+	perf_int c0;
+
+	/* 100 ms against the performance counter */
+	if(!QueryPerformanceFrequency(&f)) return;
+	(void)QueryPerformanceCounter(&t0);
+	c0 = perf_clock();
+	do (void)QueryPerformanceCounter(&t1);
+	while(t1.QuadPart - t0.QuadPart < f.QuadPart / 10);
+
+	perf_hz = (perf_clock() - c0) * (double)f.QuadPart
+		/ (t1.QuadPart - t0.QuadPart);
+
+	#elif defined(PERF_RDTSC) && defined(PERF_UNIX)
+
+	struct timespec t0;
+	struct timespec t1;
+	perf_int c0;
+	double t;
+
+	/* 100 ms against the monotonic clock */
+	if(clock_gettime(CLOCK_MONOTONIC, &t0)) return;
+	c0 = perf_clock();
+	do
+	{
+		(void)clock_gettime(CLOCK_MONOTONIC, &t1);
+		t = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) * 1e-9;
+	} while(t < 0.1);
+
+	perf_hz = (perf_clock() - c0) / t;
+
+	#elif defined(PERF_RDTSC)
+
+	clock_t t0;
+	clock_t t1;
+	perf_int c0;
+
+	/* 100 ms of processor time, the process is busy anyway */
+	t0 = clock();
+	if(t0 == (clock_t)-1) return;
+	c0 = perf_clock();
+	do t1 = clock();
+	while(t1 - t0 < CLOCKS_PER_SEC / 10);
+
+	perf_hz = (perf_clock() - c0) * (double)CLOCKS_PER_SEC / (t1 - t0);
+
+	#elif defined(_POSIX_CPUTIME)
+
+	perf_hz = 1e9;
+
+	#else
+
+	perf_hz = CLOCKS_PER_SEC;
+
+	#endif
+}
+
+static FILE *perf_out;
+static int perf_json;
+static char perf_backend[64];
+
+static void perf_out_open(void)
+{
+	const char *name[10] =
+	{
+		"sse2", "ssse3", "sse4.1", "avx2", "avx512",
+		"aesni", "pclmul", "shani", "gfni", "vaes"
+	};
+	const char *path;
+	unsigned int cpu = kripto_cpu();
+	unsigned int i;
+
+	/* enabled cpu features, the library picks code paths by them */
+	strcpy(perf_backend, "generic");
+	for(i = 0; i < 10; i++)
+	{
+		if(!(cpu & (1u << i))) continue;
+
+		if(!strcmp(perf_backend, "generic")) *perf_backend = 0;
+		else strcat(perf_backend, "+");
+		strcat(perf_backend, name[i]);
+	}
+
+	path = getenv("PERF_JSON");
+	perf_json = path != 0;
+	if(!path) path = getenv("PERF_CSV");
+	if(!path) return;
+
+	perf_out = fopen(path, "a");
+	if(!perf_out)
+	{
+		perror(path);
+		return;
+	}
+
+	if(!perf_json && !ftell(perf_out))
+	{
+		fputs("algorithm,key_bits,operation,size,backend,samples,"
+			"cycles,cpb,gbps,p50,p90,p99,max\n", perf_out);
+	}
+}
+
+static PERF_UNUSED void perf_init(void)
 {
 	perf_int cycles;
 
@@ -184,14 +502,101 @@ static void perf_init(void)
 
 	#endif
 
+	#if defined(PERF_EVENTS)
+	perf_events_open();
+	#endif
+
 	/* calibrate */
 	perf_c = 0;
 	PERF_START
 	PERF_STOP
 	perf_c = cycles;
+
+	#if defined(PERF_EVENTS)
+	memcpy(perf_events_c, perf_events, sizeof(perf_events));
+	#endif
+
+	perf_freq();
+
+	perf_out_open();
+}
+
+/* percentiles of the last measurement, samples divided by div */
+static PERF_UNUSED void perf_report(double div)
+{
+	#if !defined(PERF_AVG)
+	printf("\tp50 %.2f, p90 %.2f, p99 %.2f, max %.2f\n",
+		perf_hist_pct(0.5) / div, perf_hist_pct(0.9) / div,
+		perf_hist_pct(0.99) / div, perf_hist_max / div);
+	#endif
+
+	#if defined(PERF_EVENTS)
+	if(perf_events_fd[0] >= 0)
+	{
+		unsigned int i;
+
+		putchar('\t');
+		for(i = 0; i < PERF_EVENTS_N; i++)
+		{
+			printf("%s%.2f %s", i ? ", " : "",
+				perf_events[i] / div, perf_events_name[i]);
+		}
+		if(perf_events[0])
+			printf(", %.2f IPC", perf_events[1] / perf_events[0]);
+		putchar('\n');
+	}
+	#else
+	(void)div;
+	#endif
+}
+
+/*
+ * Last measurement as a record: ops operations of size bytes per sample,
+ * cycles (usually the minimum) and percentiles per operation.
+ */
+static PERF_UNUSED void perf_record
+(
+	const char *alg,
+	unsigned int key_bits,
+	const char *op,
+	size_t size,
+	double ops,
+	perf_int cycles
+)
+{
+	double c = cycles / ops;
+	double cpb = size ? c / size : 0;
+	double gbps = size && c && perf_hz ? size * perf_hz / c / 1e9 : 0;
+	double pct[4];
+	const char *f;
+
+	if(!perf_out) return;
+
+	if(perf_hist_n)
+	{
+		pct[0] = perf_hist_pct(0.5) / ops;
+		pct[1] = perf_hist_pct(0.9) / ops;
+		pct[2] = perf_hist_pct(0.99) / ops;
+		pct[3] = perf_hist_max / ops;
+	}
+	else pct[0] = pct[1] = pct[2] = pct[3] = c;
+
+	if(perf_json)
+	{
+		f = "{\"algorithm\":\"%s\",\"key_bits\":%u,\"operation\":\"%s\","
+			"\"size\":%lu,\"backend\":\"%s\",\"samples\":%lu,"
+			"\"cycles\":%.2f,\"cpb\":%.4f,\"gbps\":%.4f,\"p50\":%.2f,"
+			"\"p90\":%.2f,\"p99\":%.2f,\"max\":%.2f}\n";
+	}
+	else f = "\"%s\",%u,\"%s\",%lu,\"%s\",%lu,%.2f,%.4f,%.4f,%.2f,%.2f,%.2f,%.2f\n";
+
+	fprintf(perf_out, f, alg, key_bits, op, (unsigned long)size,
+		perf_backend, (unsigned long)perf_hist_n, c, cpb, gbps,
+		pct[0], pct[1], pct[2], pct[3]);
+	fflush(perf_out);
 }
 
-void perf_rest(void)
+static PERF_UNUSED void perf_rest(void)
 {
 	#if defined(PERF_UNIX)
 	(void)sleep(1);
@@ -0,0 +1,478 @@
+/*
+ * Copyright (C) 2026 by Gregor Pintar <grpintar@gmail.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/* cc -Wall -Wextra -std=c99 -pedantic perf/scale.c -Iinclude lib/libkripto.a -O2 -DPERF_UNIX -D_GNU_SOURCE -pthread */
+
+/*
+ * Throughput with 1, 2, 4 ... threads, each pinned to its own cpu.
+ * Arguments: name filter and the largest thread count, all allowed
+ * cpus by default. Per thread is throughput of one thread relative to
+ * the single threaded run, anything below 100% is lost to shared
+ * caches, memory bandwidth, false sharing or locks.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+#include <kripto/block.h>
+#include <kripto/stream.h>
+#include <kripto/hash.h>
+#include <kripto/mac.h>
+#include <kripto/scrypt.h>
+
+#include <kripto/block/rijndael128.h>
+#include <kripto/stream/chacha.h>
+#include <kripto/stream/ctr.h>
+#include <kripto/hash/blake2b.h>
+#include <kripto/hash/sha2_256.h>
+#include <kripto/mac/hmac.h>
+
+#include "perf.h"
+
+#define MAXTHREADS 256
+
+/* bytes per operation */
+#define LEN 16384
+
+/* scrypt, 16 MiB per thread */
+#define SCRYPT_N 16384
+#define SCRYPT_R 8
+
+/* padded so neighbouring threads never share a line, or prefetched pair */
+#define PAD 128
+
+struct work
+{
+	const char *name;
+	unsigned int key_bits;
+	const char *op;
+	size_t size; /* bytes per operation, 0 to report operations */
+	unsigned long ops; /* per thread */
+	void *(*setup)(unsigned int id);
+	void (*run)(void *x, unsigned long ops);
+	void (*done)(void *x);
+};
+
+struct thread
+{
+	pthread_t t;
+	const struct work *w;
+	unsigned int id;
+	int cpu;
+	double sec;
+};
+
+static pthread_barrier_t barrier;
+
+static const uint8_t key[32] = {0x5A};
+static const uint8_t iv[16] = {0xA5};
+
+/* shared read-only key schedule */
+static kripto_block *shared;
+
+/* one block per thread, adjacent or PAD apart */
+static uint8_t *blocks;
+
+static kripto_desc_stream *ctr;
+static kripto_desc_mac *hmac;
+
+struct own
+{
+	kripto_stream *s;
+	kripto_hash *h;
+	uint8_t *buf;
+};
+
+static struct own *own(void)
+{
+	/* allocated by the thread itself, so it is local to its node */
+	struct own *x = (struct own *)calloc(1, sizeof(struct own));
+	if(!x) perf_die("calloc()");
+
+	x->buf = (uint8_t *)calloc(LEN + 64, 1);
+	if(!x->buf) perf_die("calloc()");
+
+	return x;
+}
+
+static void own_done(void *x)
+{
+	struct own *o = (struct own *)x;
+
+	if(o->s) kripto_stream_destroy(o->s);
+	if(o->h) kripto_hash_destroy(o->h);
+	free(o->buf);
+	free(o);
+}
+
+/* stream cipher, own context */
+static void *chacha_setup(unsigned int id)
+{
+	struct own *x = own();
+
+	(void)id;
+
+	x->s = kripto_stream_create(kripto_stream_chacha, 0, key, 32, iv, 8);
+	if(!x->s) perf_die("kripto_stream_create()");
+
+	return x;
+}
+
+static void *ctr_setup(unsigned int id)
+{
+	struct own *x = own();
+
+	(void)id;
+
+	x->s = kripto_stream_create(ctr, 0, key, 16, iv, 16);
+	if(!x->s) perf_die("kripto_stream_create()");
+
+	return x;
+}
+
+static void stream_run(void *x, unsigned long ops)
+{
+	struct own *o = (struct own *)x;
+
+	while(ops--) kripto_stream_encrypt(o->s, o->buf, o->buf, LEN);
+}
+
+/* hash, own context, one message per operation */
+static void *sha2_setup(unsigned int id)
+{
+	struct own *x = own();
+
+	(void)id;
+
+	x->h = kripto_hash_create(kripto_hash_sha2_256, 0, 0, 0, 32);
+	if(!x->h) perf_die("kripto_hash_create()");
+
+	return x;
+}
+
+static void *blake2b_setup(unsigned int id)
+{
+	struct own *x = own();
+
+	(void)id;
+
+	x->h = kripto_hash_create(kripto_hash_blake2b, 0, 0, 0, 64);
+	if(!x->h) perf_die("kripto_hash_create()");
+
+	return x;
+}
+
+static void hash_run(void *x, unsigned long ops)
+{
+	struct own *o = (struct own *)x;
+	unsigned int len = kripto_hash_maxout(kripto_hash_getdesc(o->h));
+
+	if(len > 64) len = 64;
+
+	while(ops--)
+	{
+		o->h = kripto_hash_recreate(o->h, 0, 0, 0, len);
+		kripto_hash_input(o->h, o->buf, LEN);
+		kripto_hash_output(o->h, o->buf + LEN, len);
+	}
+}
+
+/* block cipher, one key schedule shared by all threads */
+static void *shared_setup(unsigned int id)
+{
+	(void)id;
+
+	return own();
+}
+
+static void shared_run(void *x, unsigned long ops)
+{
+	struct own *o = (struct own *)x;
+
+	while(ops--)
+		kripto_block_encrypt_blocks(shared, o->buf, o->buf, LEN >> 4);
+}
+
+/* one block per thread, written in place */
+static void *adjacent_setup(unsigned int id)
+{
+	return blocks + id * 16;
+}
+
+static void *padded_setup(unsigned int id)
+{
+	return blocks + id * PAD;
+}
+
+static void block_run(void *x, unsigned long ops)
+{
+	while(ops--) kripto_block_encrypt(shared, x, x);
+}
+
+static void none(void *x)
+{
+	(void)x;
+}
+
+/* create and destroy, allocator and key schedule */
+static void *create_setup(unsigned int id)
+{
+	(void)id;
+
+	return 0;
+}
+
+static void chacha_create_run(void *x, unsigned long ops)
+{
+	kripto_stream *s;
+
+	(void)x;
+
+	while(ops--)
+	{
+		s = kripto_stream_create(kripto_stream_chacha, 0, key, 32, iv, 8);
+		if(!s) perf_die("kripto_stream_create()");
+		kripto_stream_destroy(s);
+	}
+}
+
+static void rijndael_create_run(void *x, unsigned long ops)
+{
+	kripto_block *s;
+
+	(void)x;
+
+	while(ops--)
+	{
+		s = kripto_block_create(kripto_block_rijndael128, 0, key, 16);
+		if(!s) perf_die("kripto_block_create()");
+		kripto_block_destroy(s);
+	}
+}
+
+/* scrypt, memory bandwidth bound */
+static void *scrypt_setup(unsigned int id)
+{
+	kripto_scrypt_ctx *s;
+
+	(void)id;
+
+	s = kripto_scrypt_ctx_create(SCRYPT_N, SCRYPT_R, 1, 1, 0);
+	if(!s) perf_die("kripto_scrypt_ctx_create()");
+
+	return s;
+}
+
+static void scrypt_run(void *x, unsigned long ops)
+{
+	kripto_scrypt_ctx *ctx = (kripto_scrypt_ctx *)x;
+	uint8_t out[32];
+
+	while(ops--)
+	{
+		if(kripto_scrypt_ctx_run(ctx, hmac, 0, "pass", 4, "salt", 4, out, 32))
+			perf_die("kripto_scrypt_ctx_run()");
+	}
+}
+
+static void scrypt_done(void *x)
+{
+	kripto_scrypt_ctx_destroy((kripto_scrypt_ctx *)x);
+}
+
+static double now(void)
+{
+	struct timespec t;
+
+	(void)clock_gettime(CLOCK_MONOTONIC, &t);
+
+	return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+static void *thread(void *arg)
+{
+	struct thread *t = (struct thread *)arg;
+	cpu_set_t set;
+	void *x;
+	double t0;
+
+	CPU_ZERO(&set);
+	CPU_SET(t->cpu, &set);
+	if(pthread_setaffinity_np(pthread_self(), sizeof(set), &set))
+		perror("pthread_setaffinity_np()");
+
+	x = t->w->setup(t->id);
+
+	/* warm up, then start together */
+	t->w->run(x, 1);
+	(void)pthread_barrier_wait(&barrier);
+
+	t0 = now();
+	t->w->run(x, t->w->ops);
+	t->sec = now() - t0;
+
+	t->w->done(x);
+
+	return 0;
+}
+
+static void scale
+(
+	const struct work *w,
+	const int *cpu,
+	unsigned int cpus,
+	unsigned int max
+)
+{
+	struct thread t[MAXTHREADS];
+	char op[64];
+	double single = 0;
+
+	puts(w->name);
+
+	for(unsigned int n = 1; n <= max; n = n == max ? max + 1 : n << 1 < max ? n << 1 : max)
+	{
+		double sec = 0;
+		double sum = 0;
+
+		if(pthread_barrier_init(&barrier, 0, n)) perf_die("pthread_barrier_init()");
+
+		for(unsigned int i = 0; i < n; i++)
+		{
+			t[i].w = w;
+			t[i].id = i;
+			t[i].cpu = cpu[i % cpus];
+
+			if(i && pthread_create(&t[i].t, 0, thread, t + i))
+				perf_die("pthread_create()");
+		}
+
+		(void)thread(t);
+
+		for(unsigned int i = 1; i < n; i++)
+			(void)pthread_join(t[i].t, 0);
+
+		(void)pthread_barrier_destroy(&barrier);
+
+		/* aggregate over the slowest thread, per thread as a mean */
+		perf_hist_reset();
+		for(unsigned int i = 0; i < n; i++)
+		{
+			if(sec < t[i].sec) sec = t[i].sec;
+			sum += w->ops / t[i].sec;
+			perf_hist_add(t[i].sec * perf_hz / w->ops);
+		}
+
+		double total = n * w->ops / sec;
+		double each = sum / n;
+		if(n == 1) single = each;
+
+		if(w->size)
+		{
+			printf("%3u threads: %.3f GB/s aggregate, %.3f GB/s per thread, %.0f%%\n",
+				n, total * w->size / 1e9, each * w->size / 1e9,
+				each * 100 / single);
+		}
+		else
+		{
+			printf("%3u threads: %.0f ops/s aggregate, %.0f ops/s per thread, %.0f%%\n",
+				n, total, each, each * 100 / single);
+		}
+
+		/* per thread, percentiles are over threads */
+		(void)snprintf(op, sizeof(op), "%s %u threads", w->op, n);
+		perf_record(w->name, w->key_bits, op, w->size, 1,
+			(perf_int)(perf_hz / each));
+
+		fflush(stdout);
+	}
+
+	putchar('\n');
+}
+
+int main(int argc, char *argv[])
+{
+	const struct work works[10] =
+	{
+		{"ChaCha, own context", 256, "encrypt", LEN, 4096,
+			chacha_setup, stream_run, own_done},
+		{"CTR Rijndael-128, own context", 128, "encrypt", LEN, 1024,
+			ctr_setup, stream_run, own_done},
+		{"SHA2-256, own context", 0, "hash", LEN, 1024,
+			sha2_setup, hash_run, own_done},
+		{"BLAKE2b, own context", 0, "hash", LEN, 2048,
+			blake2b_setup, hash_run, own_done},
+		{"Rijndael-128, shared key", 128, "encrypt", LEN, 1024,
+			shared_setup, shared_run, own_done},
+		{"Rijndael-128, shared key, padded blocks", 128, "encrypt", 16,
+			1 << 20, padded_setup, block_run, none},
+		{"Rijndael-128, shared key, adjacent blocks", 128, "encrypt", 16,
+			1 << 20, adjacent_setup, block_run, none},
+		{"ChaCha create", 256, "create", 0, 1 << 16,
+			create_setup, chacha_create_run, none},
+		{"Rijndael-128 create", 128, "create", 0, 1 << 16,
+			create_setup, rijndael_create_run, none},
+		/* V is written once and read once per derivation */
+		{"scrypt N=16384 r=8, memory traffic", 0, "derive",
+			256 * SCRYPT_R * SCRYPT_N, 8,
+			scrypt_setup, scrypt_run, scrypt_done}
+	};
+	const char *filter = argc > 1 ? argv[1] : "";
+	int cpu[MAXTHREADS];
+	unsigned int cpus = 0;
+	unsigned int max;
+	cpu_set_t set;
+
+	/* cpus this process may run on */
+	if(sched_getaffinity(0, sizeof(set), &set)) perf_die("sched_getaffinity()");
+	for(int i = 0; i < CPU_SETSIZE && cpus < MAXTHREADS; i++)
+		if(CPU_ISSET(i, &set)) cpu[cpus++] = i;
+
+	max = argc > 2 ? (unsigned int)atoi(argv[2]) : cpus;
+	if(!max) max = 1;
+	if(max > MAXTHREADS) max = MAXTHREADS;
+
+	/* no perf_init(), SCHED_FIFO on every cpu could starve the system */
+	puts("For better results disable dynamic CPU frequency scaling!");
+	perf_freq();
+	perf_out_open();
+
+	printf("%u cpus, up to %u threads\n\n", cpus, max);
+
+	shared = kripto_block_create(kripto_block_rijndael128, 0, key, 16);
+	blocks = (uint8_t *)calloc(MAXTHREADS, PAD);
+	ctr = kripto_stream_ctr(kripto_block_rijndael128);
+	hmac = kripto_mac_hmac(kripto_hash_sha2_256);
+	if(!shared || !blocks || !ctr || !hmac) perf_die("setup");
+
+	for(unsigned int i = 0; i < 10; i++)
+	{
+		if(!strstr(works[i].name, filter)) continue;
+
+		scale(works + i, cpu, cpus, max);
+	}
+
+	free(hmac);
+	free(ctr);
+	free(blocks);
+	kripto_block_destroy(shared);
+
+	return 0;
+}
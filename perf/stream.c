@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2026 by Gregor Pintar <grpintar@gmail.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/* cc -Wall -Wextra -std=c99 -pedantic perf/stream.c -Iinclude lib/libkripto.a -O2 -DPERF_UNIX -D_GNU_SOURCE */
+/* cc -Wall -Wextra -std=c99 -pedantic perf/stream.c -Iinclude lib/libkripto.a -O2 -DPERF_WINDOWS /lib/w32api/libpowrprof.a */
+
+/* optional argument: only streams whose name contains it, e.g. "CTR Rijndael" */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include <kripto/block.h>
+#include <kripto/stream.h>
+
+#include <kripto/stream/cbc.h>
+#include <kripto/stream/cfb.h>
+#include <kripto/stream/chacha.h>
+#include <kripto/stream/ctr.h>
+#include <kripto/stream/ecb.h>
+#include <kripto/stream/keccak1600.h>
+#include <kripto/stream/keccak800.h>
+#include <kripto/stream/ofb.h>
+#include <kripto/stream/rc4.h>
+#include <kripto/stream/salsa20.h>
+#include <kripto/stream/skein256.h>
+#include <kripto/stream/skein512.h>
+#include <kripto/stream/skein1024.h>
+
+#include "ciphers.h"
+#include "message.h"
+
+#define MINLEN 16
+#define MAXLEN (1 << 20)
+#define MAXKEY 32
+#define MAXIV 128
+
+static void stream
+(
+	const char *name,
+	const kripto_desc_stream *desc,
+	uint8_t *buf
+)
+{
+	perf_int cycles;
+	uint8_t k[MAXKEY];
+	uint8_t iv[MAXIV];
+
+	unsigned int key_len = kripto_stream_maxkey(desc);
+	if(key_len > MAXKEY) key_len = MAXKEY;
+
+	unsigned int iv_len = kripto_stream_maxiv(desc);
+	if(iv_len > MAXIV) iv_len = MAXIV;
+
+	memset(k, 0x5A, key_len);
+	memset(iv, 0xA5, iv_len);
+
+	kripto_stream *s = kripto_stream_create(desc, 0, k, key_len, iv, iv_len);
+	if(!s) perf_die("kripto_stream_create()");
+
+	puts(name);
+
+	/* setup */
+	perf_n = SETUP_ITERATIONS;
+	PERF_START
+	for(unsigned int r = 0; r < SETUP_BATCH; r++)
+	{
+		s = kripto_stream_recreate(s, 0, k, key_len, iv, iv_len);
+		if(!s) perf_die("kripto_stream_recreate()");
+	}
+	PERF_STOP
+
+	printf("%u-bit setup: %lu cycles\n", key_len * 8,
+		(unsigned long)(cycles / SETUP_BATCH));
+	perf_report(SETUP_BATCH);
+	perf_record(name, key_len * 8, "setup", 0, SETUP_BATCH, cycles);
+
+	/* bulk, without setup */
+	unsigned int multof = kripto_stream_multof(s);
+
+	for(size_t len = MINLEN; len <= MAXLEN; len <<= 2)
+	{
+		if(len % multof) continue;
+
+		size_t batch = perf_batch(len, 1);
+
+		PERF_START
+		for(size_t r = 0; r < batch; r++)
+			kripto_stream_encrypt(s, buf, buf, len);
+		PERF_STOP
+
+		double bytes = (double)len * batch;
+
+		printf("%7lu B: %.2f cpb", (unsigned long)len, cycles / bytes);
+		if(perf_hz) printf(", %.3f GB/s", bytes * perf_hz / cycles / 1e9);
+		putchar('\n');
+		perf_report(bytes);
+		perf_record(name, key_len * 8, "encrypt", len, batch, cycles);
+	}
+
+	kripto_stream_destroy(s);
+
+	perf_rest();
+	fflush(stdout);
+	putchar('\n');
+}
+
+int main(int argc, char *argv[])
+{
+	const struct perf_cipher ciphers[PERF_CIPHERS] = {PERF_CIPHER_LIST};
+	struct
+	{
+		const char *name;
+		kripto_desc_stream *(*mode)(const kripto_desc_block *);
+	} modes[5] =
+	{
+		{"CTR", kripto_stream_ctr},
+		{"CBC", kripto_stream_cbc},
+		{"CFB", kripto_stream_cfb},
+		{"OFB", kripto_stream_ofb},
+		{"ECB", kripto_stream_ecb}
+	};
+	struct
+	{
+		const char *name;
+		const kripto_desc_stream *desc;
+	} streams[8] =
+	{
+		{"ChaCha", kripto_stream_chacha},
+		{"Salsa20", kripto_stream_salsa20},
+		{"RC4", kripto_stream_rc4},
+		{"Keccak-1600", kripto_stream_keccak1600},
+		{"Keccak-800", kripto_stream_keccak800},
+		{"Skein-256", kripto_stream_skein256},
+		{"Skein-512", kripto_stream_skein512},
+		{"Skein-1024", kripto_stream_skein1024}
+	};
+	const char *filter = argc > 1 ? argv[1] : "";
+	char name[64];
+
+	uint8_t *buf = (uint8_t *)malloc(MAXLEN);
+	if(!buf) perf_die("malloc()");
+	memset(buf, 0, MAXLEN);
+
+	perf_init();
+
+	for(unsigned int i = 0; i < 8; i++)
+	{
+		if(!strstr(streams[i].name, filter)) continue;
+
+		stream(streams[i].name, streams[i].desc, buf);
+	}
+
+	for(unsigned int m = 0; m < 5; m++)
+	{
+		for(unsigned int i = 0; i < PERF_CIPHERS; i++)
+		{
+			(void)snprintf(name, sizeof(name), "%s %s",
+				modes[m].name, ciphers[i].name);
+			if(!strstr(name, filter)) continue;
+
+			kripto_desc_stream *desc = modes[m].mode(ciphers[i].desc);
+			if(!desc) perf_die("mode");
+
+			stream(name, desc, buf);
+
+			free(desc);
+		}
+	}
+
+	free(buf);
+
+	return 0;
+}
@@ -79,6 +79,24 @@ int main(void)
 	TEST_CMP(t, tag, 16, "kripto_ae_tag after decrypt");
 
 	kripto_ae_destroy(s);
+
+	/* on the stack */
+	uint8_t mem[8192];
+
+	size_t size = kripto_ae_ctx_size(desc, 0, 16, 16, 16);
+	if(!size || size > sizeof(mem)) TEST_ERROR("kripto_ae_ctx_size");
+
+	s = kripto_ae_init(desc, mem, size, 0, k, 16, k, 16, 16);
+	if(!s) TEST_ERROR("kripto_ae_init");
+
+	kripto_ae_encrypt(s, pt, t, 32);
+	TEST_CMP(t, ct, 32, "kripto_ae_encrypt in caller memory");
+
+	kripto_ae_header(s, pt, 16);
+	kripto_ae_tag(s, t, 16);
+	TEST_CMP(t, tag, 16, "kripto_ae_tag in caller memory");
+
+	kripto_ae_fini(s);
 	free(desc);
 
 	return test_result;
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2026 by Gregor Pintar <grpintar@gmail.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <limits.h>
+
+#include <kripto/stream.h>
+#include <kripto/stream/chacha.h>
+#include <kripto/hash.h>
+#include <kripto/hash/sha2_256.h>
+#include <kripto/mac.h>
+#include <kripto/mac/hmac.h>
+#include <kripto/ae.h>
+#include <kripto/ae/eax2.h>
+
+#include "../test.h"
+
+int main(void)
+{
+	uint8_t k[64];
+	uint8_t iv[24];
+	uint8_t pt[100];
+	uint8_t ct[100];
+	uint8_t t[100];
+	uint8_t tag[16];
+	uint8_t tag2[16];
+	unsigned int i;
+
+	for(i = 0; i < 64; i++) k[i] = i;
+	for(i = 0; i < 24; i++) iv[i] = i * 3;
+	for(i = 0; i < 100; i++) pt[i] = i * 7;
+
+	kripto_desc_mac *hmac = kripto_mac_hmac(kripto_hash_sha2_256);
+	if(!hmac) TEST_ERROR("kripto_mac_hmac");
+
+	kripto_desc_ae *desc = kripto_ae_eax2(kripto_stream_chacha, hmac);
+	if(!desc) TEST_ERROR("kripto_ae_eax2");
+
+	/* HMAC takes any key length, the sum must not wrap */
+	if(kripto_ae_maxkey(desc) != UINT_MAX) TEST_FAIL("kripto_ae_maxkey");
+	else TEST_PASS("kripto_ae_maxkey");
+
+	/* round trip with a key longer than the stream cipher takes */
+	kripto_ae *s = kripto_ae_create(desc, 0, k, 64, iv, 16, 16);
+	if(!s) TEST_ERROR("kripto_ae_create");
+
+	kripto_ae_header(s, iv, 16);
+	kripto_ae_encrypt(s, pt, ct, 100);
+	kripto_ae_tag(s, tag, 16);
+
+	s = kripto_ae_recreate(s, 0, k, 64, iv, 16, 16);
+	if(!s) TEST_ERROR("kripto_ae_recreate");
+
+	kripto_ae_header(s, iv, 16);
+	kripto_ae_decrypt(s, ct, t, 100);
+	kripto_ae_tag(s, tag2, 16);
+	TEST_CMP(t, pt, 100, "kripto_ae_decrypt");
+	TEST_CMP(tag2, tag, 16, "kripto_ae_tag");
+
+	/* nonce longer than the tag, from a fresh and a reused context */
+	kripto_ae *s2 = kripto_ae_create(desc, 0, k, 64, iv, 24, 8);
+	if(!s2) TEST_ERROR("kripto_ae_create");
+
+	kripto_ae_header(s2, iv, 16);
+	kripto_ae_encrypt(s2, pt, ct, 100);
+	kripto_ae_tag(s2, tag, 8);
+	kripto_ae_destroy(s2);
+
+	s = kripto_ae_recreate(s, 0, k, 64, iv, 24, 8);
+	if(!s) TEST_ERROR("kripto_ae_recreate");
+
+	kripto_ae_header(s, iv, 16);
+	kripto_ae_decrypt(s, ct, t, 100);
+	kripto_ae_tag(s, tag2, 8);
+	TEST_CMP(t, pt, 100, "kripto_ae_decrypt long nonce");
+	TEST_CMP(tag2, tag, 8, "kripto_ae_tag long nonce");
+
+	kripto_ae_destroy(s);
+	free(desc);
+	free(hmac);
+
+	return test_result;
+}
@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2026 by Gregor Pintar <grpintar@gmail.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <kripto/cpu.h>
+#include <kripto/argon2.h>
+
+#include "test.h"
+
+int main(void)
+{
+	/* https://www.rfc-editor.org/rfc/rfc9106 */
+	const uint8_t out[3][32] =
+	{
+		{
+			0x51, 0x2B, 0x39, 0x1B, 0x6F, 0x11, 0x62, 0x97,
+			0x53, 0x71, 0xD3, 0x09, 0x19, 0x73, 0x42, 0x94,
+			0xF8, 0x68, 0xE3, 0xBE, 0x39, 0x84, 0xF3, 0xC1,
+			0xA1, 0x3A, 0x4D, 0xB9, 0xFA, 0xBE, 0x4A, 0xCB
+		},
+		{
+			0xC8, 0x14, 0xD9, 0xD1, 0xDC, 0x7F, 0x37, 0xAA,
+			0x13, 0xF0, 0xD7, 0x7F, 0x24, 0x94, 0xBD, 0xA1,
+			0xC8, 0xDE, 0x6B, 0x01, 0x6D, 0xD3, 0x88, 0xD2,
+			0x99, 0x52, 0xA4, 0xC4, 0x67, 0x2B, 0x6C, 0xE8
+		},
+		{
+			0x0D, 0x64, 0x0D, 0xF5, 0x8D, 0x78, 0x76, 0x6C,
+			0x08, 0xC0, 0x37, 0xA3, 0x4A, 0x8B, 0x53, 0xC9,
+			0xD0, 0x1E, 0xF0, 0x45, 0x2D, 0x75, 0xB6, 0x5E,
+			0xB5, 0x25, 0x20, 0xE9, 0x6B, 0x01, 0xE6, 0x59
+		}
+	};
+	const char *name[3] = {"Argon2d", "Argon2i", "Argon2id"};
+	const unsigned int threads[4] = {1, 3, 4, 0};
+	const unsigned int cpu[4] =
+	{
+		kripto_cpu(),
+		KRIPTO_CPU_SSE2,
+		KRIPTO_CPU_SSE2 | KRIPTO_CPU_AVX2,
+		0
+	};
+	uint8_t pass[32];
+	uint8_t salt[16];
+	uint8_t secret[8];
+	uint8_t ad[12];
+	uint8_t buf[32];
+
+	memset(pass, 0x01, 32);
+	memset(salt, 0x02, 16);
+	memset(secret, 0x03, 8);
+	memset(ad, 0x04, 12);
+
+	/* every BlaMka kernel */
+	for(unsigned int i = 0; i < 4; i++)
+	{
+		kripto_cpu_set(cpu[i]);
+
+		for(unsigned int t = 0; t < 3; t++)
+		{
+			if(kripto_argon2
+			(
+				t,
+				3,
+				32,
+				4,
+				pass,
+				32,
+				salt,
+				16,
+				secret,
+				8,
+				ad,
+				12,
+				buf,
+				32
+			)) TEST_ERROR("kripto_argon2() returned error");
+
+			TEST_CMP(buf, out[t], 32, "%s cpu %X", name[t], cpu[i]);
+		}
+	}
+
+	kripto_cpu_set(cpu[0]);
+
+	/* 4 lanes split over threads, reused memory */
+	for(unsigned int i = 0; i < 4; i++)
+	{
+		kripto_argon2_ctx *ctx = kripto_argon2_ctx_create
+		(
+			32, 4, threads[i],
+			(i & 1) ? KRIPTO_ARGON2_HUGEPAGES : 0
+		);
+		if(!ctx) TEST_ERROR("kripto_argon2_ctx_create() returned error");
+
+		if(kripto_argon2_ctx_memory(ctx) >= 32 * 1024)
+			TEST_PASS("Argon2 ctx memory");
+		else
+			TEST_FAIL("Argon2 ctx memory");
+
+		for(unsigned int t = 0; t < 3; t++)
+		{
+			if(kripto_argon2_ctx_run
+			(
+				ctx,
+				t,
+				3,
+				pass,
+				32,
+				salt,
+				16,
+				secret,
+				8,
+				ad,
+				12,
+				buf,
+				32
+			)) TEST_ERROR("kripto_argon2_ctx_run() returned error");
+
+			TEST_CMP(buf, out[t], 32, "%s %u threads", name[t], threads[i]);
+		}
+
+		kripto_argon2_ctx_destroy(ctx);
+	}
+
+	return test_result;
+}
@@ -13,6 +13,7 @@
  * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
  */
 
+#include <kripto/cpu.h>
 #include <kripto/block.h>
 #include <kripto/block/rijndael128.h>
 
@@ -78,5 +79,9 @@ int main(void)
 		}
 	};
 
+	TEST(kripto_block_rijndael128, vectors, 6);
+
+	/* portable */
+	kripto_cpu_set(0);
 	return TEST(kripto_block_rijndael128, vectors, 6);
 }
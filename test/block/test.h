@@ -51,6 +51,7 @@ int test
 {
 	unsigned int block_size = kripto_block_size(desc);
 	char t[block_size];
+	char m[block_size * 9];
 
 	for(unsigned int i = 0; i < vectors_len; i++)
 	{
@@ -76,7 +77,102 @@ int test
 		}
 		test_cmp(t, vectors[i].pt, block_size, file, line, "Decrypt vector %u", i);
 
+		/* multiple blocks */
+		for(unsigned int b = 0; b < 9; b++)
+		{
+			memcpy(m + b * block_size, vectors[i].pt, block_size);
+		}
+		for(unsigned int r = 0; r < vectors[i].iterations; r++)
+		{
+			kripto_block_encrypt_blocks(s, m, m, 9);
+		}
+		for(unsigned int b = 0; b < 9; b++)
+		{
+			test_cmp(m + b * block_size, vectors[i].ct, block_size, file, line, "Encrypt blocks vector %u", i);
+		}
+
+		for(unsigned int r = 0; r < vectors[i].iterations; r++)
+		{
+			kripto_block_decrypt_blocks(s, m, m, 9);
+		}
+		for(unsigned int b = 0; b < 9; b++)
+		{
+			test_cmp(m + b * block_size, vectors[i].pt, block_size, file, line, "Decrypt blocks vector %u", i);
+		}
+
+		/* multiple keys */
+		const kripto_block *ms[9];
+		const void *mpt[9];
+		void *mct[9];
+		for(unsigned int b = 0; b < 9; b++)
+		{
+			ms[b] = s;
+			mpt[b] = mct[b] = m + b * block_size;
+		}
+		for(unsigned int r = 0; r < vectors[i].iterations; r++)
+		{
+			kripto_block_encrypt_multi(ms, mpt, mct, 9);
+		}
+		for(unsigned int b = 0; b < 9; b++)
+		{
+			test_cmp(m + b * block_size, vectors[i].ct, block_size, file, line, "Encrypt multi vector %u", i);
+		}
+
+		kripto_block_destroy(s);
+
+		/* recreate from a schedule for another key size */
+		char k[64];
+		unsigned int k_len = kripto_block_maxkey(desc);
+		if(k_len > 64) k_len = 64;
+		memset(k, 0x5A, k_len);
+
+		s = kripto_block_create(desc, 0, k, k_len);
+		if(!s) test_error(file, line, "Create max key vector %u", i);
+
+		s = kripto_block_recreate(s, vectors[i].rounds, vectors[i].key, vectors[i].key_len);
+		if(!s) test_error(file, line, "Recreate vector %u", i);
+
+		if(vectors[i].tweak_len > 0)
+		{
+			kripto_block_tweak(s, vectors[i].tweak, vectors[i].tweak_len);
+		}
+
+		memcpy(t, vectors[i].pt, block_size);
+		for(unsigned int r = 0; r < vectors[i].iterations; r++)
+		{
+			kripto_block_encrypt(s, t, t);
+		}
+		test_cmp(t, vectors[i].ct, block_size, file, line, "Recreate vector %u", i);
+
 		kripto_block_destroy(s);
+
+		/* context in caller memory, misaligned on purpose */
+		size_t size = kripto_block_ctx_size(desc, vectors[i].rounds, vectors[i].key_len);
+		if(!size) test_error(file, line, "Context size vector %u", i);
+
+		char *mem = (char *)malloc(size + 1);
+		if(!mem) test_error(file, line, "malloc()");
+
+		if(kripto_block_init(desc, mem + 1, 0, vectors[i].rounds, vectors[i].key, vectors[i].key_len))
+			test_fail(file, line, "Init too small vector %u", i);
+
+		s = kripto_block_init(desc, mem + 1, size, vectors[i].rounds, vectors[i].key, vectors[i].key_len);
+		if(!s) test_error(file, line, "Init vector %u", i);
+
+		if(vectors[i].tweak_len > 0)
+		{
+			kripto_block_tweak(s, vectors[i].tweak, vectors[i].tweak_len);
+		}
+
+		memcpy(t, vectors[i].pt, block_size);
+		for(unsigned int r = 0; r < vectors[i].iterations; r++)
+		{
+			kripto_block_encrypt(s, t, t);
+		}
+		test_cmp(t, vectors[i].ct, block_size, file, line, "Init vector %u", i);
+
+		kripto_block_fini(s);
+		free(mem);
 	}
 
 	return test_result;
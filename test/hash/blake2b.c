@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2026 by Gregor Pintar <grpintar@gmail.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <kripto/hash.h>
+#include <kripto/hash/blake2b.h>
+
+#include "test.h"
+
+int main(void)
+{
+	/* RFC 7693 and empty/full last blocks */
+	const struct vector vectors[5] =
+	{
+		{
+			.message = "",
+			.message_len = 0,
+			.message_repeat = 1,
+			.salt_len = 0,
+			.rounds = 0,
+			.hash = "\x78\x6A\x02\xF7\x42\x01\x59\x03\xC6\xC6\xFD\x85\x25\x52\xD2\x72\x91\x2F\x47\x40\xE1\x58\x47\x61\x8A\x86\xE2\x17\xF7\x1F\x54\x19\xD2\x5E\x10\x31\xAF\xEE\x58\x53\x13\x89\x64\x44\x93\x4E\xB0\x4B\x90\x3A\x68\x5B\x14\x48\xB7\x55\xD5\x6F\x70\x1A\xFE\x9B\xE2\xCE",
+			.hash_len = 64
+		},
+		{
+			.message = "\x61\x62\x63",
+			.message_len = 3,
+			.message_repeat = 1,
+			.salt_len = 0,
+			.rounds = 0,
+			.hash = "\xBA\x80\xA5\x3F\x98\x1C\x4D\x0D\x6A\x27\x97\xB6\x9F\x12\xF6\xE9\x4C\x21\x2F\x14\x68\x5A\xC4\xB7\x4B\x12\xBB\x6F\xDB\xFF\xA2\xD1\x7D\x87\xC5\x39\x2A\xAB\x79\x2D\xC2\x52\xD5\xDE\x45\x33\xCC\x95\x18\xD3\x8A\xA8\xDB\xF1\x92\x5A\xB9\x23\x86\xED\xD4\x00\x99\x23",
+			.hash_len = 64
+		},
+		{
+			.message = "\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00",
+			.message_len = 128,
+			.message_repeat = 1,
+			.salt_len = 0,
+			.rounds = 0,
+			.hash = "\x86\x59\x39\xE1\x20\xE6\x80\x54\x38\x47\x88\x41\xAF\xB7\x39\xAE\x42\x50\xCF\x37\x26\x53\x07\x8A\x06\x5C\xDC\xFF\xFC\xA4\xCA\xF7\x98\xE6\xD4\x62\xB6\x5D\x65\x8F\xC1\x65\x78\x26\x40\xED\xED\x70\x96\x34\x49\xAE\x15\x00\xFB\x0F\x24\x98\x1D\x77\x27\xE2\x2C\x41",
+			.hash_len = 64
+		},
+		{
+			.message = "\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00",
+			.message_len = 129,
+			.message_repeat = 1,
+			.salt_len = 0,
+			.rounds = 0,
+			.hash = "\xA6\x0E\xDB\xA3\x43\xE7\xA6\x93\x3C\x14\xD2\x03\xD2\xE5\x35\xF3\x5E\x6D\xEB\x6C\x8A\x4F\x8E\x62\x4C\x1A\x6F\x6E\x26\x12\x86\x04\x47\xCB\x4C\x37\xE5\xAA\x11\xBC\xF0\x3B\x7C\x3E\xEA\x72\x28\xEB\x8B\x99\x8F\x92\x27\x94\xF2\xD1\xB8\xF2\xDC\x63\xF0\x3B\xD3\xFA",
+			.hash_len = 64
+		},
+		{
+			.message = "\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00",
+			.message_len = 128,
+			.message_repeat = 2,
+			.salt_len = 0,
+			.rounds = 0,
+			.hash = "\xEC\x9C\x6B\x30\x1A\x6C\x98\x94\x6D\x74\x2A\x74\x71\x0E\x65\x8F\x02\x43\xE0\xE6\xD3\x52\x5F\x4A\xFA\x94\xDF\xC2\x39\x54\x56\xFA\x54\xEB\xE5\xEF\x0F\x41\x3B\x5A\x9A\xBF\xE6\x50\x1D\xAB\xB4\xB9\xA0\xFB\xCA\x16\x4D\x6C\xD8\x0B\x1E\x79\xDB\xBE\xD8\xD4\x20\x2E",
+			.hash_len = 64
+		}
+	};
+
+	return TEST(kripto_hash_blake2b, vectors, 5);
+}
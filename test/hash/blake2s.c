@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2026 by Gregor Pintar <grpintar@gmail.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <kripto/hash.h>
+#include <kripto/hash/blake2s.h>
+
+#include "test.h"
+
+int main(void)
+{
+	/* RFC 7693 and empty/full last blocks */
+	const struct vector vectors[4] =
+	{
+		{
+			.message = "",
+			.message_len = 0,
+			.message_repeat = 1,
+			.salt_len = 0,
+			.rounds = 0,
+			.hash = "\x69\x21\x7A\x30\x79\x90\x80\x94\xE1\x11\x21\xD0\x42\x35\x4A\x7C\x1F\x55\xB6\x48\x2C\xA1\xA5\x1E\x1B\x25\x0D\xFD\x1E\xD0\xEE\xF9",
+			.hash_len = 32
+		},
+		{
+			.message = "\x61\x62\x63",
+			.message_len = 3,
+			.message_repeat = 1,
+			.salt_len = 0,
+			.rounds = 0,
+			.hash = "\x50\x8C\x5E\x8C\x32\x7C\x14\xE2\xE1\xA7\x2B\xA3\x4E\xEB\x45\x2F\x37\x45\x8B\x20\x9E\xD6\x3A\x29\x4D\x99\x9B\x4C\x86\x67\x59\x82",
+			.hash_len = 32
+		},
+		{
+			.message = "\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00",
+			.message_len = 64,
+			.message_repeat = 1,
+			.salt_len = 0,
+			.rounds = 0,
+			.hash = "\xAE\x09\xDB\x7C\xD5\x4F\x42\xB4\x90\xEF\x09\xB6\xBC\x54\x1A\xF6\x88\xE4\x95\x9B\xB8\xC5\x3F\x35\x9A\x6F\x56\xE3\x8A\xB4\x54\xA3",
+			.hash_len = 32
+		},
+		{
+			.message = "\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00",
+			.message_len = 65,
+			.message_repeat = 1,
+			.salt_len = 0,
+			.rounds = 0,
+			.hash = "\x85\x73\x28\xBF\x99\x0B\x00\x92\x27\x82\xD3\xE8\x1C\x60\x54\xC2\x5D\x33\x75\xD3\x86\xC7\x42\x4A\xBE\x3E\x01\xD7\x90\x41\x04\x6C",
+			.hash_len = 32
+		}
+	};
+
+	TEST(kripto_hash_blake2s, vectors, 4);
+
+	return TEST_MULTI(kripto_hash_blake2s, 32);
+}
@@ -13,6 +13,7 @@
  * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
  */
 
+#include <kripto/cpu.h>
 #include <kripto/hash.h>
 #include <kripto/hash/sha1.h>
 
@@ -60,5 +61,10 @@ int main(void)
 		}
 	};
 
+	TEST(kripto_hash_sha1, vectors, 4);
+	TEST_MULTI(kripto_hash_sha1, 20);
+
+	/* portable */
+	kripto_cpu_set(0);
 	return TEST(kripto_hash_sha1, vectors, 4);
 }
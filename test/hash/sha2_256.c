@@ -13,6 +13,7 @@
  * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
  */
 
+#include <kripto/cpu.h>
 #include <kripto/hash.h>
 #include <kripto/hash/sha2_256.h>
 
@@ -78,5 +79,11 @@ int main(void)
 		}
 	};
 
+	TEST(kripto_hash_sha2_256, vectors, 6);
+	TEST_MULTI(kripto_hash_sha2_256, 28);
+	TEST_MULTI(kripto_hash_sha2_256, 32);
+
+	/* portable */
+	kripto_cpu_set(0);
 	return TEST(kripto_hash_sha2_256, vectors, 6);
 }
@@ -16,6 +16,8 @@
 #ifndef TEST_HASH_TEST_H
 #define TEST_HASH_TEST_H
 
+#include <kripto/cpu.h>
+
 #include "../test.h"
 
 struct vector
@@ -40,6 +42,15 @@ int test
 );
 #define TEST(DESC, VECTORS, VECTORS_LEN) test(__FILE__, __LINE__, DESC, VECTORS, VECTORS_LEN)
 
+int test_multi
+(
+	const char *file,
+	unsigned int line,
+	const kripto_desc_hash *desc,
+	unsigned int out_len
+);
+#define TEST_MULTI(DESC, OUT_LEN) test_multi(__FILE__, __LINE__, DESC, OUT_LEN)
+
 int test
 (
 	const char *file,
@@ -66,11 +77,50 @@ int test
 			kripto_hash_input(s, vectors[i].message, vectors[i].message_len);
 		}
 
+		kripto_hash *c = kripto_hash_create
+		(
+			desc, vectors[i].rounds,
+			vectors[i].salt, vectors[i].salt_len,
+			vectors[i].hash_len
+		);
+		if(!c) test_error(file, line, "Create copy vector %u", i);
+		kripto_hash_copy(s, c);
+
 		kripto_hash_output(s, t, vectors[i].hash_len);
 		test_cmp(t, vectors[i].hash, vectors[i].hash_len, file, line, "Hash vector %u", i);
 
+		kripto_hash_output(c, t, vectors[i].hash_len);
+		test_cmp(t, vectors[i].hash, vectors[i].hash_len, file, line, "Copy vector %u", i);
+
+		kripto_hash_destroy(c);
 		kripto_hash_destroy(s);
 
+		/* context in caller memory, misaligned on purpose */
+		size_t size = kripto_hash_ctx_size(desc, vectors[i].rounds, vectors[i].salt_len, vectors[i].hash_len);
+		if(!size) test_error(file, line, "Context size vector %u", i);
+
+		char *mem = (char *)malloc(size + 1);
+		if(!mem) test_error(file, line, "malloc()");
+
+		s = kripto_hash_init
+		(
+			desc, mem + 1, size, vectors[i].rounds,
+			vectors[i].salt, vectors[i].salt_len,
+			vectors[i].hash_len
+		);
+		if(!s) test_error(file, line, "Init vector %u", i);
+
+		for(unsigned int r = 0; r < vectors[i].message_repeat; r++)
+		{
+			kripto_hash_input(s, vectors[i].message, vectors[i].message_len);
+		}
+
+		kripto_hash_output(s, t, vectors[i].hash_len);
+		test_cmp(t, vectors[i].hash, vectors[i].hash_len, file, line, "Init vector %u", i);
+
+		kripto_hash_fini(s);
+		free(mem);
+
 		if(vectors[i].message_repeat == 1)
 		{
 			if(kripto_hash_all
@@ -87,4 +137,57 @@ int test
 	return test_result;
 }
 
+int test_multi
+(
+	const char *file,
+	unsigned int line,
+	const kripto_desc_hash *desc,
+	unsigned int out_len
+)
+{
+	const unsigned int cpu[3] =
+	{
+		kripto_cpu(),
+		KRIPTO_CPU_SSE2 | KRIPTO_CPU_AVX2,
+		0
+	};
+	unsigned char m[600];
+	unsigned char h[40][out_len];
+	unsigned char t[out_len];
+	const void *in[40];
+	void *out[40];
+	size_t in_len[40];
+
+	for(unsigned int i = 0; i < sizeof(m); i++) m[i] = i * 7 + 3;
+
+	/* different lengths, lanes finish and refill at different times */
+	for(unsigned int i = 0; i < 40; i++)
+	{
+		in[i] = m + i * 5;
+		in_len[i] = (i * 29) % 300;
+		out[i] = h[i];
+	}
+	in_len[1] = 64;
+	in_len[2] = 128;
+
+	for(unsigned int c = 0; c < 3; c++)
+	{
+		kripto_cpu_set(cpu[c]);
+
+		if(kripto_hash_multi(desc, 0, 0, 0, in, in_len, out, out_len, 40))
+			test_error(file, line, "Multi cpu %x", cpu[c]);
+
+		for(unsigned int i = 0; i < 40; i++)
+		{
+			if(kripto_hash_all(desc, 0, 0, 0, in[i], in_len[i], t, out_len))
+				test_error(file, line, "Hash all %u", i);
+			test_cmp(h[i], t, out_len, file, line, "Multi cpu %x message %u", cpu[c], i);
+		}
+	}
+
+	kripto_cpu_set(cpu[0]);
+
+	return test_result;
+}
+
 #endif
@@ -90,8 +90,54 @@ int test
 			test_fail(file, line, "Verify vector %u", i);
 		}
 
+		if(kripto_mac_resettable(desc))
+		{
+			/* same key again without rehashing it */
+			for(unsigned int k = 0; k < 2; k++)
+			{
+				kripto_mac_reset(s);
+
+				for(unsigned int r = 0; r < vectors[i].message_repeat; r++)
+				{
+					kripto_mac_input(s, vectors[i].message, vectors[i].message_len);
+				}
+
+				kripto_mac_tag(s, t, vectors[i].tag_len);
+				test_cmp(t, vectors[i].tag, vectors[i].tag_len, file, line, "Reset vector %u", i);
+			}
+		}
+
 		kripto_mac_destroy(s);
 
+		/* context in caller memory, misaligned on purpose */
+		size_t size = kripto_mac_ctx_size(desc, vectors[i].rounds, vectors[i].key_len, vectors[i].tag_len);
+		if(!size) test_error(file, line, "Context size vector %u", i);
+
+		char *mem = (char *)malloc(size + 1);
+		if(!mem) test_error(file, line, "malloc()");
+
+		if(kripto_mac_init(desc, mem + 1, size / 2, vectors[i].rounds, vectors[i].key, vectors[i].key_len, vectors[i].tag_len))
+			test_fail(file, line, "Init too small vector %u", i);
+
+		s = kripto_mac_init
+		(
+			desc, mem + 1, size, vectors[i].rounds,
+			vectors[i].key, vectors[i].key_len,
+			vectors[i].tag_len
+		);
+		if(!s) test_error(file, line, "Init vector %u", i);
+
+		for(unsigned int r = 0; r < vectors[i].message_repeat; r++)
+		{
+			kripto_mac_input(s, vectors[i].message, vectors[i].message_len);
+		}
+
+		kripto_mac_tag(s, t, vectors[i].tag_len);
+		test_cmp(t, vectors[i].tag, vectors[i].tag_len, file, line, "Init vector %u", i);
+
+		kripto_mac_fini(s);
+		free(mem);
+
 		if(vectors[i].message_repeat == 1)
 		{
 			if(kripto_mac_all
@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2026 by Gregor Pintar <grpintar@gmail.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include <kripto/memory.h>
+
+#include "test.h"
+
+int main(void)
+{
+	uint8_t a[100];
+	uint8_t b[100];
+
+	for(unsigned int i = 0; i < 100; i++) a[i] = (uint8_t)(i * 7 + 1);
+
+	/* every length, a difference at every position */
+	for(unsigned int len = 0; len <= 99; len++)
+	{
+		memcpy(b, a, 100);
+
+		if(!kripto_memory_equals(a + 1, b + 1, len))
+			TEST_FAIL("equals %u", len);
+
+		for(unsigned int i = 0; i < len; i++)
+		{
+			b[i + 1] ^= 0x80;
+			if(kripto_memory_equals(a + 1, b + 1, len))
+				TEST_FAIL("equals %u differ at %u", len, i);
+			b[i + 1] ^= 0x80;
+		}
+	}
+
+	/* outside of the range does not count */
+	b[0] ^= 1;
+	b[99] ^= 1;
+	if(kripto_memory_equals(a + 1, b + 1, 98)) TEST_PASS("equals range");
+	else TEST_FAIL("equals range");
+
+	memset(b, 0, 100);
+	kripto_memory_wipe(a + 3, 90);
+	if(!memcmp(a + 3, b, 90) && a[2] && a[93]) TEST_PASS("wipe");
+	else TEST_FAIL("wipe");
+
+	return test_result;
+}
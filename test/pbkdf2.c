@@ -15,46 +15,159 @@
 
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
+#include <kripto/cpu.h>
 #include <kripto/mac.h>
 #include <kripto/hash.h>
 #include <kripto/mac/hmac.h>
+#include <kripto/hash/md5.h>
 #include <kripto/hash/sha1.h>
+#include <kripto/hash/sha2_256.h>
+#include <kripto/hash/sha2_512.h>
 #include <kripto/pbkdf2.h>
 
 #include "test.h"
 
+struct vector
+{
+	const kripto_desc_hash *const *hash;
+	const char *pass;
+	const char *salt;
+	unsigned int iter;
+	unsigned int out_len;
+	const char *out;
+};
+
 int main(void)
 {
-	/* https://www.rfc-editor.org/rfc/rfc6070.txt */
-	const uint8_t out[20] =
+	/* RFC 6070, RFC 7914 and others, some spanning several output blocks or shorter than one */
+	const struct vector vectors[9] =
 	{
-		0x4B, 0x00, 0x79, 0x01,
-		0xB7, 0x65, 0x48, 0x9A,
-		0xBE, 0xAD, 0x49, 0xD9,
-		0x26, 0xF7, 0x21, 0xD0,
-		0x65, 0xA4, 0x29, 0xC1
+		{
+			.hash = &kripto_hash_sha1,
+			.pass = "password",
+			.salt = "salt",
+			.iter = 4096,
+			.out_len = 20,
+			.out = "\x4B\x00\x79\x01\xB7\x65\x48\x9A\xBE\xAD\x49\xD9\x26\xF7\x21\xD0\x65\xA4\x29\xC1"
+		},
+		{
+			.hash = &kripto_hash_sha2_256,
+			.pass = "password",
+			.salt = "salt",
+			.iter = 1000,
+			.out_len = 20,
+			.out = "\x63\x2C\x28\x12\xE4\x6D\x46\x04\x10\x2B\xA7\x61\x8E\x9D\x6D\x7D\x2F\x81\x28\xF6"
+		},
+		{
+			.hash = &kripto_hash_sha1,
+			.pass = "password",
+			.salt = "salt",
+			.iter = 2,
+			.out_len = 20,
+			.out = "\xEA\x6C\x01\x4D\xC7\x2D\x6F\x8C\xCD\x1E\xD9\x2A\xCE\x1D\x41\xF0\xD8\xDE\x89\x57"
+		},
+		{
+			.hash = &kripto_hash_sha1,
+			.pass = "passwordPASSWORDpassword",
+			.salt = "saltSALTsaltSALTsaltSALTsaltSALTsalt",
+			.iter = 4096,
+			.out_len = 25,
+			.out = "\x3D\x2E\xEC\x4F\xE4\x1C\x84\x9B\x80\xC8\xD8\x36\x62\xC0\xE4\x4A\x8B\x29\x1A\x96\x4C\xF2\xF0\x70\x38"
+		},
+		{
+			.hash = &kripto_hash_sha2_256,
+			.pass = "passwd",
+			.salt = "salt",
+			.iter = 1,
+			.out_len = 64,
+			.out = "\x55\xAC\x04\x6E\x56\xE3\x08\x9F\xEC\x16\x91\xC2\x25\x44\xB6\x05\xF9\x41\x85\x21\x6D\xDE\x04\x65\xE6\x8B\x9D\x57\xC2\x0D\xAC\xBC\x49\xCA\x9C\xCC\xF1\x79\xB6\x45\x99\x16\x64\xB3\x9D\x77\xEF\x31\x7C\x71\xB8\x45\xB1\xE3\x0B\xD5\x09\x11\x20\x41\xD3\xA1\x97\x83"
+		},
+		{
+			.hash = &kripto_hash_sha2_256,
+			.pass = "Password",
+			.salt = "NaCl",
+			.iter = 80000,
+			.out_len = 64,
+			.out = "\x4D\xDC\xD8\xF6\x0B\x98\xBE\x21\x83\x0C\xEE\x5E\xF2\x27\x01\xF9\x64\x1A\x44\x18\xD0\x4C\x04\x14\xAE\xFF\x08\x87\x6B\x34\xAB\x56\xA1\xD4\x25\xA1\x22\x58\x33\x54\x9A\xDB\x84\x1B\x51\xC9\xB3\x17\x6A\x27\x2B\xDE\xBB\xA1\xD0\x78\x47\x8F\x62\xB3\x97\xF3\x3C\x8D"
+		},
+		{
+			.hash = &kripto_hash_sha2_512,
+			.pass = "password",
+			.salt = "salt",
+			.iter = 2,
+			.out_len = 64,
+			.out = "\xE1\xD9\xC1\x6A\xA6\x81\x70\x8A\x45\xF5\xC7\xC4\xE2\x15\xCE\xB6\x6E\x01\x1A\x2E\x9F\x00\x40\x71\x3F\x18\xAE\xFD\xB8\x66\xD5\x3C\xF7\x6C\xAB\x28\x68\xA3\x9B\x9F\x78\x40\xED\xCE\x4F\xEF\x5A\x82\xBE\x67\x33\x5C\x77\xA6\x06\x8E\x04\x11\x27\x54\xF2\x7C\xCF\x4E"
+		},
+		{
+			.hash = &kripto_hash_sha2_512,
+			.pass = "password",
+			.salt = "salt",
+			.iter = 1000,
+			.out_len = 200,
+			.out = "\xAF\xE6\xC5\x53\x07\x85\xB6\xCC\x6B\x1C\x64\x53\x38\x47\x31\xBD\x5E\xE4\x32\xEE\x54\x9F\xD4\x2F\xB6\x69\x57\x79\xAD\x8A\x1C\x5B\xF5\x9D\xE6\x9C\x48\xF7\x74\xEF\xC4\x00\x7D\x52\x98\xF9\x03\x3C\x02\x41\xD5\xAB\x69\x30\x5E\x7B\x64\xEC\xEE\xB8\xD8\x34\xCF\xEC\x6A\xFD\xEC\x3C\x1C\x23\x98\x2A\x12\x1F\x2D\x4B\xE0\x08\x88\x93\x78\xA4\x9A\x0D\xFB\x10\x4F\x0D\x28\x56\xE3\x8F\x44\x27\x1C\xDA\xF6\xDE\x43\x41\x96\x64\x7B\xC5\x67\x3C\xD6\xC1\x48\x61\x1C\xED\x6E\x90\x03\xB6\x58\x79\xFE\xCC\xC8\x92\x26\xEC\xC5\xE2\x20\x90\x79\x54\x45\xCC\x73\x14\xFC\xF4\x14\x87\x8A\x42\xFF\xD3\x9C\xD3\xB9\x0D\xCD\x41\xE0\x65\xE3\x5B\x1E\xF7\x5F\xEE\xA6\x06\xC4\x39\xB6\x4B\xE6\x22\xF7\x90\xE1\xC4\x9C\x3D\x91\x47\xD3\x07\x92\x8E\xD5\xB1\xAB\x2C\x84\xCB\x34\xD2\x06\x6A\x89\x47\xA3\x25\xBC\xBA\x42\xD3\xF4\x11\xFD\xBE\x3D\x23"
+		},
+		{
+			.hash = &kripto_hash_md5,
+			.pass = "password",
+			.salt = "salt",
+			.iter = 1000,
+			.out_len = 40,
+			.out = "\x8D\x18\x99\x46\xA3\x2D\x88\x36\x22\xA1\x6A\xE1\x8A\xF0\x63\x2F\x57\x91\xD5\xE7\xB1\xAB\xB0\xAB\x17\x57\xD2\x8C\xE3\x40\x56\x14\x03\x35\x10\x59\x94\x49\x5F\x91"
+		}
 	};
-	uint8_t buf[20];
-
-	kripto_desc_mac *mac = kripto_mac_hmac(kripto_hash_sha1);
-
-	if(kripto_pbkdf2
-	(
-		mac,
-		0,
-		4096,
-		"password",
-		8,
-		"salt",
-		4,
-		buf,
-		20
-	)) TEST_ERROR("kripto_pbkdf2() returned error");
-
-	free(mac);
-
-	TEST_CMP(buf, out, 20, "PBKDF2");
+	uint8_t buf[200];
+
+	/* with and without SHA-NI */
+	for(unsigned int cpu = 0; cpu < 2; cpu++)
+	{
+		if(cpu) kripto_cpu_set(0);
+
+		for(unsigned int i = 0; i < 9; i++)
+		{
+			kripto_desc_mac *mac = kripto_mac_hmac(*vectors[i].hash);
+
+			if(kripto_pbkdf2
+			(
+				mac,
+				0,
+				vectors[i].iter,
+				vectors[i].pass,
+				strlen(vectors[i].pass),
+				vectors[i].salt,
+				strlen(vectors[i].salt),
+				buf,
+				vectors[i].out_len
+			)) TEST_ERROR("kripto_pbkdf2() returned error");
+
+			TEST_CMP(buf, vectors[i].out, vectors[i].out_len, "PBKDF2 vector %u", i);
+
+			/* one thread, and fewer threads than output blocks */
+			for(unsigned int t = 1; t < 4; t += 2)
+			{
+				memset(buf, 0, vectors[i].out_len);
+
+				if(kripto_pbkdf2_threads
+				(
+					mac,
+					0,
+					vectors[i].iter,
+					t,
+					vectors[i].pass,
+					strlen(vectors[i].pass),
+					vectors[i].salt,
+					strlen(vectors[i].salt),
+					buf,
+					vectors[i].out_len
+				)) TEST_ERROR("kripto_pbkdf2_threads() returned error");
+
+				TEST_CMP(buf, vectors[i].out, vectors[i].out_len, "PBKDF2 vector %u threads %u", i, t);
+			}
+
+			free(mac);
+		}
+	}
 
 	return test_result;
 }
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2026 by Gregor Pintar <grpintar@gmail.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#if defined(KRIPTO_UNIX) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE
+#endif
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef KRIPTO_UNIX
+#include <unistd.h>
+#include <sys/wait.h>
+#endif
+
+#include <kripto/random.h>
+
+#include "test.h"
+
+/* more than one buffer of output from each side of a fork */
+#define FORK_LEN 4096
+
+int main(void)
+{
+	const size_t len[6] = {1, 12, 1023, 1024, 5000, 100000};
+	const uint8_t zero[16] = {0};
+	uint8_t *buf;
+	uint8_t a[32];
+	uint8_t b[32];
+
+	kripto_random *s = kripto_random_create();
+	if(!s) TEST_ERROR("kripto_random_create() returned error");
+
+	buf = (uint8_t *)malloc(100000);
+	if(!buf) TEST_ERROR("malloc() failed");
+
+	/* across buffer refills and direct output */
+	for(unsigned int i = 0; i < 6; i++)
+	{
+		memset(buf, 0, len[i]);
+
+		if(kripto_random_gen(s, buf, len[i]) != len[i])
+			TEST_FAIL("random %u bytes", (unsigned int)len[i]);
+		else if(len[i] >= 16 && !memcmp(buf + len[i] - 16, zero, 16))
+			TEST_FAIL("random %u bytes filled", (unsigned int)len[i]);
+		else
+			TEST_PASS("random %u bytes", (unsigned int)len[i]);
+	}
+
+	(void)kripto_random_gen(s, a, 32);
+	(void)kripto_random_gen(s, b, 32);
+	if(memcmp(a, b, 32)) TEST_PASS("random repeat");
+	else TEST_FAIL("random repeat");
+
+	#ifdef KRIPTO_UNIX
+	/* child must not share output with the parent, at any offset */
+	{
+		uint8_t *c = buf + FORK_LEN;
+		unsigned int same = 0;
+		ssize_t r;
+		size_t n;
+		int fd[2];
+		pid_t pid;
+
+		if(pipe(fd)) TEST_ERROR("pipe() failed");
+
+		pid = fork();
+		if(pid < 0) TEST_ERROR("fork() failed");
+
+		if(!pid)
+		{
+			(void)kripto_random_gen(s, buf, FORK_LEN);
+			_exit(write(fd[1], buf, FORK_LEN) != FORK_LEN);
+		}
+
+		(void)kripto_random_gen(s, buf, FORK_LEN);
+
+		for(n = 0; n < FORK_LEN; n += (size_t)r)
+		{
+			r = read(fd[0], c + n, FORK_LEN - n);
+			if(r <= 0) TEST_ERROR("read() failed");
+		}
+		(void)waitpid(pid, 0, 0);
+
+		for(size_t i = 0; i + 16 <= FORK_LEN; i += 16)
+		{
+			for(size_t j = 0; j + 16 <= FORK_LEN; j++)
+				if(!memcmp(c + i, buf + j, 16)) same++;
+		}
+
+		if(same) TEST_FAIL("random fork");
+		else TEST_PASS("random fork");
+
+		(void)close(fd[0]);
+		(void)close(fd[1]);
+	}
+	#endif
+
+	free(buf);
+	kripto_random_destroy(s);
+
+	return test_result;
+}
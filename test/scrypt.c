@@ -16,6 +16,7 @@
 #include <stdlib.h>
 #include <stdint.h>
 
+#include <kripto/cpu.h>
 #include <kripto/mac.h>
 #include <kripto/hash.h>
 #include <kripto/mac/hmac.h>
@@ -38,6 +39,25 @@ int main(void)
 		0x37, 0x30, 0x40, 0x49, 0xE8, 0xA9, 0x52, 0xFB,
 		0xCB, 0xF4, 0x5C, 0x6F, 0xA7, 0x7A, 0x41, 0xA4
 	};
+	const uint8_t out2[64] =
+	{
+		0xFD, 0xBA, 0xBE, 0x1C, 0x9D, 0x34, 0x72, 0x00,
+		0x78, 0x56, 0xE7, 0x19, 0x0D, 0x01, 0xE9, 0xFE,
+		0x7C, 0x6A, 0xD7, 0xCB, 0xC8, 0x23, 0x78, 0x30,
+		0xE7, 0x73, 0x76, 0x63, 0x4B, 0x37, 0x31, 0x62,
+		0x2E, 0xAF, 0x30, 0xD9, 0x2E, 0x22, 0xA3, 0x88,
+		0x6F, 0xF1, 0x09, 0x27, 0x9D, 0x98, 0x30, 0xDA,
+		0xC7, 0x27, 0xAF, 0xB9, 0x4A, 0x83, 0xEE, 0x6D,
+		0x83, 0x60, 0xCB, 0xDF, 0xA2, 0xCC, 0x06, 0x40
+	};
+	const unsigned int threads[4] = {1, 3, 16, 0};
+	const unsigned int cpu[4] =
+	{
+		kripto_cpu(),
+		KRIPTO_CPU_SSE2,
+		KRIPTO_CPU_SSE2 | KRIPTO_CPU_AVX2,
+		0
+	};
 	uint8_t buf[64];
 
 	kripto_desc_mac *mac = kripto_mac_hmac(kripto_hash_sha2_256);
@@ -57,9 +77,95 @@ int main(void)
 		64
 	)) TEST_ERROR("kripto_scrypt() returned error");
 
-	free(mac);
-
 	TEST_CMP(buf, out, 64, "scrypt");
 
+	/* p = 16 lanes split over threads */
+	for(unsigned int i = 0; i < 4; i++)
+	{
+		if(kripto_scrypt_threads
+		(
+			mac,
+			0,
+			1024,
+			8,
+			16,
+			threads[i],
+			"password",
+			8,
+			"NaCl",
+			4,
+			buf,
+			64
+		)) TEST_ERROR("kripto_scrypt_threads() returned error");
+
+		TEST_CMP(buf, out2, 64, "scrypt %u threads", threads[i]);
+	}
+
+	/* every Salsa20/8 kernel */
+	for(unsigned int i = 0; i < 4; i++)
+	{
+		kripto_cpu_set(cpu[i]);
+
+		if(kripto_scrypt
+		(
+			mac,
+			0,
+			1024,
+			8,
+			16,
+			"password",
+			8,
+			"NaCl",
+			4,
+			buf,
+			64
+		)) TEST_ERROR("kripto_scrypt() returned error");
+
+		TEST_CMP(buf, out2, 64, "scrypt cpu %X", cpu[i]);
+	}
+
+	if(kripto_scrypt_memory(1024, 8, 16, 3) == 1024 * 16 + 3 * 1024 * 1026)
+		TEST_PASS("scrypt memory");
+	else
+		TEST_FAIL("scrypt memory");
+
+	/* reused scratch */
+	for(unsigned int f = 0; f < 2; f++)
+	{
+		kripto_scrypt_ctx *ctx = kripto_scrypt_ctx_create
+		(
+			1024, 8, 16, 0,
+			f ? KRIPTO_SCRYPT_HUGEPAGES : 0
+		);
+		if(!ctx) TEST_ERROR("kripto_scrypt_ctx_create() returned error");
+
+		if(kripto_scrypt_ctx_memory(ctx) >= kripto_scrypt_memory(1024, 8, 16, 0))
+			TEST_PASS("scrypt ctx memory");
+		else
+			TEST_FAIL("scrypt ctx memory");
+
+		for(unsigned int i = 0; i < 2; i++)
+		{
+			if(kripto_scrypt_ctx_run
+			(
+				ctx,
+				mac,
+				0,
+				"password",
+				8,
+				"NaCl",
+				4,
+				buf,
+				64
+			)) TEST_ERROR("kripto_scrypt_ctx_run() returned error");
+
+			TEST_CMP(buf, out2, 64, "scrypt ctx flags %u run %u", f, i);
+		}
+
+		kripto_scrypt_ctx_destroy(ctx);
+	}
+
+	free(mac);
+
 	return test_result;
 }
@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2026 by Gregor Pintar <grpintar@gmail.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <stdint.h>
+
+#include <kripto/block.h>
+#include <kripto/block/aes.h>
+#include <kripto/stream.h>
+#include <kripto/stream/cbc.h>
+
+#include "test.h"
+
+int main(void)
+{
+	/* https://nvlpubs.nist.gov/nistpubs/Legacy/SP/nistspecialpublication800-38a.pdf */
+	const struct vector aes_vectors[2] =
+	{
+		{
+			.rounds = 0,
+			.key = "\x2B\x7E\x15\x16\x28\xAE\xD2\xA6\xAB\xF7\x15\x88\x09\xCF\x4F\x3C",
+			.key_len = 16,
+			.iv = "\x00\x01\x02\x03\x04\x05\x06\x07\x08\x09\x0A\x0B\x0C\x0D\x0E\x0F",
+			.iv_len = 16,
+			.pt = "\x6B\xC1\xBE\xE2\x2E\x40\x9F\x96\xE9\x3D\x7E\x11\x73\x93\x17\x2A",
+			.pt_len = 16,
+			.ct = "\x76\x49\xAB\xAC\x81\x19\xB2\x46\xCE\xE9\x8E\x9B\x12\xE9\x19\x7D",
+			.ct_len = 16
+		},
+		{
+			.rounds = 0,
+			.key = "\x2B\x7E\x15\x16\x28\xAE\xD2\xA6\xAB\xF7\x15\x88\x09\xCF\x4F\x3C",
+			.key_len = 16,
+			.iv = "\x00\x01\x02\x03\x04\x05\x06\x07\x08\x09\x0A\x0B\x0C\x0D\x0E\x0F",
+			.iv_len = 16,
+			.pt = "\x6B\xC1\xBE\xE2\x2E\x40\x9F\x96\xE9\x3D\x7E\x11\x73\x93\x17\x2A\xAE\x2D\x8A\x57\x1E\x03\xAC\x9C\x9E\xB7\x6F\xAC\x45\xAF\x8E\x51\x30\xC8\x1C\x46\xA3\x5C\xE4\x11\xE5\xFB\xC1\x19\x1A\x0A\x52\xEF\xF6\x9F\x24\x45\xDF\x4F\x9B\x17\xAD\x2B\x41\x7B\xE6\x6C\x37\x10",
+			.pt_len = 64,
+			.ct = "\x76\x49\xAB\xAC\x81\x19\xB2\x46\xCE\xE9\x8E\x9B\x12\xE9\x19\x7D\x50\x86\xCB\x9B\x50\x72\x19\xEE\x95\xDB\x11\x3A\x91\x76\x78\xB2\x73\xBE\xD6\xB8\xE3\xC1\x74\x3B\x71\x16\xE6\x9E\x22\x22\x95\x16\x3F\xF1\xCA\xA1\x68\x1F\xAC\x09\x12\x0E\xCA\x30\x75\x86\xE1\xA7",
+			.ct_len = 64
+		}
+	};
+
+	kripto_desc_stream *cbc_aes = kripto_stream_cbc(kripto_block_aes);
+	TEST(cbc_aes, aes_vectors, 2);
+
+	/* in-place and out-of-place decryption in uneven chunks */
+	uint8_t pt[1024];
+	uint8_t ct[1024];
+	uint8_t t[1024];
+	unsigned int i;
+	unsigned int n;
+
+	for(i = 0; i < sizeof(pt); i++) pt[i] = i * 7;
+
+	kripto_stream *s = kripto_stream_create(cbc_aes, 0, aes_vectors[0].key, 16, aes_vectors[0].iv, 16);
+	if(!s) TEST_ERROR("Create");
+
+	kripto_stream_encrypt(s, pt, ct, sizeof(pt));
+
+	for(n = 16; n <= 512; n += 80)
+	{
+		s = kripto_stream_recreate(s, 0, aes_vectors[0].key, 16, aes_vectors[0].iv, 16);
+		if(!s) TEST_ERROR("Recreate");
+
+		memcpy(t, ct, sizeof(ct));
+		for(i = 0; i < sizeof(t); i += n)
+			kripto_stream_decrypt(s, t + i, t + i, sizeof(t) - i < n ? sizeof(t) - i : n);
+		TEST_CMP(t, pt, sizeof(pt), "In-place decrypt chunk %u", n);
+
+		s = kripto_stream_recreate(s, 0, aes_vectors[0].key, 16, aes_vectors[0].iv, 16);
+		if(!s) TEST_ERROR("Recreate");
+
+		for(i = 0; i < sizeof(t); i += n)
+			kripto_stream_decrypt(s, ct + i, t + i, sizeof(t) - i < n ? sizeof(t) - i : n);
+		TEST_CMP(t, pt, sizeof(pt), "Decrypt chunk %u", n);
+	}
+
+	/* overlapping buffers, plaintext behind and ahead of ciphertext */
+	uint8_t o[1024 + 96];
+	const int shift[4] = {-16, -40, 8, 48};
+	unsigned int j;
+
+	for(j = 0; j < 4; j++)
+	{
+		uint8_t *oct = o + 48;
+		uint8_t *opt = oct + shift[j];
+
+		s = kripto_stream_recreate(s, 0, aes_vectors[0].key, 16, aes_vectors[0].iv, 16);
+		if(!s) TEST_ERROR("Recreate");
+
+		memcpy(oct, ct, sizeof(ct));
+		kripto_stream_decrypt(s, oct, opt, sizeof(ct));
+		TEST_CMP(opt, pt, sizeof(pt), "Overlapping decrypt shift %d", shift[j]);
+	}
+
+	kripto_stream_destroy(s);
+
+	/* independent streams advanced together */
+	kripto_stream *ms[20];
+	const void *mpt[20];
+	void *mct[20];
+	size_t mlen[20];
+	uint8_t key[32];
+	uint8_t mt[20][256];
+
+	for(i = 0; i < 20; i++)
+	{
+		memset(key, i, sizeof(key));
+		ms[i] = kripto_stream_create(cbc_aes, 0, key, i < 10 ? 16 : 32, aes_vectors[0].iv, 16);
+		if(!ms[i]) TEST_ERROR("Create %u", i);
+
+		mpt[i] = pt + i * 16;
+		mct[i] = mt[i];
+		mlen[i] = (i * 48) % 272;
+	}
+
+	kripto_stream_cbc_encrypt_multi(ms, mpt, mct, mlen, 20);
+	kripto_stream_cbc_encrypt_multi(ms, mpt, mct, mlen, 20);
+
+	for(i = 0; i < 20; i++)
+	{
+		memset(key, i, sizeof(key));
+		s = kripto_stream_create(cbc_aes, 0, key, i < 10 ? 16 : 32, aes_vectors[0].iv, 16);
+		if(!s) TEST_ERROR("Create");
+
+		kripto_stream_encrypt(s, mpt[i], t, mlen[i]);
+		kripto_stream_encrypt(s, mpt[i], t, mlen[i]);
+		TEST_CMP(mt[i], t, mlen[i], "Encrypt multi stream %u", i);
+
+		kripto_stream_destroy(s);
+		kripto_stream_destroy(ms[i]);
+	}
+
+	free(cbc_aes);
+
+	return test_result;
+}
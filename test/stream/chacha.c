@@ -13,6 +13,7 @@
  * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
  */
 
+#include <kripto/cpu.h>
 #include <kripto/stream.h>
 #include <kripto/stream/chacha.h>
 
@@ -96,5 +97,70 @@ int main(void)
 		}
 	};
 
-	return TEST(kripto_stream_chacha, vectors, 6);
+	TEST(kripto_stream_chacha, vectors, 6);
+	TEST_SEEK(kripto_stream_chacha, vectors);
+	TEST_SEEK(kripto_stream_chacha, vectors + 5);
+
+	/* every backend and chunking gives the same keystream */
+	const unsigned int features[4] =
+	{
+		0,
+		KRIPTO_CPU_SSE2,
+		KRIPTO_CPU_SSE2 | KRIPTO_CPU_AVX2,
+		KRIPTO_CPU_SSE2 | KRIPTO_CPU_AVX2 | KRIPTO_CPU_AVX512
+	};
+	char ks[4][3000];
+	char ct[4][3000];
+	char pt[3000];
+
+	for(unsigned int i = 0; i < 3000; i++) pt[i] = (char)(i * 7 + 1);
+
+	for(unsigned int f = 0; f < 4; f++)
+	{
+		kripto_cpu_set(features[f]);
+
+		kripto_stream *s = kripto_stream_create
+		(
+			kripto_stream_chacha, 12,
+			vectors[0].key, vectors[0].key_len,
+			vectors[0].iv, vectors[0].iv_len
+		);
+		if(!s) TEST_ERROR("Create");
+
+		for(unsigned int i = 0, n = 1; i < 3000; i += n, n = n * 13 % 1201 + 1)
+		{
+			if(n > 3000 - i) n = 3000 - i;
+			kripto_stream_prng(s, ks[f] + i, n);
+		}
+
+		s = kripto_stream_recreate
+		(
+			s, 12,
+			vectors[0].key, vectors[0].key_len,
+			vectors[0].iv, vectors[0].iv_len
+		);
+		if(!s) TEST_ERROR("Recreate");
+
+		for(unsigned int i = 0, n = 1; i < 3000; i += n, n = n * 17 % 1301 + 1)
+		{
+			if(n > 3000 - i) n = 3000 - i;
+			kripto_stream_encrypt(s, pt + i, ct[f] + i, n);
+		}
+
+		kripto_stream_destroy(s);
+
+		if(f)
+		{
+			TEST_CMP(ks[f], ks[0], 3000, "Backend %u prng", f);
+			TEST_CMP(ct[f], ct[0], 3000, "Backend %u encrypt", f);
+		}
+	}
+
+	/* encrypt is plaintext XOR the prng keystream */
+	for(unsigned int i = 0; i < 3000; i++) pt[i] ^= ks[0][i];
+	TEST_CMP(ct[0], pt, 3000, "Encrypt keystream");
+
+	kripto_cpu_set(kripto_cpu_detect());
+
+	return test_result;
 }
@@ -13,6 +13,8 @@
  * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
  */
 
+#include <stdint.h>
+
 #include <kripto/block.h>
 #include <kripto/block/aes.h>
 #include <kripto/stream.h>
@@ -51,6 +53,43 @@ int main(void)
 
 	kripto_desc_stream *ctr_aes = kripto_stream_ctr(kripto_block_aes);
 	TEST(ctr_aes, aes_vectors, 2);
+	TEST_SEEK(ctr_aes, aes_vectors);
+
+	/* counter carry and partial blocks across calls */
+	uint8_t ctr[16];
+	uint8_t ks[1024];
+	uint8_t t[1024];
+	unsigned int i;
+	unsigned int n;
+
+	memset(ctr, 0, 10);
+	memset(ctr + 10, 0xFF, 6);
+
+	kripto_block *block = kripto_block_create(kripto_block_aes, 0, aes_vectors[0].key, 16);
+	if(!block) TEST_ERROR("Create block");
+
+	for(i = 0; i < sizeof(ks); i += 16)
+	{
+		kripto_block_encrypt(block, ctr, ks + i);
+		for(n = 15; n; n--)
+			if(++ctr[n]) break;
+	}
+
+	memset(ctr, 0, 10);
+	memset(ctr + 10, 0xFF, 6);
+
+	kripto_stream *s = kripto_stream_create(ctr_aes, 0, aes_vectors[0].key, 16, ctr, 16);
+	if(!s) TEST_ERROR("Create stream");
+
+	for(i = 0, n = 1; i < sizeof(t); i += n, n = n * 7 % 61 + 1)
+	{
+		if(n > sizeof(t) - i) n = sizeof(t) - i;
+		kripto_stream_prng(s, t + i, n);
+	}
+	TEST_CMP(t, ks, sizeof(t), "Chunked keystream");
+
+	kripto_stream_destroy(s);
+	kripto_block_destroy(block);
 	free(ctr_aes);
 
 	return test_result;
@@ -0,0 +1,41 @@
+/*
+ * Copyright (C) 2026 by Gregor Pintar <grpintar@gmail.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <kripto/stream.h>
+#include <kripto/stream/skein1024.h>
+
+#include "test.h"
+
+int main(void)
+{
+	/* Skein-1024 KEY, CFG (output 2^64-1 bits), NONCE, then OUTPUT blocks */
+	const struct vector vectors[1] =
+	{
+		{
+			.rounds = 0,
+			.key = "\x01\x08\x0F\x16\x1D\x24\x2B\x32\x39\x40\x47\x4E\x55\x5C\x63\x6A\x71\x78\x7F\x86\x8D\x94\x9B\xA2\xA9\xB0\xB7\xBE\xC5\xCC\xD3\xDA\xE1\xE8\xEF\xF6\xFD\x04\x0B\x12\x19\x20\x27\x2E\x35\x3C\x43\x4A\x51\x58\x5F\x66\x6D\x74\x7B\x82\x89\x90\x97\x9E\xA5\xAC\xB3\xBA\xC1\xC8\xCF\xD6\xDD\xE4\xEB\xF2\xF9\x00\x07\x0E\x15\x1C\x23\x2A\x31\x38\x3F\x46\x4D\x54\x5B\x62\x69\x70\x77\x7E\x85\x8C\x93\x9A\xA1\xA8\xAF\xB6\xBD\xC4\xCB\xD2\xD9\xE0\xE7\xEE\xF5\xFC\x03\x0A\x11\x18\x1F\x26\x2D\x34\x3B\x42\x49\x50\x57\x5E\x65\x6C\x73\x7A",
+			.key_len = 128,
+			.iv = "\x05\x12\x1F\x2C\x39\x46\x53\x60\x6D\x7A\x87\x94\xA1\xAE\xBB\xC8\xD5\xE2\xEF\xFC\x09\x16\x23\x30\x3D\x4A\x57\x64\x71\x7E\x8B\x98\xA5\xB2\xBF\xCC\xD9\xE6\xF3\x00\x0D\x1A\x27\x34\x41\x4E\x5B\x68\x75\x82\x8F\x9C\xA9\xB6\xC3\xD0\xDD\xEA\xF7\x04\x11\x1E\x2B\x38\x45\x52\x5F\x6C\x79\x86\x93\xA0\xAD\xBA\xC7\xD4\xE1\xEE\xFB\x08\x15\x22\x2F\x3C\x49\x56\x63\x70\x7D\x8A\x97\xA4\xB1\xBE\xCB\xD8\xE5\xF2\xFF\x0C\x19\x26\x33\x40\x4D\x5A\x67\x74\x81\x8E\x9B\xA8\xB5\xC2\xCF\xDC\xE9\xF6\x03\x10\x1D\x2A\x37\x44\x51\x5E\x6B\x78",
+			.iv_len = 128,
+			.pt = "\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00",
+			.pt_len = 300,
+			.ct = "\xF2\xD8\xE6\x7A\x7F\x23\x87\x0F\xF5\x40\x54\xA1\x3F\x82\xFF\x2F\x69\x7F\xFA\x9A\xB6\x82\x04\xE5\x60\x65\xD0\xC4\x9D\xC1\x9D\x59\xAA\x1C\xCA\x4E\xB3\x73\x77\x96\x64\x5F\xBD\x70\x7F\xC8\x0F\xF5\x4F\x6E\xAB\x71\x96\x86\x50\x43\xC0\x15\xB2\xFF\xB8\x1A\x50\x73\x45\x89\x3A\x81\xE5\xE1\xEC\x78\x52\x51\x69\x2F\x63\xF0\x83\x79\x84\xA0\x10\xEA\x58\x4E\xB0\x20\x8C\x21\x86\x5F\x8B\xF0\x29\xF6\x60\xEC\xB5\xAD\xA6\x11\x8F\xD1\xD3\xF1\xAD\x69\x4C\xDA\x71\xE9\xC6\xBB\x7B\x51\x2E\xC7\xD1\xC6\x81\x44\xA1\xFF\x7A\xE8\x70\x59\xCE\x05\x54\x5A\x29\x56\xD9\xB7\xE1\xF7\x0A\x36\xDB\x27\xB8\x4B\x6F\xF5\xCF\xDC\xC6\xFE\xA0\x0F\x09\x97\x74\x20\x7E\x1E\xD5\x5C\x71\x27\x2B\x10\x41\x74\x97\x4D\x06\x38\x44\x8C\x90\x69\x81\x6C\x59\xFF\x4A\x2E\xF6\x15\x5B\xAA\xA8\x13\x76\xF2\x81\xED\xC1\xEF\x51\x66\x49\x3A\x18\x01\x78\x48\xA5\x5D\x1B\x5A\xE9\x3A\x3A\x53\x55\x2C\xEC\x09\xB5\x10\x43\xF9\x38\x6B\x6E\x33\xB4\xEA\x0D\x8C\x83\x1A\x09\x0C\xCC\xF6\x3C\xB3\x5A\x7E\xBF\xBB\x14\xB5\x45\x2E\x2E\xA6\xE9\x3F\xBA\xAA\xF7\x12\x7A\x8D\x38\x6F\x57\xE4\xCD\xED\xA8\x3F\xCD\xDC\x8A\x85\xC1\xBA\x1E\x35\x15\x73\xA9\x52\x78\x2A\x43\xFB\x43\x7C\xB3\x28\x1F\xE1\x7E\x4F\x94\x0C\x79\x00\x84\x5B\x67\x01\xE8\x6E\xEB\x20\x21\x9F\x5F\xA0\xAD\x16",
+			.ct_len = 300
+		}
+	};
+
+	TEST(kripto_stream_skein1024, vectors, 1);
+	return TEST_SEEK(kripto_stream_skein1024, vectors);
+}
@@ -0,0 +1,41 @@
+/*
+ * Copyright (C) 2026 by Gregor Pintar <grpintar@gmail.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <kripto/stream.h>
+#include <kripto/stream/skein256.h>
+
+#include "test.h"
+
+int main(void)
+{
+	/* Skein-256 KEY, CFG (output 2^64-1 bits), NONCE, then OUTPUT blocks */
+	const struct vector vectors[1] =
+	{
+		{
+			.rounds = 0,
+			.key = "\x01\x08\x0F\x16\x1D\x24\x2B\x32\x39\x40\x47\x4E\x55\x5C\x63\x6A\x71\x78\x7F\x86\x8D\x94\x9B\xA2\xA9\xB0\xB7\xBE\xC5\xCC\xD3\xDA",
+			.key_len = 32,
+			.iv = "\x05\x12\x1F\x2C\x39\x46\x53\x60\x6D\x7A\x87\x94\xA1\xAE\xBB\xC8\xD5\xE2\xEF\xFC\x09\x16\x23\x30\x3D\x4A\x57\x64\x71\x7E\x8B\x98",
+			.iv_len = 32,
+			.pt = "\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00",
+			.pt_len = 100,
+			.ct = "\x21\x39\xB6\xCC\x0B\x19\xDA\xE2\x9A\xC1\x95\x96\xB9\x90\x5A\x7D\x8E\x06\x9B\xF4\x56\xA9\x9C\x98\x1C\x90\xEB\xAB\xB4\x3D\x20\x33\xE6\x5E\x20\x22\x79\x1F\xB5\x25\x48\xD7\x57\xB5\x85\xEA\x90\xDB\x56\x11\x19\xFC\x80\x4D\x68\xE1\x29\x2A\x6E\xE8\xE1\x85\x50\xDF\xC5\xFB\x96\xAE\x60\xEA\x91\xA1\x8F\xAA\x2F\x52\xBE\x0B\xA9\x6D\x14\xC2\x01\x74\xD0\x5F\xDC\xB0\x5F\x99\x6D\x86\x8D\x44\xEC\x80\xD8\x77\x59\x0B",
+			.ct_len = 100
+		}
+	};
+
+	TEST(kripto_stream_skein256, vectors, 1);
+	return TEST_SEEK(kripto_stream_skein256, vectors);
+}
@@ -0,0 +1,41 @@
+/*
+ * Copyright (C) 2026 by Gregor Pintar <grpintar@gmail.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <kripto/stream.h>
+#include <kripto/stream/skein512.h>
+
+#include "test.h"
+
+int main(void)
+{
+	/* Skein-512 KEY, CFG (output 2^64-1 bits), NONCE, then OUTPUT blocks */
+	const struct vector vectors[1] =
+	{
+		{
+			.rounds = 0,
+			.key = "\x01\x08\x0F\x16\x1D\x24\x2B\x32\x39\x40\x47\x4E\x55\x5C\x63\x6A\x71\x78\x7F\x86\x8D\x94\x9B\xA2\xA9\xB0\xB7\xBE\xC5\xCC\xD3\xDA\xE1\xE8\xEF\xF6\xFD\x04\x0B\x12\x19\x20\x27\x2E\x35\x3C\x43\x4A\x51\x58\x5F\x66\x6D\x74\x7B\x82\x89\x90\x97\x9E\xA5\xAC\xB3\xBA",
+			.key_len = 64,
+			.iv = "\x05\x12\x1F\x2C\x39\x46\x53\x60\x6D\x7A\x87\x94\xA1\xAE\xBB\xC8\xD5\xE2\xEF\xFC\x09\x16\x23\x30\x3D\x4A\x57\x64\x71\x7E\x8B\x98\xA5\xB2\xBF\xCC\xD9\xE6\xF3\x00\x0D\x1A\x27\x34\x41\x4E\x5B\x68\x75\x82\x8F\x9C\xA9\xB6\xC3\xD0\xDD\xEA\xF7\x04\x11\x1E\x2B\x38",
+			.iv_len = 64,
+			.pt = "\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00",
+			.pt_len = 150,
+			.ct = "\x2A\xBF\xB4\xE7\x29\x0D\xF9\x5F\x4A\x6E\x83\x4F\xD5\x46\x6F\xD4\x7E\x11\xF2\xFB\x1C\x5C\x50\x7F\x1A\x91\x0B\x03\x42\x28\x05\x38\xDD\x89\xF5\xD3\xF1\xF8\xE3\x0A\x05\x03\x28\xBE\xC4\x06\xFA\xE5\xDB\xB6\xF6\x73\x9C\x2D\xD9\x03\x0B\xB8\x9B\x35\x21\xC9\x5F\x5D\x83\x9D\x4A\xFA\x3C\x4A\xFA\x28\x8F\x1C\x9E\x82\x7D\xFE\xEC\xFD\x03\xCE\xBA\xFA\xD8\xE2\x40\xAC\x5F\xE2\x31\xB3\xD7\x1B\xE1\x30\x58\x2D\x65\xCB\xA7\x90\x6A\x93\x91\x52\xC5\x93\x6D\xB0\x23\x67\x85\x51\x17\x51\x14\x2A\x26\x84\xEB\xFF\xF3\x6B\x1D\x55\x0F\xB5\xF3\x4F\x24\x0F\x67\xEE\x0E\x20\x64\x15\x32\xC8\xA3\xA1\x2F\x84\x86\xAA\x64\xF9\x98\x45",
+			.ct_len = 150
+		}
+	};
+
+	TEST(kripto_stream_skein512, vectors, 1);
+	return TEST_SEEK(kripto_stream_skein512, vectors);
+}
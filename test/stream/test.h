@@ -41,6 +41,15 @@ int test
 );
 #define TEST(DESC, VECTORS, VECTORS_LEN) test(__FILE__, __LINE__, DESC, VECTORS, VECTORS_LEN)
 
+int test_seek
+(
+	const char *file,
+	unsigned int line,
+	const kripto_desc_stream *desc,
+	const struct vector *vector
+);
+#define TEST_SEEK(DESC, VECTOR) test_seek(__FILE__, __LINE__, DESC, VECTOR)
+
 int test
 (
 	const char *file,
@@ -82,4 +91,43 @@ int test
 	return test_result;
 }
 
+int test_seek
+(
+	const char *file,
+	unsigned int line,
+	const kripto_desc_stream *desc,
+	const struct vector *vector
+)
+{
+	const unsigned int offsets[8] = {0, 1, 63, 64, 65, 200, 511, 999};
+	char ks[1000];
+	char t[1000];
+
+	kripto_stream *s = kripto_stream_create
+	(
+		desc, vector->rounds,
+		vector->key, vector->key_len,
+		vector->iv, vector->iv_len
+	);
+	if(!s) test_error(file, line, "Create");
+
+	if(!kripto_stream_seekable(desc)) test_fail(file, line, "Seekable");
+
+	memset(ks, 0, 1000);
+	kripto_stream_encrypt(s, ks, ks, 1000);
+
+	for(unsigned int i = 0; i < 8; i++)
+	{
+		kripto_stream_seek(s, offsets[i]);
+
+		memset(t, 0, 1000 - offsets[i]);
+		kripto_stream_encrypt(s, t, t, 1000 - offsets[i]);
+		test_cmp(t, ks + offsets[i], 1000 - offsets[i], file, line, "Seek %u", offsets[i]);
+	}
+
+	kripto_stream_destroy(s);
+
+	return test_result;
+}
+
 #endif